@@ -128,10 +128,12 @@ public:
     _Mat.MdagM(in,out,n1,n2);
     out = out + _shift*in;
 
-    ComplexD dot;	
-    dot= innerProduct(in,out);
-    n1=real(dot);
-    n2=norm2(out);
+    const Field *l[2] = { &in , &out };
+    const Field *r[2] = { &out, &out };
+    ComplexD dot[2];	
+    innerProductBatch<2>(dot,l,r);
+    n1=real(dot[0]);
+    n2=real(dot[1]);
   }
   void HermOp(const Field &in, Field &out){
     RealD n1,n2;
@@ -163,8 +165,12 @@ public:
   void HermOpAndNorm(const Field &in, Field &out,RealD &n1,RealD &n2){
     _Mat.M(in,out);
 	
-    ComplexD dot= innerProduct(in,out); n1=real(dot);
-    n2=norm2(out);
+    const Field *l[2] = { &in , &out };
+    const Field *r[2] = { &out, &out };
+    ComplexD dot[2];	
+    innerProductBatch<2>(dot,l,r);
+    n1=real(dot[0]);
+    n2=real(dot[1]);
   }
   void HermOp(const Field &in, Field &out){
     _Mat.M(in,out);
@@ -147,6 +147,124 @@ public:
   };
 };
 
+/////////////////////////////////////////////////////////////////////////////////
+// Chronological guesser for a sequence of solves A x = b with slowly varying A,
+// as the pseudofermion force solves along an MD trajectory: the minimal residual
+// extrapolation of Brower et al. over the last Depth solutions.
+//
+// The guess minimises the A-norm of the error over the span V of the history,
+//
+//   x = V c ,   (V^dag A V) c = V^dag b ,
+//
+// solved in the basis that diagonalises the Gram matrix V^dag V so that nearly
+// parallel history vectors are dropped rather than amplified. Costs Depth
+// applications of A and one batched reduction per guess, which also carries
+// the (AV)^dag AV and (AV)^dag b products for the true residual of the guess.
+//
+// An OperatorScope names the Hermitian operator of the solves made while it is
+// alive, and unsets it on leaving scope; without one the guess is the last
+// solution. Update() records the converged solution. Depth 0 disables the
+// history; the guess is then zero.
+/////////////////////////////////////////////////////////////////////////////////
+template<class Field>
+class ChronoGuesser : public LinearFunction<Field>
+{
+private:
+  size_t depth;
+  std::deque<Field> history;   // oldest first
+  LinearOperatorBase<Field> *Linop;
+
+public:
+  class OperatorScope {
+  public:
+    OperatorScope(ChronoGuesser &_guesser,LinearOperatorBase<Field> &_Linop) : guesser(_guesser)
+    {
+      guesser.Linop = &_Linop;
+    }
+    ~OperatorScope() { guesser.Linop = nullptr; }
+  private:
+    ChronoGuesser &guesser;
+  };
+
+  ChronoGuesser(int _depth=0) : Linop(nullptr) { Depth(_depth); };
+
+  size_t Depth(void) const { return depth; }
+  void   Depth(int _depth)
+  {
+    assert(_depth >= 0);
+    depth = _depth;
+    while ( history.size() > depth ) history.pop_front();
+  }
+  void Reset(void) { history.clear(); }
+
+  void Update(const Field &sol)
+  {
+    if ( depth==0 ) return;
+    if ( history.size()==depth ) history.pop_front();
+    history.push_back(sol);
+  }
+
+  void operator()(const Field &src, Field &guess)
+  {
+    typedef Eigen::MatrixXcd Matrix;
+    typedef Eigen::VectorXcd Vec;
+
+    const int n = history.size();
+    guess.Checkerboard() = src.Checkerboard();
+    if ( n==0 ) { guess = Zero(); return; }
+    if ( Linop==nullptr ) { guess = history.back(); return; }
+
+    GridBase *grid = src.Grid();
+    std::vector<Field> AV(n,grid);
+    std::vector<const Field *> lhs, rhs;
+    for(int j=0;j<n;j++){
+      conformable(history[j].Grid(),grid);
+      Linop->HermOp(history[j],AV[j]);
+      for(int i=0;i<=j;i++) { lhs.push_back(&history[i]); rhs.push_back(&history[j]); }
+      for(int i=0;i<=j;i++) { lhs.push_back(&history[i]); rhs.push_back(&AV[j]); }
+      for(int i=0;i<=j;i++) { lhs.push_back(&AV[i]);      rhs.push_back(&AV[j]); }
+      lhs.push_back(&history[j]); rhs.push_back(&src);
+      lhs.push_back(&AV[j]);      rhs.push_back(&src);
+    }
+    lhs.push_back(&src); rhs.push_back(&src);
+    std::vector<ComplexD> ip(lhs.size());
+    innerProductBatch(&ip[0],lhs,rhs);
+
+    Matrix S(n,n), G(n,n), H(n,n);
+    Vec b(n), e(n);
+    int o=0;
+    for(int j=0;j<n;j++){
+      for(int i=0;i<=j;i++) { S(i,j) = ip[o]; S(j,i) = std::conj(ip[o]); o++; }
+      for(int i=0;i<=j;i++) { G(i,j) = ip[o]; G(j,i) = std::conj(ip[o]); o++; }
+      for(int i=0;i<=j;i++) { H(i,j) = ip[o]; H(j,i) = std::conj(ip[o]); o++; }
+      b(j) = ip[o++];
+      e(j) = ip[o++];
+    }
+    RealD ssq = real(ip[o]);
+
+    // Orthonormal combinations W of the history, dropping the near null space
+    Eigen::SelfAdjointEigenSolver<Matrix> es(S);
+    RealD lmax = es.eigenvalues()(n-1);
+    int k=0;
+    for(int i=0;i<n;i++) if ( es.eigenvalues()(i) > 1.0e-12*lmax ) k++;
+    Matrix W(n,k);
+    for(int i=n-k,c=0;i<n;i++,c++){
+      W.col(c) = es.eigenvectors().col(i) / std::sqrt(es.eigenvalues()(i));
+    }
+    Matrix Gw = W.adjoint()*G*W;
+    Vec    bw = W.adjoint()*b;
+    Vec    c  = W*Gw.ldlt().solve(bw);
+
+    guess = Zero();
+    for(int j=0;j<n;j++) guess = guess + (ComplexD)c(j)*history[j];
+
+    // |b - A V c|^2 = |b|^2 - 2 Re b^dag (AV) c + c^dag (AV)^dag (AV) c
+    RealD rsq = ssq - 2.0*real(e.dot(c)) + real(c.dot(H*c));
+    std::cout << GridLogIterative << "ChronoGuesser: " << k << "/" << n << " vectors, |res|/|src| = "
+	      << std::sqrt(std::max(rsq,0.0)/ssq) << std::endl;
+  }
+};
+
 NAMESPACE_END(Grid);
 
 #endif
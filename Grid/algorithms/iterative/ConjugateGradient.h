@@ -78,9 +78,12 @@ public:
     r = src - mmp;
     p = r;
 
-    a = norm2(p);
+    const Field *l[2] = { &p, &src };
+    ComplexD nrm[2];
+    innerProductBatch<2>(nrm,l,l);
+    a = real(nrm[0]);
     cp = a;
-    ssq = norm2(src);
+    ssq = real(nrm[1]);
 
     std::cout << GridLogIterative << std::setprecision(8) << "ConjugateGradient: guess " << guess << std::endl;
     std::cout << GridLogIterative << std::setprecision(8) << "ConjugateGradient:   src " << ssq << std::endl;
@@ -0,0 +1,266 @@
+/*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./lib/algorithms/iterative/ConjugateGradientPipelined.h
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+*************************************************************************************/
+/*  END LEGAL */
+#ifndef GRID_CONJUGATE_GRADIENT_PIPELINED_H
+#define GRID_CONJUGATE_GRADIENT_PIPELINED_H
+
+NAMESPACE_BEGIN(Grid);
+
+/////////////////////////////////////////////////////////////////////////////////////////
+// Pipelined CG; P. Ghysels and W. Vanroose, Parallel Computing 40 (2014) 224.
+//
+// Carries w = A r, s = A p, z = A s alongside the usual r,p so that the two
+// reductions of an iteration, (r,r) and (w,r), are formed together and summed with one
+// non-blocking allreduce that is overlapped with the next HermOp, q = A w.
+//
+// The extra recurrences drift from the true residual; following the reliable update
+// scheme, once |r|^2 has fallen by Delta since the last replacement the residual and
+// the auxiliary vectors are recomputed from x with explicit matrix multiplies.
+/////////////////////////////////////////////////////////////////////////////////////////
+template <class Field>
+class ConjugateGradientPipelined : public OperatorFunction<Field> {
+public:
+
+  using OperatorFunction<Field>::operator();
+
+  bool ErrorOnNoConverge;  // throw an assert when the CG fails to converge.
+                           // Defaults true.
+  RealD Tolerance;
+  Integer MaxIterations;
+  RealD Delta;             // residual replacement trigger
+  Integer IterationsToComplete; //Number of iterations the CG took to finish. Filled in upon completion
+  Integer ReplacementsPerformed;
+
+  ConjugateGradientPipelined(RealD tol, Integer maxit, RealD delta=0.1, bool err_on_no_conv = true)
+    : Tolerance(tol),
+      MaxIterations(maxit),
+      Delta(delta),
+      ErrorOnNoConverge(err_on_no_conv){};
+
+  void operator()(LinearOperatorBase<Field> &Linop, const Field &src, Field &psi) {
+
+    psi.Checkerboard() = src.Checkerboard();
+
+    conformable(psi, src);
+
+    GridBase *grid = src.Grid();
+
+    typedef typename Field::vector_object vobj;
+    typedef decltype(innerProductD(vobj(),vobj())) inner_t;
+    typedef ReductionArray<inner_t,2> batch_t;
+
+    RealD alpha, beta, gamma, gamma_old, delta, ssq;
+    RealD alpha_old = 1.0;
+
+    Field r(src);
+    Field w(src);
+    Field q(src);
+    Field p(src); p = Zero();
+    Field s(src); s = Zero();
+    Field z(src); z = Zero();
+
+    // Initial residual computation & set up
+    RealD guess = norm2(psi);
+    assert(std::isnan(guess) == 0);
+
+    Linop.HermOp(psi, w);
+    r = src - w;
+    Linop.HermOp(r, w);
+
+    ssq = norm2(src);
+    RealD rsq = Tolerance * Tolerance * ssq;
+
+    std::vector<CommsRequest_t> reqs;
+    ComplexD ip[2];
+    const Field *lhs[2] = { &r, &w };
+    const Field *rhs[2] = { &r, &r };
+
+    GridStopWatch LinalgTimer;
+    GridStopWatch MatrixTimer;
+    GridStopWatch ReduceWaitTimer;
+    GridStopWatch SolverTimer;
+
+    SolverTimer.Start();
+
+    innerProductBatchLocal<2>(ip,lhs,rhs);
+    grid->GlobalSumVectorBegin(reqs,ip,2);
+
+    MatrixTimer.Start();
+    Linop.HermOp(w, q);
+    MatrixTimer.Stop();
+
+    ReduceWaitTimer.Start();
+    grid->GlobalSumVectorComplete(reqs);
+    ReduceWaitTimer.Stop();
+
+    gamma = real(ip[0]);
+    delta = real(ip[1]);
+
+    std::cout << GridLogIterative << std::setprecision(8) << "ConjugateGradientPipelined: guess " << guess << std::endl;
+    std::cout << GridLogIterative << std::setprecision(8) << "ConjugateGradientPipelined:   src " << ssq << std::endl;
+    std::cout << GridLogIterative << std::setprecision(8) << "ConjugateGradientPipelined:     r " << gamma << std::endl;
+
+    // Check if guess is really REALLY good :)
+    if (gamma <= rsq) {
+      std::cout << GridLogMessage << "ConjugateGradientPipelined guess is converged already " << std::endl;
+      IterationsToComplete = 0;
+      ReplacementsPerformed = 0;
+      return;
+    }
+
+    RealD MaxResidSinceLastReplacement = gamma;
+    int l = 0;
+    int k;
+    for (k = 1; k <= MaxIterations; k++) {
+
+      if ( k==1 ) {
+	beta  = 0.0;
+	alpha = gamma / delta;
+      } else {
+	beta  = gamma / gamma_old;
+	alpha = gamma / (delta - beta * gamma / alpha_old);
+      }
+
+      ////////////////////////////////////////////////////////////
+      // All six recurrences and both local reductions in one sweep
+      ////////////////////////////////////////////////////////////
+      LinalgTimer.Start();
+      {
+	auto psi_v = psi.View();
+	auto r_v   = r.View();
+	auto w_v   = w.View();
+	auto q_v   = q.View();
+	auto p_v   = p.View();
+	auto s_v   = s.View();
+	auto z_v   = z.View();
+	batch_t partial[GRID_REDUCE_CHUNKS];
+	reduceSites(partial,grid->oSites(),[&](batch_t &acc,uint64_t ss){
+	  vobj zz = q_v[ss] + beta * z_v[ss];
+	  vobj sv = w_v[ss] + beta * s_v[ss];
+	  vobj pp = r_v[ss] + beta * p_v[ss];
+	  vobj rr = r_v[ss] - alpha* sv;
+	  vobj ww = w_v[ss] - alpha* zz;
+	  psi_v[ss] = psi_v[ss] + alpha * pp;
+	  z_v[ss] = zz;
+	  s_v[ss] = sv;
+	  p_v[ss] = pp;
+	  r_v[ss] = rr;
+	  w_v[ss] = ww;
+	  acc.v[0] = acc.v[0] + innerProductD(rr,rr);
+	  acc.v[1] = acc.v[1] + innerProductD(ww,rr);
+	});
+	ip[0] = TensorRemove(Reduce(partial[0].v[0]));
+	ip[1] = TensorRemove(Reduce(partial[0].v[1]));
+      }
+      LinalgTimer.Stop();
+
+      ////////////////////////////////////////////////////////////
+      // Reduction in flight while the next matrix multiply runs
+      ////////////////////////////////////////////////////////////
+      grid->GlobalSumVectorBegin(reqs,ip,2);
+
+      MatrixTimer.Start();
+      Linop.HermOp(w, q);
+      MatrixTimer.Stop();
+
+      ReduceWaitTimer.Start();
+      grid->GlobalSumVectorComplete(reqs);
+      ReduceWaitTimer.Stop();
+
+      gamma_old = gamma;
+      alpha_old = alpha;
+      gamma = real(ip[0]);
+      delta = real(ip[1]);
+
+      std::cout << GridLogIterative << "ConjugateGradientPipelined: Iteration " << k
+                << " residual " << sqrt(gamma/ssq) << " target " << Tolerance << std::endl;
+
+      // Stopping condition
+      if (gamma <= rsq) {
+        SolverTimer.Stop();
+        Linop.HermOp(psi, q);
+        p = q - src;
+
+        RealD srcnorm = std::sqrt(ssq);
+        RealD resnorm = std::sqrt(norm2(p));
+        RealD true_residual = resnorm / srcnorm;
+
+        std::cout << GridLogMessage << "ConjugateGradientPipelined Converged on iteration " << k
+		  << " after " << l << " residual replacements" << std::endl;
+        std::cout << GridLogMessage << "\tComputed residual " << std::sqrt(gamma / ssq)<<std::endl;
+	std::cout << GridLogMessage << "\tTrue residual " << true_residual<<std::endl;
+	std::cout << GridLogMessage << "\tTarget " << Tolerance << std::endl;
+
+        std::cout << GridLogMessage << "Time breakdown "<<std::endl;
+	std::cout << GridLogMessage << "\tElapsed    " << SolverTimer.Elapsed() <<std::endl;
+	std::cout << GridLogMessage << "\tMatrix     " << MatrixTimer.Elapsed() <<std::endl;
+	std::cout << GridLogMessage << "\tLinalg     " << LinalgTimer.Elapsed() <<std::endl;
+	std::cout << GridLogMessage << "\tReduceWait " << ReduceWaitTimer.Elapsed() <<std::endl;
+
+        if (ErrorOnNoConverge) assert(true_residual / Tolerance < 10000.0);
+
+	IterationsToComplete = k;
+	ReplacementsPerformed = l;
+
+        return;
+      }
+
+      if ( gamma > MaxResidSinceLastReplacement ) MaxResidSinceLastReplacement = gamma;
+
+      ////////////////////////////////////////////////////////////
+      // Residual replacement: rebuild r,w,s,z,q from psi and p
+      ////////////////////////////////////////////////////////////
+      if ( gamma < Delta * MaxResidSinceLastReplacement ) {
+
+	MatrixTimer.Start();
+	Linop.HermOp(psi, w);
+	r = src - w;
+	Linop.HermOp(r, w);
+	Linop.HermOp(p, s);
+	Linop.HermOp(s, z);
+	Linop.HermOp(w, q);
+	MatrixTimer.Stop();
+
+	innerProductBatch<2>(ip,lhs,rhs);
+	std::cout << GridLogIterative << "ConjugateGradientPipelined: residual replacement on iteration " << k
+		  << " recursive " << gamma << " true " << real(ip[0]) << std::endl;
+	gamma = real(ip[0]);
+	delta = real(ip[1]);
+	MaxResidSinceLastReplacement = gamma;
+	l++;
+      }
+    }
+    std::cout << GridLogMessage << "ConjugateGradientPipelined did NOT converge "<<k<<" / "<< MaxIterations<< std::endl;
+
+    if (ErrorOnNoConverge) assert(0);
+    IterationsToComplete = k;
+    ReplacementsPerformed = l;
+  }
+};
+
+NAMESPACE_END(Grid);
+#endif
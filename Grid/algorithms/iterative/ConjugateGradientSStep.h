@@ -0,0 +1,292 @@
+/*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./lib/algorithms/iterative/ConjugateGradientSStep.h
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+*************************************************************************************/
+/*  END LEGAL */
+#ifndef GRID_CONJUGATE_GRADIENT_SSTEP_H
+#define GRID_CONJUGATE_GRADIENT_SSTEP_H
+
+NAMESPACE_BEGIN(Grid);
+
+/////////////////////////////////////////////////////////////////////////////////////////
+// s-step CG; A.T. Chronopoulos and C.W. Gear, J. Comput. Appl. Math. 25 (1989) 153,
+// with the Chebyshev basis of E. Carson, Ph.D. thesis, UC Berkeley (2015).
+//
+// Each outer step builds V = [T_0(A) r, ..., T_{s-1}(A) r] and AV with s back to back
+// HermOp calls, T_j the Chebyshev polynomials shifted to the spectral interval [Lo,Hi].
+// Directions P = V - P' B are made A-orthogonal to the previous block P', and
+//
+//   C = (AP')^H V ,   B = W'^{-1} C ,   W = P^H A P = V^H A V - C^H B ,   alpha = W^{-1} V^H r
+//
+// so V^H AV, (AP')^H V and V^H r are all the global information needed: 2s^2+s inner
+// products swept together and summed in a single allreduce per s CG iterations.
+// Since V_0 = r the same reduction also carries |r|^2 for the stopping test.
+//
+// If Hi is not given it is estimated with a few power iterations at the start of every
+// solve, so one instance can serve different operators; Lo defaults to zero.
+// Basis=Monomial is kept for comparison only; it loses linear independence beyond s ~ 4.
+/////////////////////////////////////////////////////////////////////////////////////////
+template <class Field>
+class ConjugateGradientSStep : public OperatorFunction<Field> {
+public:
+
+  using OperatorFunction<Field>::operator();
+
+  enum BasisType { Monomial, Chebyshev };
+
+  bool ErrorOnNoConverge;  // throw an assert when the CG fails to converge.
+                           // Defaults true.
+  RealD Tolerance;
+  Integer MaxIterations;   // counted in CG iterations, i.e. s per outer step
+  Integer SStep;
+  BasisType Basis;
+  RealD Lo, Hi;            // spectral interval for the Chebyshev basis
+  Integer IterationsToComplete; //Number of iterations the CG took to finish. Filled in upon completion
+  Integer ReductionsPerformed;
+
+  ConjugateGradientSStep(RealD tol, Integer maxit, Integer sstep=4, RealD lo=0.0, RealD hi=0.0, bool err_on_no_conv = true)
+    : Tolerance(tol),
+      MaxIterations(maxit),
+      SStep(sstep),
+      Basis(Chebyshev),
+      Lo(lo),
+      Hi(hi),
+      ErrorOnNoConverge(err_on_no_conv){};
+
+  void operator()(LinearOperatorBase<Field> &Linop, const Field &src, Field &psi) {
+
+    psi.Checkerboard() = src.Checkerboard();
+
+    conformable(psi, src);
+
+    GridBase *grid = src.Grid();
+    const int s = SStep;
+    assert(s>=1);
+
+    typedef typename Field::vector_object vobj;
+    typedef typename vobj::scalar_type scalar_type;
+    typedef Eigen::MatrixXcd Matrix;
+    typedef Eigen::VectorXcd Vec;
+
+    GridStopWatch LinalgTimer;
+    GridStopWatch MatrixTimer;
+    GridStopWatch ReduceTimer;
+    GridStopWatch SolverTimer;
+
+    std::vector<Field> V (s,grid);
+    std::vector<Field> AV(s,grid);
+    std::vector<Field> P (s,grid);
+    std::vector<Field> AP(s,grid);
+    Field r(src);
+    Field tmp(src);
+
+    // Initial residual computation & set up
+    RealD guess = norm2(psi);
+    assert(std::isnan(guess) == 0);
+
+    Linop.HermOp(psi, tmp);
+    r = src - tmp;
+
+    RealD ssq = norm2(src);
+    RealD rsq = Tolerance * Tolerance * ssq;
+
+    std::cout << GridLogIterative << std::setprecision(8) << "ConjugateGradientSStep: guess " << guess << std::endl;
+    std::cout << GridLogIterative << std::setprecision(8) << "ConjugateGradientSStep:   src " << ssq << std::endl;
+
+    ////////////////////////////////////////////////////////////
+    // Basis recurrence v_{j+1} = 2 (A - c) v_j / d - v_{j-1}
+    ////////////////////////////////////////////////////////////
+    RealD c = 0.0;
+    RealD d = 1.0;
+    if ( Basis == Chebyshev ) {
+      RealD hi = Hi;
+      if ( hi <= 0.0 ) {
+	tmp = r;
+	RealD nn = norm2(tmp);
+	for(int i=0;i<10;i++){
+	  tmp = tmp * (1.0/std::sqrt(nn));
+	  Linop.HermOp(tmp, V[0]);
+	  nn = norm2(V[0]);
+	  tmp = V[0];
+	}
+	hi = 1.1 * std::sqrt(nn);  // power iteration underestimates; pad
+	std::cout << GridLogMessage << "ConjugateGradientSStep: estimated spectral bound " << hi << std::endl;
+      }
+      c = 0.5*(hi+Lo);
+      d = 0.5*(hi-Lo);
+    }
+
+    auto linearCombine = [&](std::vector<Field> &out,std::vector<Field> &in,std::vector<Field> &prev,const Matrix &B) {
+      // out[j] = in[j] - sum_i prev[i] B(i,j)
+      std::vector<vobj *> o_p(s);
+      std::vector<const vobj *> i_p(s);
+      std::vector<const vobj *> p_p(s);
+      std::vector<scalar_type> coef(s*s);
+      for(int i=0;i<s;i++){
+	auto o_v = out[i].View();  o_p[i] = &o_v[0];
+	auto i_v = in[i].View();   i_p[i] = &i_v[0];
+	auto p_v = prev[i].View(); p_p[i] = &p_v[0];
+	for(int j=0;j<s;j++) coef[i*s+j] = B(i,j);
+      }
+      vobj * const *op = &o_p[0];
+      const vobj * const *ip = &i_p[0];
+      const vobj * const *pp = &p_p[0];
+      const scalar_type *cf = &coef[0];
+      thread_for(ss,grid->oSites(),{
+	for(int j=0;j<s;j++){
+	  vobj t = ip[j][ss];
+	  for(int i=0;i<s;i++){
+	    t = t - cf[i*s+j]*pp[i][ss];
+	  }
+	  op[j][ss] = t;
+	}
+      });
+    };
+
+    std::vector<const Field *> lhs;
+    std::vector<const Field *> rhs;
+    std::vector<ComplexD> ip;
+
+    Matrix W(s,s), Wold(s,s), C(s,s), B(s,s), VAV(s,s);
+    Vec Vr(s), alpha(s);
+
+    SolverTimer.Start();
+    int outer;
+    int k = 0;
+    for (outer = 0; k < MaxIterations; outer++) {
+
+      ////////////////////////////////////////////////////////////
+      // Krylov basis: s matrix multiplies, no reductions
+      ////////////////////////////////////////////////////////////
+      V[0] = r;
+      for(int j=0;j<s;j++){
+	MatrixTimer.Start();
+	Linop.HermOp(V[j], AV[j]);
+	MatrixTimer.Stop();
+	if ( j+1 < s ) {
+	  LinalgTimer.Start();
+	  if ( j==0 || Basis==Monomial ) {
+	    axpby(V[j+1], 1.0/d, -c/d, AV[j], V[j]);
+	  } else {
+	    axpby(V[j+1], 2.0/d, -2.0*c/d, AV[j], V[j]);
+	    V[j+1] = V[j+1] - V[j-1];
+	  }
+	  LinalgTimer.Stop();
+	}
+      }
+
+      ////////////////////////////////////////////////////////////
+      // One Gram reduction: V^H AV, (AP')^H V, V^H r
+      ////////////////////////////////////////////////////////////
+      ReduceTimer.Start();
+      lhs.resize(0);
+      rhs.resize(0);
+      for(int i=0;i<s;i++) for(int j=0;j<s;j++) { lhs.push_back(&V[i]);  rhs.push_back(&AV[j]); }
+      if ( outer>0 ) {
+	for(int i=0;i<s;i++) for(int j=0;j<s;j++) { lhs.push_back(&AP[i]); rhs.push_back(&V[j]); }
+      }
+      for(int i=0;i<s;i++) { lhs.push_back(&V[i]); rhs.push_back(&r); }
+      ip.resize(lhs.size());
+      innerProductBatch(&ip[0],lhs,rhs);
+      ReduceTimer.Stop();
+
+      int o=0;
+      for(int i=0;i<s;i++) for(int j=0;j<s;j++) VAV(i,j) = ip[o++];
+      if ( outer>0 ) {
+	for(int i=0;i<s;i++) for(int j=0;j<s;j++) C(i,j) = ip[o++];
+      }
+      for(int i=0;i<s;i++) Vr(i) = ip[o++];
+
+      RealD rr = real(Vr(0));
+      std::cout << GridLogIterative << "ConjugateGradientSStep: Iteration " << k
+		<< " residual " << std::sqrt(rr/ssq) << " target " << Tolerance << std::endl;
+
+      // Stopping condition
+      if ( rr <= rsq ) {
+	SolverTimer.Stop();
+	Linop.HermOp(psi, tmp);
+	tmp = tmp - src;
+
+	RealD srcnorm = std::sqrt(ssq);
+	RealD resnorm = std::sqrt(norm2(tmp));
+	RealD true_residual = resnorm / srcnorm;
+
+	std::cout << GridLogMessage << "ConjugateGradientSStep Converged on iteration " << k
+		  << " with s = " << s << " after " << outer << " reductions" << std::endl;
+	std::cout << GridLogMessage << "\tComputed residual " << std::sqrt(rr / ssq)<<std::endl;
+	std::cout << GridLogMessage << "\tTrue residual " << true_residual<<std::endl;
+	std::cout << GridLogMessage << "\tTarget " << Tolerance << std::endl;
+
+	std::cout << GridLogMessage << "Time breakdown "<<std::endl;
+	std::cout << GridLogMessage << "\tElapsed    " << SolverTimer.Elapsed() <<std::endl;
+	std::cout << GridLogMessage << "\tMatrix     " << MatrixTimer.Elapsed() <<std::endl;
+	std::cout << GridLogMessage << "\tLinalg     " << LinalgTimer.Elapsed() <<std::endl;
+	std::cout << GridLogMessage << "\tReduce     " << ReduceTimer.Elapsed() <<std::endl;
+
+	if (ErrorOnNoConverge) assert(true_residual / Tolerance < 10000.0);
+
+	IterationsToComplete = k;
+	ReductionsPerformed = outer+1;
+	return;
+      }
+
+      ////////////////////////////////////////////////////////////
+      // A-orthogonalise against the previous block; s x s solves
+      ////////////////////////////////////////////////////////////
+      LinalgTimer.Start();
+      if ( outer==0 ) {
+	for(int j=0;j<s;j++) { P[j] = V[j]; AP[j] = AV[j]; }
+	W = VAV;
+      } else {
+	B = Wold.fullPivLu().solve(C);
+	W = VAV - C.adjoint()*B;
+	// V and AV are free after this; reuse as the new P, AP storage
+	linearCombine(V ,V ,P ,B);
+	linearCombine(AV,AV,AP,B);
+	std::swap(V ,P);
+	std::swap(AV,AP);
+      }
+      alpha = W.fullPivLu().solve(Vr);
+      Wold  = W;
+
+      for(int j=0;j<s;j++){
+	scalar_type a = scalar_type(alpha(j));
+	psi = psi + a*P[j];
+	r   = r   - a*AP[j];
+      }
+      LinalgTimer.Stop();
+
+      k += s;
+    }
+    std::cout << GridLogMessage << "ConjugateGradientSStep did NOT converge "<<k<<" / "<< MaxIterations<< std::endl;
+
+    if (ErrorOnNoConverge) assert(0);
+    IterationsToComplete = k;
+    ReductionsPerformed = outer;
+  }
+};
+
+NAMESPACE_END(Grid);
+#endif
@@ -1,5 +1,13 @@
 #include <Grid/GridCore.h>
 #include <fcntl.h>
+#include <sys/mman.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#include <unistd.h>
+#include <mutex>
+#include <map>
+#include <deque>
 
 NAMESPACE_BEGIN(Grid);
 
@@ -7,43 +15,106 @@ MemoryStats *MemoryProfiler::stats = nullptr;
 bool         MemoryProfiler::debug = false;
 
 #ifdef POINTER_CACHE
-int PointerCache::victim;
+int      PointerCache::Ncache       = 8;
+uint64_t PointerCache::MaxBytes     = 0;
+int      PointerCache::ZeroRecycled = 1;
+
+typedef struct { 
+  void *address;
+  size_t bytes;
+  uint64_t age;
+} PointerCacheEntry;
+
+static std::mutex                                     CacheMutex;
+static std::map<size_t,std::deque<PointerCacheEntry> > CacheClasses; // oldest at front
+static uint64_t                                       CacheAge;
+static uint64_t                                       CacheBytes;
+static uint64_t                                       CacheMaxBytes;
+static uint64_t                                       CacheHits;
+static uint64_t                                       CacheMisses;
+
+static void CacheAccount(void)
+{
+  CacheMaxBytes = std::max(CacheMaxBytes,CacheBytes);
+  if (MemoryProfiler::stats) {
+    auto s = MemoryProfiler::stats;
+    s->currentlyCached = CacheBytes;
+    s->maxCached       = std::max(s->maxCached,(size_t)CacheBytes);
+    s->cacheHits       = CacheHits;
+    s->cacheMisses     = CacheMisses;
+  }
+}
+
+size_t PointerCache::ClassBytes(size_t bytes)
+{
+  const size_t page = 4096;
+  return ((bytes + page-1)/page)*page;
+}
 
-PointerCache::PointerCacheEntry PointerCache::Entries[PointerCache::Ncache];
+uint64_t PointerCache::DefaultBytes(void)
+{
+  uint64_t pages = sysconf(_SC_PHYS_PAGES);
+  uint64_t page  = sysconf(_SC_PAGESIZE);
+  uint64_t ranks = std::max(GlobalSharedMemory::WorldShmSize,1);
+  return pages*page/8/ranks;
+}
+
+// Blocks evicted from the cache go back to the system as deallocate would
+static void CacheRelease(void *ptr)
+{
+#ifdef GRID_NVCC
+  cudaFree(ptr);
+#else
+  if ( HugePagePolicy::Free(ptr) ) return;
+#ifdef HAVE_MM_MALLOC_H
+  _mm_free(ptr);
+#else
+  free(ptr);
+#endif
+#endif
+}
 
 void *PointerCache::Insert(void *ptr,size_t bytes) {
 
   if (bytes < 4096 ) return ptr;
+  if (Ncache <= 0 )  return ptr;
 
-#ifdef GRID_OMP
-  assert(omp_in_parallel()==0);
-#endif 
+  bytes = ClassBytes(bytes);
+  if ( MaxBytes && (bytes > MaxBytes) ) return ptr;
 
   void * ret = NULL;
-  int v = -1;
+  std::vector<void *> evicted;
+  {
+    std::lock_guard<std::mutex> guard(CacheMutex);
 
-  for(int e=0;e<Ncache;e++) {
-    if ( Entries[e].valid==0 ) {
-      v=e; 
-      break;
-    }
-  }
+    auto &entries = CacheClasses[bytes];
 
-  if ( v==-1 ) {
-    v=victim;
-    victim = (victim+1)%Ncache;
-  }
+    if ( entries.size() >= (size_t)Ncache ) {
+      // Class is full: replace its oldest block
+      ret = entries.front().address;
+      entries.pop_front();
+      CacheBytes -= bytes;
+    }
+    // Over budget: evict the least recently returned blocks of any class
+    while ( MaxBytes && (CacheBytes + bytes > MaxBytes) ) {
+      auto victim = CacheClasses.end();
+      for(auto c=CacheClasses.begin();c!=CacheClasses.end();c++){
+	if ( c->second.size() && 
+	     ( (victim==CacheClasses.end()) || (c->second.front().age < victim->second.front().age) ) ) {
+	  victim = c;
+	}
+      }
+      evicted.push_back(victim->second.front().address);
+      victim->second.pop_front();
+      CacheBytes -= victim->first;
+    }
 
-  if ( Entries[v].valid ) {
-    ret = Entries[v].address;
-    Entries[v].valid = 0;
-    Entries[v].address = NULL;
-    Entries[v].bytes = 0;
+    PointerCacheEntry entry = { ptr, bytes, CacheAge++ };
+    entries.push_back(entry);
+    CacheBytes += bytes;
+    CacheAccount();
   }
-
-  Entries[v].address=ptr;
-  Entries[v].bytes  =bytes;
-  Entries[v].valid  =1;
+  for(auto p : evicted) CacheRelease(p);
 
   return ret;
 }
@@ -52,17 +123,36 @@ void *PointerCache::Lookup(size_t bytes) {
 
   if (bytes < 4096 ) return NULL;
 
-#ifdef GRID_OMP
-  assert(omp_in_parallel()==0);
-#endif 
+  bytes = ClassBytes(bytes);
+
+  std::lock_guard<std::mutex> guard(CacheMutex);
+
+  void * ret = NULL;
+  auto c = CacheClasses.find(bytes);
+  if ( (c != CacheClasses.end()) && c->second.size() ) {
+    // Most recently returned block is the most likely to still be in cache
+    ret = c->second.back().address;
+    c->second.pop_back();
+    CacheBytes -= bytes;
+    CacheHits++;
+  } else {
+    CacheMisses++;
+  }
+  CacheAccount();
+  return ret;
+}
 
-  for(int e=0;e<Ncache;e++){
-    if ( Entries[e].valid && ( Entries[e].bytes == bytes ) ) {
-      Entries[e].valid = 0;
-      return Entries[e].address;
+void PointerCache::Report(void)
+{
+  std::lock_guard<std::mutex> guard(CacheMutex);
+  std::cout << GridLogMessage << "PointerCache: " << CacheHits << " hits " << CacheMisses << " misses; "
+	    << "holding " << sizeString(CacheBytes) << " high water " << sizeString(CacheMaxBytes) << std::endl;
+  for(auto c=CacheClasses.begin();c!=CacheClasses.end();c++){
+    if ( c->second.size() ) {
+      std::cout << GridLogMessage << "PointerCache:   class " << sizeString(c->first) 
+		<< " : " << c->second.size() << " free blocks" << std::endl;
     }
   }
-  return NULL;
 }
 #endif
 
@@ -98,6 +188,191 @@ void check_huge_pages(void *Buf,uint64_t BYTES)
 #endif
 }
 
+////////////////////////////////////////////////////////////////////////////
+// NUMA placement; raw syscalls keep libnuma out of the dependency list
+////////////////////////////////////////////////////////////////////////////
+int NumaPolicy::Policy = NumaPolicy::FirstTouch;
+int NumaPolicy::Node   = 0;
+
+#define GRID_MPOL_BIND       2
+#define GRID_MPOL_INTERLEAVE 3
+
+int NumaPolicy::Nodes(void)
+{
+  static int nodes = 0;
+  if ( nodes ) return nodes;
+  nodes = 1;
+#ifdef __linux__
+  // Format is a list of ranges, e.g. "0-1" or "0,2-3"
+  FILE *fp = fopen("/sys/devices/system/node/online","r");
+  if ( fp ) {
+    int lo,hi;
+    char sep;
+    while ( fscanf(fp,"%d",&lo)==1 ) {
+      hi = lo;
+      if ( fscanf(fp,"%c",&sep)==1 && sep=='-' ) {
+	if ( fscanf(fp,"%d",&hi)!=1 ) hi=lo;
+	if ( fscanf(fp,"%c",&sep)!=1 ) sep='\n';
+      }
+      nodes = std::max(nodes,hi+1);
+      if ( sep != ',' ) break;
+    }
+    fclose(fp);
+  }
+#endif
+  return nodes;
+}
+
+std::string NumaPolicy::Name(void)
+{
+  switch(Policy) {
+  case SiteTouch  : return std::string("site partitioned first touch");
+  case Interleave : return std::string("interleaved over ")+std::to_string(Nodes())+" nodes";
+  case Bind       : return std::string("bound to node ")+std::to_string(Node);
+  default         : return std::string("first touch");
+  }
+}
+
+void NumaPolicy::Place(void *ptr,uint64_t bytes)
+{
+  if ( (Policy != Interleave) && (Policy != Bind) ) return;
+#if defined(__linux__) && defined(SYS_mbind)
+  const uint64_t page = 4096;
+  const int maxnode = 8*sizeof(unsigned long);
+  unsigned long mask = 0;
+  int mode;
+  if ( Policy == Interleave ) {
+    mode = GRID_MPOL_INTERLEAVE;
+    for(int n=0;n<std::min(Nodes(),maxnode);n++) mask |= 1UL<<n;
+  } else {
+    mode = GRID_MPOL_BIND;
+    assert(Node < maxnode);
+    mask = 1UL<<Node;
+  }
+  uint64_t base = ((uint64_t)ptr) & ~(page-1);
+  uint64_t len  = ((uint64_t)ptr) + bytes - base;
+  long ret = syscall(SYS_mbind,(void *)base,len,mode,&mask,maxnode+1,0);
+  if ( ret ) {
+    static int warned = 0;
+    if ( !warned ) {
+      std::cout << GridLogWarning << "NumaPolicy: mbind failed ("<<strerror(errno)<<"); using first touch" << std::endl;
+      warned = 1;
+    }
+  }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Huge page backing
+////////////////////////////////////////////////////////////////////////////
+int HugePagePolicy::Mode = HugePagePolicy::None;
+
+static std::mutex                 HugeMutex;
+static std::map<void *,uint64_t>  HugeMappings;   // hugetlb block -> mapped length
+static uint64_t                   HugeTlbBytes;   // requested through MAP_HUGETLB
+static uint64_t                   HugeAdvBytes;   // requested through MADV_HUGEPAGE
+static uint64_t                   HugeFailBytes;  // no huge page request honoured
+
+void *HugePagePolicy::Allocate(size_t bytes)
+{
+  if ( Mode != Hugetlb ) return NULL;
+#if defined(MAP_HUGETLB) && defined(MAP_ANONYMOUS)
+  const uint64_t huge = 2*1024*1024;
+  uint64_t len = ((bytes+huge-1)/huge)*huge;
+  void *ptr = mmap(NULL,len,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB,-1,0);
+  if ( ptr == MAP_FAILED ) {
+    static int warned = 0;
+    if ( !warned ) {
+      std::cout << GridLogWarning << "HugePagePolicy: MAP_HUGETLB failed ("<<strerror(errno)<<"); "
+		<< "falling back to transparent huge pages" << std::endl;
+      warned = 1;
+    }
+    return NULL;
+  }
+  std::lock_guard<std::mutex> guard(HugeMutex);
+  HugeMappings[ptr] = len;
+  HugeTlbBytes += bytes;
+  return ptr;
+#else
+  return NULL;
+#endif
+}
+
+void HugePagePolicy::Advise(void *ptr,size_t bytes)
+{
+  if ( Mode == None ) return;
+  if ( Mode == Hugetlb ) {
+    std::lock_guard<std::mutex> guard(HugeMutex);
+    if ( HugeMappings.find(ptr) != HugeMappings.end() ) return;
+  }
+  int ret = -1;
+#ifdef MADV_HUGEPAGE
+  // Blocks are GRID_ALLOC_ALIGN aligned so only the page rounding of the tail matters
+  const uint64_t page = 4096;
+  uint64_t base = ((uint64_t)ptr) & ~(page-1);
+  ret = madvise((void *)base,((uint64_t)ptr)+bytes-base,MADV_HUGEPAGE);
+#endif
+  std::lock_guard<std::mutex> guard(HugeMutex);
+  if ( ret == 0 ) HugeAdvBytes  += bytes;
+  else            HugeFailBytes += bytes;
+}
+
+int HugePagePolicy::Free(void *ptr)
+{
+  if ( Mode != Hugetlb ) return 0;
+  uint64_t len;
+  {
+    std::lock_guard<std::mutex> guard(HugeMutex);
+    auto m = HugeMappings.find(ptr);
+    if ( m == HugeMappings.end() ) return 0;
+    len = m->second;
+    HugeMappings.erase(m);
+  }
+  munmap(ptr,len);
+  return 1;
+}
+
+void HugePagePolicy::Report(void)
+{
+  if ( Mode == None ) return;
+  ////////////////////////////////////////////////////////////
+  // Kernel view of this process: huge page backed vs all
+  // anonymous memory, summed over the mappings in smaps
+  ////////////////////////////////////////////////////////////
+  uint64_t anon=0, thp=0, tlb=0;
+#ifdef __linux__
+  FILE *fp = fopen("/proc/self/smaps","r");
+  if ( fp ) {
+    char line[256];
+    unsigned long long kb;
+    while ( fgets(line,sizeof(line),fp) ) {
+      if      ( sscanf(line,"Anonymous: %llu kB",&kb)==1 )       anon += kb*1024;
+      else if ( sscanf(line,"AnonHugePages: %llu kB",&kb)==1 )   thp  += kb*1024;
+      else if ( sscanf(line,"Private_Hugetlb: %llu kB",&kb)==1 ) tlb  += kb*1024;
+      else if ( sscanf(line,"Shared_Hugetlb: %llu kB",&kb)==1 )  tlb  += kb*1024;
+    }
+    fclose(fp);
+  }
+#endif
+  uint64_t req_tlb, req_adv, req_fail;
+  {
+    std::lock_guard<std::mutex> guard(HugeMutex);
+    req_tlb = HugeTlbBytes; req_adv = HugeAdvBytes; req_fail = HugeFailBytes;
+  }
+  // One reduction over the world communicator, no grid needed at finalize
+  uint64_t sums[6] = { anon, thp, tlb, req_tlb, req_adv, req_fail };
+  CartesianCommunicator::GlobalSumVectorWorld(sums,6);
+  anon    = sums[0]; thp    = sums[1]; tlb      = sums[2];
+  req_tlb = sums[3]; req_adv= sums[4]; req_fail = sums[5];
+  double total    = (double)(anon+tlb);
+  double coverage = total > 0 ? 100.0*(double)(thp+tlb)/total : 0.0;
+  std::cout << GridLogMessage << "HugePagePolicy: lattice allocations "<< sizeString(req_tlb) << " hugetlb, "
+	    << sizeString(req_adv) << " THP advised, " << sizeString(req_fail) << " without huge pages" << std::endl;
+  std::cout << GridLogMessage << "HugePagePolicy: "<< sizeString(thp+tlb) << " of " << sizeString(anon+tlb)
+	    << " resident memory in huge pages over " << GlobalSharedMemory::WorldSize << " ranks ("
+	    << std::setprecision(3) << coverage << "%)" << std::endl;
+}
+
 std::string sizeString(const size_t bytes)
 {
   constexpr unsigned int bufSize = 256;
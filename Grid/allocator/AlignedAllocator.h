@@ -47,26 +47,30 @@ NAMESPACE_BEGIN(Grid);
 
 // Move control to configure.ac and Config.h?
 #ifdef POINTER_CACHE
+//////////////////////////////////////////////////////////////////////////////
+// Size-class pool of recycled allocations.
+// Blocks are binned by their size rounded up to a page; each class keeps up
+// to Ncache free blocks, and the pool as a whole retains at most MaxBytes
+// (0 = no limit), evicting the least recently returned blocks over all classes
+// first. Grid_init sets MaxBytes to DefaultBytes unless --alloc-cache-mb is given.
+// Lookup/Insert are thread safe and may be called inside parallel regions.
+//////////////////////////////////////////////////////////////////////////////
 class PointerCache {
-private:
-
-  static const int Ncache=8;
-  static int victim;
-
-  typedef struct { 
-    void *address;
-    size_t bytes;
-    int valid;
-  } PointerCacheEntry;
-    
-  static PointerCacheEntry Entries[Ncache];
-
 public:
 
+  static int      Ncache;       // free blocks retained per size class
+  static uint64_t MaxBytes;     // bound on total retained bytes
+  static int      ZeroRecycled; // repeat the first touch zeroing on a cache hit
+
+  static size_t ClassBytes(size_t bytes);
 
   static void *Insert(void *ptr,size_t bytes) ;
   static void *Lookup(size_t bytes) ;
 
+  // an eighth of the node's physical memory, shared by its ranks
+  static uint64_t DefaultBytes(void);
+
+  static void Report(void);
 };
 #endif  
 
@@ -76,6 +80,8 @@ struct MemoryStats
 {
   size_t totalAllocated{0}, maxAllocated{0}, 
     currentlyAllocated{0}, totalFreed{0};
+  size_t cacheHits{0}, cacheMisses{0},
+    currentlyCached{0}, maxCached{0};
 };
     
 class MemoryProfiler
@@ -99,6 +105,9 @@ public:
 		<< std::endl;						\
       std::cout << GridLogDebug << "[Memory debug] freed  : " << memString(s->totalFreed) \
 		<< std::endl;						\
+      std::cout << GridLogDebug << "[Memory debug] cached : " << memString(s->currentlyCached) \
+		<< " max " << memString(s->maxCached)			\
+		<< " hits " << s->cacheHits << " misses " << s->cacheMisses << std::endl; \
     }
 
 #define profilerAllocate(bytes)						\
@@ -130,6 +139,41 @@ public:
 
 void check_huge_pages(void *Buf,uint64_t BYTES);
 
+//////////////////////////////////////////////////////////////////////////////
+// NUMA placement of fresh allocations.
+// FirstTouch : pages land where the threaded zeroing loop touches them
+// SiteTouch  : zero object by object with the static thread_for partition,
+//              so pages follow the threads that own those oSites in kernels
+// Interleave : round robin pages over all online nodes (mbind)
+// Bind       : place all pages on NumaPolicy::Node (mbind)
+//////////////////////////////////////////////////////////////////////////////
+class NumaPolicy {
+public:
+  enum { FirstTouch, SiteTouch, Interleave, Bind };
+  static int Policy;
+  static int Node;
+  static int  Nodes(void);
+  static void Place(void *ptr,uint64_t bytes);
+  static std::string Name(void);
+};
+
+//////////////////////////////////////////////////////////////////////////////
+// Huge page backing of lattice allocations.
+// Madvise : transparent huge page hint (MADV_HUGEPAGE) on each fresh block
+// Hugetlb : explicit MAP_HUGETLB mapping from the hugetlbfs pool; when the
+//           pool is absent or exhausted fall back to the Madvise path
+// Report aggregates the resulting coverage over all ranks.
+//////////////////////////////////////////////////////////////////////////////
+class HugePagePolicy {
+public:
+  enum { None, Madvise, Hugetlb };
+  static int Mode;
+  static void *Allocate(size_t bytes); // NULL unless a hugetlb mapping was made
+  static void  Advise(void *ptr,size_t bytes);
+  static int   Free(void *ptr);        // 1 if ptr was a hugetlb mapping, now unmapped
+  static void  Report(void);
+};
+
 ////////////////////////////////////////////////////////////////////
 // A lattice of something, but assume the something is SIMDized.
 ////////////////////////////////////////////////////////////////////
@@ -161,8 +205,11 @@ public:
 
 #ifdef POINTER_CACHE
     _Tp *ptr = (_Tp *) PointerCache::Lookup(bytes);
+    int recycled = (ptr != (_Tp *) NULL);
+    if ( bytes >= 4096 ) bytes = PointerCache::ClassBytes(bytes);
 #else
     pointer ptr = nullptr;
+    int recycled = 0;
 #endif
 
 #ifdef GRID_NVCC
@@ -182,6 +229,7 @@ public:
     //////////////////////////////////////////////////////////////////////////////////////////
     // 2MB align; could make option probably doesn't need configurability
     //////////////////////////////////////////////////////////////////////////////////////////
+    if ( ptr == (_Tp *) NULL ) ptr = (_Tp *) HugePagePolicy::Allocate(bytes);
   #ifdef HAVE_MM_MALLOC_H
     if ( ptr == (_Tp *) NULL ) ptr = (_Tp *) _mm_malloc(bytes,GRID_ALLOC_ALIGN);
   #else
@@ -189,13 +237,34 @@ public:
   #endif
     assert( ptr != (_Tp *)NULL);
 
+    //////////////////////////////////////////////////
+    // Kernel placement policy for fresh pages, before any touch
+    //////////////////////////////////////////////////
+    if ( !recycled ) { 
+      HugePagePolicy::Advise((void *)ptr,bytes);
+      NumaPolicy::Place((void *)ptr,bytes);
+    }
+
     //////////////////////////////////////////////////
     // First touch optimise in threaded loop 
+    // Recycled blocks are already placed; zero only if asked
     //////////////////////////////////////////////////
-    uint64_t *cp = (uint64_t *)ptr;
-    thread_for(n,bytes/sizeof(uint64_t), { // need only one touch per page
-      cp[n]=0;
-    });
+#ifdef POINTER_CACHE
+    if ( recycled && !PointerCache::ZeroRecycled ) return ptr;
+#endif
+    if ( NumaPolicy::Policy == NumaPolicy::SiteTouch ) {
+      // Same static partition of objects as a thread_for over oSites
+      thread_for(n,__n, {
+	memset((void *)&ptr[n],0,sizeof(_Tp));
+      });
+      uint64_t tail = __n*sizeof(_Tp);
+      if ( bytes > tail ) memset((char *)ptr+tail,0,bytes-tail);
+    } else { 
+      uint64_t *cp = (uint64_t *)ptr;
+      thread_for(n,bytes/sizeof(uint64_t), { // need only one touch per page
+	cp[n]=0;
+      });
+    }
 #endif
     return ptr;
   }
@@ -214,6 +283,7 @@ public:
 #ifdef GRID_NVCC
     if ( __freeme ) cudaFree((void *)__freeme);
 #else 
+    if ( __freeme && HugePagePolicy::Free((void *)__freeme) ) __freeme = NULL;
   #ifdef HAVE_MM_MALLOC_H
     if ( __freeme ) _mm_free((void *)__freeme); 
   #else
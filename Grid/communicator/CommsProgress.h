@@ -0,0 +1,73 @@
+/*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid 
+
+    Source file: ./lib/communicator/CommsProgress.h
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+*************************************************************************************/
+/*  END LEGAL */
+#ifndef GRID_COMMS_PROGRESS_H
+#define GRID_COMMS_PROGRESS_H
+
+#include <atomic>
+
+NAMESPACE_BEGIN(Grid);
+
+//////////////////////////////////////////////////////////////////////////////////////
+// Dedicated comms progress threads for the stencil halo exchange.
+//
+// With --comms-progress, --comms-progress-threads n (default 1) threads are started
+// in Grid_init and pinned to the last n cpus of the process cpuset; the OpenMP pool
+// is trimmed so compute does not share those cores.
+// CartesianStencil::CommunicateBegin then hands its Packets to the threads through
+// single producer/single consumer rings instead of calling MPI itself. A progress
+// thread posts every queued packet with StencilSendToRecvFromBegin and then sits in
+// StencilSendToRecvFromComplete, driving MPI while the interior Dslash runs;
+// CommunicateComplete only waits on a counter. The threads take precedence over
+// --comms-persistent, which is then switched off.
+//////////////////////////////////////////////////////////////////////////////////////
+class CommsProgress {
+public:
+  struct Request {
+    CartesianCommunicator *comm;
+    void *xmit;
+    int   dest;
+    void *recv;
+    int   from;
+    int   bytes;
+    int   dir;
+    std::atomic<int> *pending;  // decremented on completion
+    double *offnode_bytes;      // filled in by the progress thread
+    double *done_time;          // usecond() at completion
+  };
+
+  static int  nThreads;         // 0 : caller threads drive comms
+
+  static int  Active(void) { return nThreads>0; }
+  static void Start(int nthreads);
+  static void Stop(void);
+  static void Post(int thread,const Request &r);
+};
+
+NAMESPACE_END(Grid);
+
+#endif
@@ -31,5 +31,6 @@ Author: Peter Boyle <paboyle@ph.ed.ac.uk>
 #include <Grid/util/Coordinate.h>
 #include <Grid/communicator/SharedMemory.h>
 #include <Grid/communicator/Communicator_base.h>
+#include <Grid/communicator/CommsProgress.h>
 
 #endif
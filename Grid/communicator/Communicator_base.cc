@@ -30,6 +30,11 @@ Author: Peter Boyle <paboyle@ph.ed.ac.uk>
 #include <unistd.h>
 #include <limits.h>
 #include <sys/mman.h>
+#include <thread>
+#ifdef __linux__
+#include <sched.h>
+#include <pthread.h>
+#endif
 
 NAMESPACE_BEGIN(Grid);
 
@@ -39,6 +44,7 @@ NAMESPACE_BEGIN(Grid);
 CartesianCommunicator::CommunicatorPolicy_t  
 CartesianCommunicator::CommunicatorPolicy= CartesianCommunicator::CommunicatorPolicyConcurrent;
 int CartesianCommunicator::nCommThreads = -1;
+int CartesianCommunicator::PersistentComms = 0;
 
 /////////////////////////////////
 // Grid information queries
@@ -71,6 +77,127 @@ void CartesianCommunicator::GlobalSumVector(ComplexD *c,int N)
 {
   GlobalSumVector((double *)c,2*N);
 }
+void CartesianCommunicator::GlobalSumVectorBegin(std::vector<CommsRequest_t> &list,ComplexD *c,int N)
+{
+  GlobalSumVectorBegin(list,(double *)c,2*N);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Comms progress threads
+////////////////////////////////////////////////////////////////////////////////
+#define GRID_PROGRESS_RING (4096)
+
+struct CommsProgressRing {
+  CommsProgress::Request buf[GRID_PROGRESS_RING];
+  std::atomic<uint64_t> head;
+  std::atomic<uint64_t> tail;
+};
+
+int CommsProgress::nThreads = 0;
+
+static std::vector<std::thread>        progress_threads;
+static std::vector<CommsProgressRing*> progress_rings;
+static std::atomic<int>                progress_stop;
+
+static void CommsProgressLoop(CommsProgressRing *ring)
+{
+  std::vector<CommsProgress::Request>        inflight;
+  std::vector<std::vector<CommsRequest_t> >  reqs;
+  while ( !progress_stop.load(std::memory_order_relaxed) ) {
+    uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+    uint64_t head = ring->head.load(std::memory_order_acquire);
+    if ( tail != head ) {
+      // Post everything queued so all directions are in flight together
+      for(;tail<head;tail++){
+	CommsProgress::Request r = ring->buf[tail%GRID_PROGRESS_RING];
+	reqs.push_back(std::vector<CommsRequest_t>());
+	*r.offnode_bytes = r.comm->StencilSendToRecvFromBegin(reqs.back(),r.xmit,r.dest,r.recv,r.from,r.bytes,r.dir);
+	inflight.push_back(r);
+      }
+      ring->tail.store(tail,std::memory_order_release);
+    } else if ( inflight.size() ) {
+      for(int i=0;i<inflight.size();i++){
+	inflight[i].comm->StencilSendToRecvFromComplete(reqs[i],inflight[i].dir);
+	*inflight[i].done_time = usecond();
+	inflight[i].pending->fetch_sub(1,std::memory_order_release);
+      }
+      inflight.resize(0);
+      reqs.resize(0);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void CommsProgress::Start(int nthreads)
+{
+  assert(nThreads==0);
+  if ( !CartesianCommunicator::MultipleThreadsSupported() ) {
+    std::cout << GridLogWarning << "CommsProgress: communicator is not thread safe; comms progress threads disabled"<<std::endl;
+    return;
+  }
+
+  // Spare cores: the last nthreads of our cpuset; trim the OpenMP pool to the rest
+  std::vector<int> cpus;
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if ( sched_getaffinity(0,sizeof(set),&set)==0 ) {
+    for(int c=0;c<CPU_SETSIZE;c++) if ( CPU_ISSET(c,&set) ) cpus.push_back(c);
+  }
+#endif
+  int ncpu = cpus.size();
+  if ( ncpu > nthreads ) {
+    int compute = ncpu - nthreads;
+    if ( GridThread::GetThreads() > compute ) {
+      std::cout << GridLogMessage << "CommsProgress: reducing OpenMP threads to "<<compute<<std::endl;
+      GridThread::SetThreads(compute);
+    }
+  }
+
+  progress_stop = 0;
+  for(int t=0;t<nthreads;t++){
+    CommsProgressRing *ring = new CommsProgressRing;
+    ring->head = 0;
+    ring->tail = 0;
+    progress_rings.push_back(ring);
+    progress_threads.push_back(std::thread(CommsProgressLoop,ring));
+#ifdef __linux__
+    if ( ncpu > nthreads ) {
+      cpu_set_t pin;
+      CPU_ZERO(&pin);
+      CPU_SET(cpus[ncpu-1-t],&pin);
+      pthread_setaffinity_np(progress_threads.back().native_handle(),sizeof(pin),&pin);
+      std::cout << GridLogMessage << "CommsProgress: thread "<<t<<" pinned to cpu "<<cpus[ncpu-1-t]<<std::endl;
+    }
+#endif
+  }
+  nThreads = nthreads;
+}
+
+void CommsProgress::Stop(void)
+{
+  if ( nThreads==0 ) return;
+  progress_stop = 1;
+  for(int t=0;t<nThreads;t++){
+    progress_threads[t].join();
+    delete progress_rings[t];
+  }
+  progress_threads.resize(0);
+  progress_rings.resize(0);
+  nThreads = 0;
+}
+
+void CommsProgress::Post(int thread,const Request &r)
+{
+  CommsProgressRing *ring = progress_rings[thread];
+  uint64_t head = ring->head.load(std::memory_order_relaxed);
+  while ( head - ring->tail.load(std::memory_order_acquire) >= GRID_PROGRESS_RING ) {
+    std::this_thread::yield();
+  }
+  ring->buf[head%GRID_PROGRESS_RING] = r;
+  ring->head.store(head+1,std::memory_order_release);
+}
   
 NAMESPACE_END(Grid);
 
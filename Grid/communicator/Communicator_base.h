@@ -47,6 +47,7 @@ public:
   static CommunicatorPolicy_t CommunicatorPolicy;
   static void SetCommunicatorPolicy(CommunicatorPolicy_t policy ) { CommunicatorPolicy = policy; }
   static int       nCommThreads;
+  static int       MultipleThreadsSupported(void);
 
   ////////////////////////////////////////////
   // Communicator should know nothing of the physics grid, only processor grid.
@@ -104,6 +105,7 @@ public:
   ////////////////////////////////////////////////////////////////////////////////
   static int  RankWorld(void) ;
   static void BroadcastWorld(int root,void* data, int bytes);
+  static void GlobalSumVectorWorld(uint64_t *u,int N);
   
   ////////////////////////////////////////////////////////////
   // Reduction
@@ -120,6 +122,14 @@ public:
   void GlobalSumVector(ComplexD *c,int N);
   void GlobalXOR(uint32_t &);
   void GlobalXOR(uint64_t &);
+
+  ////////////////////////////////////////////////////////////
+  // Non-blocking reduction; the vector is summed in place and
+  // must not be touched until the matching Complete call
+  ////////////////////////////////////////////////////////////
+  void GlobalSumVectorBegin(std::vector<CommsRequest_t> &list,RealD *,int N);
+  void GlobalSumVectorBegin(std::vector<CommsRequest_t> &list,ComplexD *c,int N);
+  void GlobalSumVectorComplete(std::vector<CommsRequest_t> &list);
   
   template<class obj> void GlobalSum(obj &o){
     typedef typename obj::scalar_type scalar_type;
@@ -169,6 +179,22 @@ public:
   void StencilSendToRecvFromComplete(std::vector<CommsRequest_t> &waitall,int i);
   void StencilBarrier(void);
 
+  ////////////////////////////////////////////////////////////
+  // Persistent halo requests: ranks, buffers and sizes are bound once
+  // and the requests restarted each exchange (--comms-persistent)
+  ////////////////////////////////////////////////////////////
+  static int PersistentComms;
+
+  double StencilSendToRecvFromPersistentInit(std::vector<CommsRequest_t> &list,
+					     void *xmit,
+					     int xmit_to_rank,
+					     void *recv,
+					     int recv_from_rank,
+					     int bytes,int dir);
+  void StencilSendToRecvFromPersistentStart(std::vector<CommsRequest_t> &list,int dir);
+  void StencilSendToRecvFromPersistentComplete(std::vector<CommsRequest_t> &list,int dir);
+  void StencilSendToRecvFromPersistentFree(std::vector<CommsRequest_t> &list);
+
   ////////////////////////////////////////////////////////////
   // Barrier
   ////////////////////////////////////////////////////////////
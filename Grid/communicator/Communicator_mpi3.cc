@@ -282,6 +282,17 @@ void CartesianCommunicator::GlobalSumVector(double *d,int N)
   int ierr = MPI_Allreduce(MPI_IN_PLACE,d,N,MPI_DOUBLE,MPI_SUM,communicator);
   assert(ierr==0);
 }
+void CartesianCommunicator::GlobalSumVectorBegin(std::vector<CommsRequest_t> &list,double *d,int N)
+{
+  MPI_Request rq;
+  int ierr = MPI_Iallreduce(MPI_IN_PLACE,d,N,MPI_DOUBLE,MPI_SUM,communicator,&rq);
+  assert(ierr==0);
+  list.push_back(rq);
+}
+void CartesianCommunicator::GlobalSumVectorComplete(std::vector<CommsRequest_t> &list)
+{
+  SendToRecvFromComplete(list);
+}
 // Basic Halo comms primitive
 void CartesianCommunicator::SendToRecvFrom(void *xmit,
 					   int dest,
@@ -403,6 +414,78 @@ void CartesianCommunicator::StencilSendToRecvFromComplete(std::vector<CommsReque
 {
   SendToRecvFromComplete(waitall);
 }
+double CartesianCommunicator::StencilSendToRecvFromPersistentInit(std::vector<CommsRequest_t> &list,
+								   void *xmit,
+								   int dest,
+								   void *recv,
+								   int from,
+								   int bytes,int dir)
+{
+  int ncomm  =communicator_halo.size(); 
+  int commdir=dir%ncomm;
+
+  MPI_Request xrq;
+  MPI_Request rrq;
+
+  int ierr;
+  int gdest = ShmRanks[dest];
+  int gfrom = ShmRanks[from];
+  double off_node_bytes=0.0;
+
+  assert(dest != _processor);
+  assert(from != _processor);
+
+  // Same node peers are written directly by the gather; nothing to bind
+  if ( gfrom ==MPI_UNDEFINED) {
+    ierr=MPI_Recv_init(recv, bytes, MPI_CHAR,from,from,communicator_halo[commdir],&rrq);
+    assert(ierr==0);
+    list.push_back(rrq);
+    off_node_bytes+=bytes;
+  }
+
+  if ( gdest == MPI_UNDEFINED ) {
+    ierr =MPI_Send_init(xmit, bytes, MPI_CHAR,dest,_processor,communicator_halo[commdir],&xrq);
+    assert(ierr==0);
+    list.push_back(xrq);
+    off_node_bytes+=bytes;
+  }
+  return off_node_bytes;
+}
+void CartesianCommunicator::StencilSendToRecvFromPersistentStart(std::vector<CommsRequest_t> &list,int dir)
+{
+  if ( list.size()==0 ) return;
+  int ierr = MPI_Startall(list.size(),&list[0]);
+  assert(ierr==0);
+  if ( CommunicatorPolicy == CommunicatorPolicySequential ) { 
+    this->StencilSendToRecvFromPersistentComplete(list,dir);
+  }
+}
+void CartesianCommunicator::StencilSendToRecvFromPersistentComplete(std::vector<CommsRequest_t> &list,int dir)
+{
+  int nreq=list.size();
+  if (nreq==0) return;
+  // Waitall leaves persistent requests inactive, not freed, so the list is kept
+  std::vector<MPI_Status> status(nreq);
+  int ierr = MPI_Waitall(nreq,&list[0],&status[0]);
+  assert(ierr==0);
+}
+void CartesianCommunicator::StencilSendToRecvFromPersistentFree(std::vector<CommsRequest_t> &list)
+{
+  int finalized;
+  MPI_Finalized(&finalized);   // stencils may outlive Grid_finalize
+  if ( !finalized ) {
+    for(int i=0;i<list.size();i++){
+      MPI_Request_free(&list[i]);
+    }
+  }
+  list.resize(0);
+}
+int CartesianCommunicator::MultipleThreadsSupported(void)
+{
+  int provided;
+  MPI_Query_thread(&provided);
+  return provided == MPI_THREAD_MULTIPLE;
+}
 void CartesianCommunicator::StencilBarrier(void)
 {
   MPI_Barrier  (ShmComm);
@@ -446,6 +529,11 @@ void CartesianCommunicator::BroadcastWorld(int root,void* data, int bytes)
 		      communicator_world);
   assert(ierr==0);
 }
+void CartesianCommunicator::GlobalSumVectorWorld(uint64_t *u,int N)
+{
+  int ierr=MPI_Allreduce(MPI_IN_PLACE,u,N,MPI_UINT64_T,MPI_SUM,communicator_world);
+  assert(ierr==0);
+}
 
 void CartesianCommunicator::AllToAll(int dim,void  *in,void *out,uint64_t words,uint64_t bytes)
 {
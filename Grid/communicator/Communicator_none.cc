@@ -75,6 +75,8 @@ void CartesianCommunicator::GlobalSum(uint64_t &){}
 void CartesianCommunicator::GlobalSumVector(double *,int N){}
 void CartesianCommunicator::GlobalXOR(uint32_t &){}
 void CartesianCommunicator::GlobalXOR(uint64_t &){}
+void CartesianCommunicator::GlobalSumVectorBegin(std::vector<CommsRequest_t> &list,double *,int N){}
+void CartesianCommunicator::GlobalSumVectorComplete(std::vector<CommsRequest_t> &list){}
 
 void CartesianCommunicator::SendRecvPacket(void *xmit,
 					   void *recv,
@@ -122,6 +124,7 @@ int  CartesianCommunicator::RankWorld(void){return 0;}
 void CartesianCommunicator::Barrier(void){}
 void CartesianCommunicator::Broadcast(int root,void* data, int bytes) {}
 void CartesianCommunicator::BroadcastWorld(int root,void* data, int bytes) { }
+void CartesianCommunicator::GlobalSumVectorWorld(uint64_t *u,int N) { }
 int  CartesianCommunicator::RankFromProcessorCoor(Coordinate &coor) {  return 0;}
 void CartesianCommunicator::ProcessorCoorFromRank(int rank, Coordinate &coor){  coor = _processor_coor; }
 void CartesianCommunicator::ShiftedRanks(int dim,int shift,int &source,int &dest)
@@ -159,6 +162,20 @@ void CartesianCommunicator::StencilSendToRecvFromComplete(std::vector<CommsReque
 }
 
 void CartesianCommunicator::StencilBarrier(void){};
+double CartesianCommunicator::StencilSendToRecvFromPersistentInit(std::vector<CommsRequest_t> &list,
+								   void *xmit,
+								   int xmit_to_rank,
+								   void *recv,
+								   int recv_from_rank,
+								   int bytes,int dir)
+{
+  assert(0);
+  return 0.0;
+}
+void CartesianCommunicator::StencilSendToRecvFromPersistentStart(std::vector<CommsRequest_t> &list,int dir){}
+void CartesianCommunicator::StencilSendToRecvFromPersistentComplete(std::vector<CommsRequest_t> &list,int dir){}
+void CartesianCommunicator::StencilSendToRecvFromPersistentFree(std::vector<CommsRequest_t> &list){}
+int  CartesianCommunicator::MultipleThreadsSupported(void) { return 0; }
 
 NAMESPACE_END(Grid);
 
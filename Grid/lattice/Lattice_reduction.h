@@ -30,38 +30,67 @@ Author: paboyle <paboyle@ph.ed.ac.uk>
 
 NAMESPACE_BEGIN(Grid);
 
-//////////////////////////////////////////////////////
-// FIXME this should promote to double and accumulate
-//////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Deterministic reduction engine.
+// Sites are cut into a fixed number of contiguous chunks that does not depend on the thread
+// count. Each chunk accumulates in site order and the chunk partials are then combined by a
+// fixed binary tree, so the result is bit reproducible whatever OMP_NUM_THREADS is.
+// The caller provides the partial buffer (reduceChunks(osites) entries, typically on the stack);
+// the answer is left in partial[0].
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#define GRID_REDUCE_CHUNKS (256)
+
+inline uint64_t reduceChunks(uint64_t osites)
+{
+  return std::max<uint64_t>(1,std::min<uint64_t>(osites,GRID_REDUCE_CHUNKS));
+}
+
+template<class robj,class Accumulate>
+inline void reduceSites(robj *partial,uint64_t osites,Accumulate accumulate)
+{
+  const uint64_t nchunk = reduceChunks(osites);
+  thread_for(c,nchunk,{
+    uint64_t lo = (osites* c   )/nchunk;
+    uint64_t hi = (osites*(c+1))/nchunk;
+    robj s; 
+    s = Zero();
+    for(uint64_t ss=lo;ss<hi;ss++){
+      accumulate(s,ss);
+    }
+    partial[c] = s;
+  });
+  for(uint64_t stride=1;stride<nchunk;stride*=2){
+    for(uint64_t c=0;c+stride<nchunk;c+=2*stride){
+      partial[c] = partial[c] + partial[c+stride];
+    }
+  }
+}
+
+// N accumulators carried through one sweep
+template<class obj,int N> class ReductionArray {
+public:
+  obj v[N];
+  accelerator_inline ReductionArray & operator=(const Zero &z){
+    for(int i=0;i<N;i++) v[i] = Zero();
+    return *this;
+  }
+  friend accelerator_inline ReductionArray operator+(const ReductionArray &a,const ReductionArray &b){
+    ReductionArray ret;
+    for(int i=0;i<N;i++) ret.v[i] = a.v[i] + b.v[i];
+    return ret;
+  }
+};
+
 template<class vobj>
 inline typename vobj::scalar_object sum_cpu(const vobj *arg, Integer osites)
 {
   typedef typename vobj::scalar_object  sobj;
 
-  const int Nsimd = vobj::Nsimd();
-  const int nthread = GridThread::GetThreads();
-
-  Vector<sobj> sumarray(nthread);
-  for(int i=0;i<nthread;i++){
-    sumarray[i]=Zero();
-  }
-  
-  thread_for(thr,nthread, {
-    int nwork, mywork, myoff;
-    nwork = osites;
-    GridThread::GetWork(nwork,thr,mywork,myoff);
-    vobj vvsum=Zero();
-    for(int ss=myoff;ss<mywork+myoff; ss++){
-      vvsum = vvsum + arg[ss];
-    }
-    sumarray[thr]=Reduce(vvsum);
+  Vector<vobj> partial(reduceChunks(osites));
+  reduceSites(&partial[0],osites,[&](vobj &s,uint64_t ss){
+    s = s + arg[ss];
   });
-  
-  sobj ssum=Zero();  // sum across threads
-  for(int i=0;i<nthread;i++){
-    ssum = ssum+sumarray[i];
-  } 
-  
+  sobj ssum = Reduce(partial[0]);
   return ssum;
 }
 template<class vobj>
@@ -125,23 +154,135 @@ inline ComplexD innerProduct(const Lattice<vobj> &left,const Lattice<vobj> &righ
   // Need a sumD that sums in double
   nrm = TensorRemove(sumD_gpu(inner_tmp_v,sites));  
 #else
-  // CPU 
+  // CPU ; single pass, no site sized temporary
   typedef decltype(innerProductD(left_v[0],right_v[0])) inner_t;
-  Vector<inner_t> inner_tmp(sites);
-  auto inner_tmp_v = &inner_tmp[0];
-  
-  accelerator_for( ss, sites, nsimd,{
-      auto x_l = left_v[ss];
-      auto y_l = right_v[ss];
-      inner_tmp_v[ss]=innerProductD(x_l,y_l);
-  })
-  nrm = TensorRemove(sum(inner_tmp_v,sites));
+  inner_t partial[GRID_REDUCE_CHUNKS];
+  reduceSites(partial,sites,[&](inner_t &s,uint64_t ss){
+    s = s + innerProductD(left_v[ss],right_v[ss]);
+  });
+  nrm = TensorRemove(Reduce(partial[0]));
 #endif
   grid->GlobalSum(nrm);
 
   return nrm;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Fused inner products over one sweep of memory and a single global sum:
+//   ip[i] = <left[i],right[i]> , i < N
+// Fields shared between pairs (e.g. <p,Ap>, <r,r>, <r,Ap>) are streamed from memory once.
+// The Local variant omits the global sum so it may be posted non-blocking by the caller.
+////////////////////////////////////////////////////////////////////////////////////////////////
+template<int N,class vobj>
+inline void innerProductBatchLocal(ComplexD *ip,const Lattice<vobj> * const *left,const Lattice<vobj> * const *right)
+{
+  GridBase *grid = left[0]->Grid();
+  const uint64_t sites = grid->oSites();
+
+  const vobj *l_p[N];
+  const vobj *r_p[N];
+  for(int i=0;i<N;i++){
+    conformable(left[i]->Grid(),grid);
+    conformable(right[i]->Grid(),grid);
+    auto l_v = left[i]->View();
+    auto r_v = right[i]->View();
+    l_p[i] = &l_v[0];
+    r_p[i] = &r_v[0];
+  }
+
+  typedef decltype(innerProductD(l_p[0][0],r_p[0][0])) inner_t;
+  typedef ReductionArray<inner_t,N> batch_t;
+  batch_t partial[GRID_REDUCE_CHUNKS];
+  reduceSites(partial,sites,[&](batch_t &s,uint64_t ss){
+    for(int i=0;i<N;i++){
+      s.v[i] = s.v[i] + innerProductD(l_p[i][ss],r_p[i][ss]);
+    }
+  });
+  for(int i=0;i<N;i++){
+    ip[i] = TensorRemove(Reduce(partial[0].v[i]));
+  }
+}
+
+template<int N,class vobj>
+inline void innerProductBatch(ComplexD *ip,const Lattice<vobj> * const *left,const Lattice<vobj> * const *right)
+{
+#ifdef GRID_NVCC
+  for(int i=0;i<N;i++) ip[i] = innerProduct(*left[i],*right[i]);
+#else
+  innerProductBatchLocal<N>(ip,left,right);
+  left[0]->Grid()->GlobalSumVector(ip,N);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Runtime sized variant for block Krylov methods (Gram matrices of an s-vector basis).
+// Same chunking and tree as reduceSites, with the npair accumulators per chunk on the heap.
+////////////////////////////////////////////////////////////////////////////////////////////////
+template<class vobj>
+inline void innerProductBatchLocal(ComplexD *ip,
+				   const std::vector<const Lattice<vobj> *> &left,
+				   const std::vector<const Lattice<vobj> *> &right)
+{
+  const int npair = left.size();
+  assert(right.size()==npair);
+  if ( npair==0 ) return;
+
+  GridBase *grid = left[0]->Grid();
+  const uint64_t sites = grid->oSites();
+
+  std::vector<const vobj *> l_p(npair);
+  std::vector<const vobj *> r_p(npair);
+  for(int i=0;i<npair;i++){
+    conformable(left[i]->Grid(),grid);
+    conformable(right[i]->Grid(),grid);
+    auto l_v = left[i]->View();
+    auto r_v = right[i]->View();
+    l_p[i] = &l_v[0];
+    r_p[i] = &r_v[0];
+  }
+  const vobj * const *lp = &l_p[0];
+  const vobj * const *rp = &r_p[0];
+
+  typedef decltype(innerProductD(vobj(),vobj())) inner_t;
+  const uint64_t nchunk = reduceChunks(sites);
+  Vector<inner_t> partial(nchunk*npair);
+  inner_t *part = &partial[0];
+  thread_for(c,nchunk,{
+    uint64_t lo = (sites* c   )/nchunk;
+    uint64_t hi = (sites*(c+1))/nchunk;
+    inner_t *s = &part[c*npair];
+    for(int i=0;i<npair;i++) s[i] = Zero();
+    for(uint64_t ss=lo;ss<hi;ss++){
+      for(int i=0;i<npair;i++){
+	s[i] = s[i] + innerProductD(lp[i][ss],rp[i][ss]);
+      }
+    }
+  });
+  for(uint64_t stride=1;stride<nchunk;stride*=2){
+    for(uint64_t c=0;c+stride<nchunk;c+=2*stride){
+      for(int i=0;i<npair;i++){
+	part[c*npair+i] = part[c*npair+i] + part[(c+stride)*npair+i];
+      }
+    }
+  }
+  for(int i=0;i<npair;i++){
+    ip[i] = TensorRemove(Reduce(part[i]));
+  }
+}
+
+template<class vobj>
+inline void innerProductBatch(ComplexD *ip,
+			      const std::vector<const Lattice<vobj> *> &left,
+			      const std::vector<const Lattice<vobj> *> &right)
+{
+#ifdef GRID_NVCC
+  for(int i=0;i<left.size();i++) ip[i] = innerProduct(*left[i],*right[i]);
+#else
+  innerProductBatchLocal(ip,left,right);
+  if ( left.size() ) left[0]->Grid()->GlobalSumVector(ip,left.size());
+#endif
+}
+
 /////////////////////////
 // Fast axpby_norm
 // z = a x + b y
@@ -188,18 +329,16 @@ axpby_norm_fast(Lattice<vobj> &z,sobj a,sobj b,const Lattice<vobj> &x,const Latt
 
   nrm = real(TensorRemove(sumD_gpu(inner_tmp_v,sites)));
 #else
-  // CPU 
+  // CPU ; single pass, no site sized temporary
   typedef decltype(innerProductD(x_v[0],y_v[0])) inner_t;
-  Vector<inner_t> inner_tmp(sites);
-  auto inner_tmp_v = &inner_tmp[0];
-  
-  accelerator_for( ss, sites, nsimd,{
-      auto tmp = a*x_v(ss)+b*y_v(ss);
-      inner_tmp_v[ss]=innerProductD(tmp,tmp);
-      z_v[ss]=tmp;
+  inner_t partial[GRID_REDUCE_CHUNKS];
+  reduceSites(partial,sites,[&](inner_t &s,uint64_t ss){
+    auto tmp = a*x_v(ss)+b*y_v(ss);
+    s = s + innerProductD(tmp,tmp);
+    z_v[ss]=tmp;
   });
   // Already promoted to double
-  nrm = real(TensorRemove(sum(inner_tmp_v,sites)));
+  nrm = real(TensorRemove(Reduce(partial[0])));
 #endif
   grid->GlobalSum(nrm);
   return nrm; 
@@ -120,6 +120,121 @@ void fillScalar(ComplexD &s,distribution &dist,generator &gen)
   s.imag(dist(gen));
 }
   
+//////////////////////////////////////////////////////////////
+// Counter based generator; Philox4x32-10 of
+// J. Salmon et al, "Parallel random numbers: as easy as 1, 2, 3", SC11.
+//
+// Stateless: ten rounds of a keyed bijection on a 128 bit counter.
+// The parallel RNG keys it with the seed and counts with
+// (global site, fill call, block) so a field is the same whatever
+// the MPI, SIMD and thread decomposition, and no per site engine
+// needs to be stored or seeded.
+//////////////////////////////////////////////////////////////
+class GridPhilox {
+public:
+  static const uint32_t M0 = 0xD2511F53;
+  static const uint32_t M1 = 0xCD9E8D57;
+  static const uint32_t W0 = 0x9E3779B9;
+  static const uint32_t W1 = 0xBB67AE85;
+  static inline void Generate(uint32_t out[4],const uint32_t ctr[4],const uint32_t key[2])
+  {
+    uint32_t c0=ctr[0],c1=ctr[1],c2=ctr[2],c3=ctr[3];
+    uint32_t k0=key[0],k1=key[1];
+    for(int r=0;r<10;r++){
+      uint64_t p0 = (uint64_t)M0*c0;
+      uint64_t p1 = (uint64_t)M1*c2;
+      c0 = (uint32_t)(p1>>32)^c1^k0;
+      c1 = (uint32_t)p1;
+      c2 = (uint32_t)(p0>>32)^c3^k1;
+      c3 = (uint32_t)p0;
+      k0+=W0;
+      k1+=W1;
+    }
+    out[0]=c0; out[1]=c1; out[2]=c2; out[3]=c3;
+  }
+  // Blocks 0..nblock-1 of n streams at once, counters (block, draw, site[l]).
+  // Block b of stream l is lane j=b*n+l of a structure of arrays, word w at
+  // out[w*nblock*n+j], so the rounds run across SIMD registers.
+  static inline void GenerateLanes(uint32_t *out,int nblock,int n,const uint64_t *site,uint32_t draw,const uint32_t key[2])
+  {
+    const int N = nblock*n;
+    uint32_t * __restrict__ c0 = out;
+    uint32_t * __restrict__ c1 = out+N;
+    uint32_t * __restrict__ c2 = out+2*N;
+    uint32_t * __restrict__ c3 = out+3*N;
+    for(int b=0;b<nblock;b++){
+      for(int l=0;l<n;l++){
+	int j=b*n+l;
+	c0[j]=b;
+	c1[j]=draw;
+	c2[j]=(uint32_t)site[l];
+	c3[j]=(uint32_t)(site[l]>>32);
+      }
+    }
+    uint32_t k0=key[0],k1=key[1];
+    for(int r=0;r<10;r++){
+      for(int j=0;j<N;j++){
+	uint64_t p0 = (uint64_t)M0*c0[j];
+	uint64_t p1 = (uint64_t)M1*c2[j];
+	c0[j] = (uint32_t)(p1>>32)^c1[j]^k0;
+	c1[j] = (uint32_t)p1;
+	c2[j] = (uint32_t)(p0>>32)^c3[j]^k1;
+	c3[j] = (uint32_t)p0;
+      }
+      k0+=W0;
+      k1+=W1;
+    }
+  }
+};
+
+//////////////////////////////////////////////////////////////
+// One site's stream for one fill call; models UniformRandomBitGenerator
+// so the std:: distributions draw from it exactly as from an engine.
+// Optionally the first npre blocks come from a GenerateLanes buffer,
+// lane l of n, and only the blocks past them are generated one by one.
+//////////////////////////////////////////////////////////////
+class GridPhiloxStream {
+public:
+  typedef uint32_t result_type;
+  static constexpr result_type min(void) { return 0; }
+  static constexpr result_type max(void) { return 0xFFFFFFFF; }
+
+  GridPhiloxStream(const uint32_t *key,uint64_t site,uint32_t draw,
+		   const uint32_t *pre=nullptr,int npre=0,int l=0,int n=1) : _used(4) {
+    _key[0]=key[0];
+    _key[1]=key[1];
+    _ctr[0]=0;
+    _ctr[1]=draw;
+    _ctr[2]=(uint32_t)site;
+    _ctr[3]=(uint32_t)(site>>32);
+    _pre  = pre ? pre+l : nullptr;
+    _npre = npre;
+    _n    = n;
+  }
+  inline result_type operator()(void) {
+    if ( _used==4 ) {
+      if ( _ctr[0] < (uint32_t)_npre ) {
+	const uint32_t *p = _pre+_ctr[0]*_n;
+	const int N = _npre*_n;
+	for(int w=0;w<4;w++) _out[w] = p[w*N];
+      } else {
+	GridPhilox::Generate(_out,_ctr,_key);
+      }
+      _ctr[0]++;
+      _used=0;
+    }
+    return _out[_used++];
+  }
+private:
+  uint32_t _key[2];
+  uint32_t _ctr[4];
+  uint32_t _out[4];
+  int _used;
+  const uint32_t *_pre;
+  int _npre;
+  int _n;
+};
+
 class GridRNGbase {
 public:
   // One generator per site.
@@ -345,15 +460,66 @@ private:
   GridBase *_grid;
   unsigned int _vol;
 
+  ////////////////////////////////////////////////
+  // Counter based mode: seed key, fill call count
+  // and the global index of each local generator
+  ////////////////////////////////////////////////
+  int _counter;
+  uint32_t _key[2];
+  uint32_t _draw;
+  std::vector<uint64_t> _gsite;
+
 public:
+  ////////////////////////////////////////////////
+  // Philox in place of one engine per site, --rng-counter.
+  // Fixed at construction of each parallel RNG.
+  ////////////////////////////////////////////////
+  static int CounterBased;
+  static const uint32_t CounterStateTag = 0x5048494c; // "PHIL"
+
   GridBase *Grid(void) const { return _grid; }
   int generator_idx(int os,int is) {
     return is*_grid->oSites()+os;
   }
+  int IsCounterBased(void) const { return _counter; }
+  ////////////////////////////////////////////////
+  // Lexicographic global index of a local generator,
+  // without visiting the global volume
+  ////////////////////////////////////////////////
+  uint64_t GlobalIndex(int os,int is) {
+    Coordinate gcoor;
+    _grid->RankIndexToGlobalCoor(_grid->ThisRank(),os,is,gcoor);
+    uint64_t gidx=0;
+    uint64_t mult=1;
+    for(int mu=0;mu<_grid->_ndimension;mu++) {
+      gidx+=mult*gcoor[mu];
+      mult*=_grid->_gdimensions[mu];
+    }
+    return gidx;
+  }
 
   GridParallelRNG(GridBase *grid) : GridRNGbase() {
     _grid = grid;
     _vol  =_grid->iSites()*_grid->oSites();
+    _counter = CounterBased;
+    _time_counter = 0;
+
+    if ( _counter ) {
+      // No per site state; a single copy of each distribution serves as prototype
+      _key[0]=_key[1]=0;
+      _draw = 0;
+      _gsite.resize(_vol);
+      thread_for( os, _grid->oSites(), {
+	for(int is=0;is<_grid->iSites();is++){
+	  _gsite[generator_idx(os,is)] = GlobalIndex(os,is);
+	}
+      });
+      _uniform.resize(1,std::uniform_real_distribution<RealD>{0,1});
+      _gaussian.resize(1,std::normal_distribution<RealD>(0.0,1.0) );
+      _bernoulli.resize(1,std::discrete_distribution<int32_t>{1,1});
+      _uid.resize(1,std::uniform_int_distribution<uint32_t>() );
+      return;
+    }
 
     _generators.resize(_vol);
     _uniform.resize(_vol,std::uniform_real_distribution<RealD>{0,1});
@@ -362,6 +528,54 @@ public:
     _uid.resize(_vol,std::uniform_int_distribution<uint32_t>() );
   }
 
+  ////////////////////////////////////////////////////////////////////////
+  // Counter based fill. Each lane draws from its own Philox stream,
+  // counter (block, fill call, global site), straight into its SIMD slot;
+  // word idx of lane si in a vobj is scalar idx*Nsimd+si. The blocks a
+  // uniform fill consumes, two words per real, are generated for all lanes of
+  // a site together; draws past them (gaussian rejections) one lane at a time.
+  ////////////////////////////////////////////////////////////////////////
+  template <class vobj,class distribution> inline void fillCounter(Lattice<vobj> &l,std::vector<distribution> &dist){
+
+    typedef typename vobj::scalar_object scalar_object;
+    typedef typename vobj::scalar_type scalar_type;
+
+    int multiplicity = RNGfillable_general(_grid, l.Grid());
+    int Nsimd  = _grid->Nsimd();
+    int osites = _grid->oSites();
+    int words  = sizeof(scalar_object) / sizeof(scalar_type);
+    int reals  = is_complex<scalar_type>::value ? 2 : 1;
+    int nblock = (2*reals*words*multiplicity+3)/4;
+
+    // Every rank makes the same sequence of fill calls
+    uint32_t draw = _draw++;
+    const uint32_t *key = _key;
+    const uint64_t *gsite = &_gsite[0];
+    const distribution &proto = dist[0];
+
+    auto l_v = l.View();
+    thread_region
+    {
+      std::vector<uint32_t> pre(4*nblock*Nsimd);
+      std::vector<uint64_t> site(Nsimd);
+      thread_for_in_region( ss, osites, {
+	for (int si = 0; si < Nsimd; si++) site[si] = gsite[generator_idx(ss,si)];
+	GridPhilox::GenerateLanes(&pre[0],nblock,Nsimd,&site[0],draw,key);
+	for (int si = 0; si < Nsimd; si++) {
+	  GridPhiloxStream gen(key,site[si],draw,&pre[0],nblock,si,Nsimd);
+	  distribution d(proto);
+	  for (int m = 0; m < multiplicity; m++) {
+	    int sm = multiplicity * ss + m;
+	    scalar_type *pointer = (scalar_type *)&l_v[sm];
+	    d.reset();
+	    for (int idx = 0; idx < words; idx++) 
+	      fillScalar(pointer[idx*Nsimd+si], d, gen);
+	  }
+	}
+      });
+    }
+  }
+
   template <class vobj,class distribution> inline void fill(Lattice<vobj> &l,std::vector<distribution> &dist){
 
     typedef typename vobj::scalar_object scalar_object;
@@ -370,6 +584,12 @@ public:
 
     double inner_time_counter = usecond();
 
+    if ( _counter ) {
+      fillCounter(l,dist);
+      _time_counter += usecond()- inner_time_counter;
+      return;
+    }
+
     int multiplicity = RNGfillable_general(_grid, l.Grid()); // l has finer or same grid
     int Nsimd  = _grid->Nsimd();  // guaranteed to be the same for l.Grid() too
     int osites = _grid->oSites();  // guaranteed to be <= l.Grid()->oSites() by a factor multiplicity
@@ -414,6 +634,13 @@ public:
 
     std::seed_seq source(seeds.begin(),seeds.end());
 
+    if ( _counter ) {
+      // Nothing per site to seed; the key is all there is
+      source.generate(_key,_key+2);
+      _draw = 0;
+      return;
+    }
+
     RngEngine master_engine(source);
 
 #ifdef RNG_FAST_DISCARD
@@ -425,22 +652,12 @@ public:
     // in principle this is possible
     ////////////////////////////////////////////////
 
-    // Everybody loops over global volume.
-    thread_for( gidx, _grid->_gsites, {
-	// Where is it?
-	int rank;
-	int o_idx;
-	int i_idx;
-
-	Coordinate gcoor;
-	_grid->GlobalIndexToGlobalCoor(gidx,gcoor);
-	_grid->GlobalCoorToRankIndex(rank,o_idx,i_idx,gcoor);
-	
-	// If this is one of mine we take it
-	if( rank == _grid->ThisRank() ){
+    // Each rank visits only its own sites, skipping by their global index
+    thread_for( o_idx, _grid->oSites(), {
+	for(int i_idx=0;i_idx<_grid->iSites();i_idx++){
 	  int l_idx=generator_idx(o_idx,i_idx);
 	  _generators[l_idx] = master_engine;
-	  Skip(_generators[l_idx],gidx); // Skip to next RNG sequence
+	  Skip(_generators[l_idx],GlobalIndex(o_idx,i_idx)); // Skip to next RNG sequence
 	}
     });
 #else 
@@ -486,6 +703,40 @@ public:
     std::cout << GridLogMessage << "Time spent in the fill() routine by GridParallelRNG: "<< _time_counter/1e3 << " ms" << std::endl;
   }
 
+  ////////////////////////////////////////////////////////////////////////
+  // Checkpoint state. A counter based RNG writes {tag,key,draw} into
+  // every site's slot so files keep the engine layout, size and checksums;
+  // which generator wrote a file is checked on read.
+  ////////////////////////////////////////////////////////////////////////
+  void GetState(std::vector<RngStateType> & saved,int gen) {
+    if ( !_counter ) {
+      GridRNGbase::GetState(saved,gen);
+      return;
+    }
+    saved.resize(RngStateCount);
+    for(int i=0;i<RngStateCount;i++) saved[i]=0;
+    saved[0] = CounterStateTag;
+    saved[1] = _key[0];
+    saved[2] = _key[1];
+    saved[3] = _draw;
+  }
+  void SetState(std::vector<RngStateType> & saved,int gen){
+    if ( !_counter ) {
+      GridRNGbase::SetState(saved,gen);
+      return;
+    }
+    assert(saved.size()==RngStateCount);
+    if ( saved[0] != CounterStateTag ) {
+      std::cout << GridLogError << "GridParallelRNG: state was not written by a counter based RNG (--rng-counter)"<<std::endl;
+      assert(0);
+    }
+    if ( gen==0 ) { // all sites carry the same state
+      _key[0] = saved[1];
+      _key[1] = saved[2];
+      _draw   = saved[3];
+    }
+  }
+
 
   ////////////////////////////////////////////////////////////////////////
   // Support for rigorous test of RNG's
@@ -502,7 +753,13 @@ public:
 
     // draw
     int l_idx=generator_idx(o_idx,i_idx);
-    if( rank == _grid->ThisRank() ){
+    if ( _counter ) {
+      uint32_t draw = _draw++;
+      if( rank == _grid->ThisRank() ){
+	GridPhiloxStream gen(_key,_gsite[l_idx],draw);
+	the_number = _uid[0](gen);
+      }
+    } else if( rank == _grid->ThisRank() ){
       the_number = _uid[l_idx](_generators[l_idx]);
     }
       
@@ -1,3 +1,8 @@
 #include <Grid/GridCore.h>
 
 int Grid::BinaryIO::latticeWriteMaxRetry = -1;
+int Grid::BinaryIO::ioAggregators = 0;
+uint64_t Grid::BinaryIO::ioStripe = 0;
+int Grid::BinaryIO::ioMmap = 0;
+uint64_t Grid::BinaryIO::ioMmapWindow = 256ULL<<20;
+uint64_t Grid::CompressedIO::ChunkSites = 4096;
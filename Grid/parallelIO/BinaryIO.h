@@ -40,6 +40,11 @@
 
 #include <arpa/inet.h>
 #include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 NAMESPACE_BEGIN(Grid);
 
@@ -80,6 +85,149 @@ inline void removeWhitespace(std::string &key)
 class BinaryIO {
  public:
   static int latticeWriteMaxRetry;
+  static int      ioAggregators; // --io-aggregators; ranks per node doing POSIX I/O, 0 for MPI-IO/per rank streams
+  static uint64_t ioStripe;      // --io-stripe; aggregated requests aligned to and at most this many bytes
+  static int      ioMmap;        // --io-mmap; readLatticeObject maps the file, no staging buffers
+  static uint64_t ioMmapWindow;  // --io-mmap-window; bytes of file mapped at once by the mmap reader
+
+#ifdef USE_MPI_IO
+  /////////////////////////////////////////////////////////////////////////////
+  // Aggregated POSIX I/O.
+  // The ranks of each node split into ioAggregators groups over a node local
+  // communicator; the first rank of a group gathers the others' data and file
+  // extents, sorts the extents into file order and issues pwritev/preadv
+  // straight from the gathered buffers, coalescing adjacent extents and
+  // breaking requests at multiples of ioStripe. A few large aligned requests
+  // per node replace one open and seek per rank.
+  // Each rank's data are fileoffs.size() rows of rowbytes, row r at fileoffs[r].
+  /////////////////////////////////////////////////////////////////////////////
+  static inline void PosixIOv(int fd,std::vector<struct iovec> &iov,uint64_t off,int write,const std::string &file)
+  {
+    int i=0;
+    while ( i<iov.size() ) {
+      int n = std::min((int)iov.size()-i,(int)IOV_MAX);
+      ssize_t ret = write ? pwritev(fd,&iov[i],n,off) : preadv(fd,&iov[i],n,off);
+      if ( ret <= 0 ) {
+	std::cout << GridLogError << "BinaryIO: aggregated " << (write ? "write " : "read ")
+		  << file << " failed at offset " << off << " : " << strerror(errno) << std::endl;
+	MPI_Abort(MPI_COMM_WORLD,1);
+      }
+      off += ret;
+      // step over what completed; a short transfer leaves part of an iovec
+      while ( (i<iov.size()) && (ret >= (ssize_t)iov[i].iov_len) ) { ret -= iov[i].iov_len; i++; }
+      if ( ret ) { 
+	iov[i].iov_base = (char *)iov[i].iov_base + ret;
+	iov[i].iov_len -= ret;
+      }
+    }
+  }
+  static inline void AggregatorIO(GridBase *grid,void *data,uint64_t rowbytes,std::vector<uint64_t> &fileoffs,
+				  const std::string &file,int write,int truncate)
+  {
+    MPI_Comm node,group;
+    int noderank,nodesize,grouprank,groupsize;
+    MPI_Comm_split_type(grid->communicator,MPI_COMM_TYPE_SHARED,grid->ThisRank(),MPI_INFO_NULL,&node);
+    MPI_Comm_rank(node,&noderank);
+    MPI_Comm_size(node,&nodesize);
+    int naggr  = std::min(std::max(ioAggregators,1),nodesize);
+    int colour = (int)(((int64_t)noderank*naggr)/nodesize);
+    MPI_Comm_split(node,colour,noderank,&group);
+    MPI_Comm_rank(group,&grouprank);
+    MPI_Comm_size(group,&groupsize);
+
+    const int tag = 0x5a;
+    const uint64_t maxmsg = 1UL<<30; 
+    auto sendBytes = [&](void *p,uint64_t bytes,int to) {
+      char *c=(char *)p;
+      do { int n = std::min(bytes,maxmsg); MPI_Send(c,n,MPI_BYTE,to,tag,group); c+=n; bytes-=n; } while (bytes);
+    };
+    auto recvBytes = [&](void *p,uint64_t bytes,int from) {
+      char *c=(char *)p;
+      do { int n = std::min(bytes,maxmsg); MPI_Recv(c,n,MPI_BYTE,from,tag,group,MPI_STATUS_IGNORE); c+=n; bytes-=n; } while (bytes);
+    };
+
+    if ( truncate && grid->IsBoss() ) { 
+      int fd = ::open(file.c_str(),O_WRONLY|O_CREAT|O_TRUNC,0644);
+      if ( fd<0 ) {
+	std::cout << GridLogError << "BinaryIO: cannot create " << file << " : " << strerror(errno) << std::endl;
+	MPI_Abort(MPI_COMM_WORLD,1);
+      }
+      ::close(fd);
+    }
+    grid->Barrier();
+
+    uint64_t nrow = fileoffs.size();
+    if ( grouprank != 0 ) { 
+      sendBytes(&nrow,sizeof(nrow),0);
+      sendBytes(&fileoffs[0],nrow*sizeof(uint64_t),0);
+      if ( write ) sendBytes(data,nrow*rowbytes,0);
+      else         recvBytes(data,nrow*rowbytes,0);
+    } else { 
+      std::vector<std::vector<uint64_t> > offs(groupsize);
+      std::vector<std::vector<char> >     store(groupsize);
+      std::vector<char *>                 bufs(groupsize);
+      offs[0] = fileoffs;
+      bufs[0] = (char *)data;
+      for(int m=1;m<groupsize;m++){
+	uint64_t n;
+	recvBytes(&n,sizeof(n),m);
+	offs[m].resize(n);
+	store[m].resize(n*rowbytes);
+	bufs[m] = &store[m][0];
+	recvBytes(&offs[m][0],n*sizeof(uint64_t),m);
+	if ( write ) recvBytes(bufs[m],n*rowbytes,m);
+      }
+
+      std::vector<std::pair<uint64_t,char *> > rows;
+      for(int m=0;m<groupsize;m++){
+	for(uint64_t r=0;r<offs[m].size();r++){
+	  rows.push_back(std::make_pair(offs[m][r],bufs[m]+r*rowbytes));
+	}
+      }
+      std::sort(rows.begin(),rows.end());
+
+      int fd = write ? ::open(file.c_str(),O_WRONLY|O_CREAT,0644) : ::open(file.c_str(),O_RDONLY);
+      if ( fd<0 ) {
+	std::cout << GridLogError << "BinaryIO: cannot open " << file << " : " << strerror(errno) << std::endl;
+	MPI_Abort(MPI_COMM_WORLD,1);
+      }
+
+      std::vector<struct iovec> iov;
+      uint64_t start=0, pos=0;
+      for(auto &row : rows) { 
+	if ( iov.size() && (row.first != pos) ) { 
+	  PosixIOv(fd,iov,start,write,file);
+	  iov.resize(0);
+	}
+	if ( iov.size()==0 ) start = pos = row.first;
+	char *ptr = row.second;
+	uint64_t left = rowbytes;
+	while ( left ) {
+	  uint64_t take = left;
+	  if ( ioStripe ) take = std::min(take,(pos/ioStripe+1)*ioStripe-pos);
+	  struct iovec v;
+	  v.iov_base = ptr;
+	  v.iov_len  = take;
+	  iov.push_back(v);
+	  ptr += take; pos += take; left -= take;
+	  if ( ioStripe && (pos%ioStripe==0) ) { 
+	    PosixIOv(fd,iov,start,write,file);
+	    iov.resize(0);
+	    start = pos;
+	  }
+	}
+      }
+      if ( iov.size() ) PosixIOv(fd,iov,start,write,file);
+      ::close(fd);
+
+      if ( !write ) { 
+	for(int m=1;m<groupsize;m++) sendBytes(bufs[m],offs[m].size()*rowbytes,m);
+      }
+    }
+    MPI_Comm_free(&group);
+    MPI_Comm_free(&node);
+  }
+#endif
 
   /////////////////////////////////////////////////////////////////////////////
   // more byte manipulation helpers
@@ -186,6 +334,87 @@ class BinaryIO {
     }
   }
 
+  /////////////////////////////////////////////////////////////////////////////
+  // Endian conversion and both checksums fused into one threaded pass, each
+  // site's words swapped while in cache. Nersc sums host order words; the SciDAC
+  // crc32 sees file order bytes, so reads checksum before swapping and writes
+  // after. Bit identical to ScidacChecksum, NerscChecksum and *_v in sequence.
+  /////////////////////////////////////////////////////////////////////////////
+  static inline int HostBigEndian(void) { return htonl(1)==1; }
+
+  template<class fobj> static inline void EndianChecksumSite(fobj *site,int wordsize,int swap,int read,int global_site,
+							     uint32_t &nersc_csum,uint32_t &scidac_csuma,uint32_t &scidac_csumb)
+  {
+    const uint64_t size32 = sizeof(fobj) / sizeof(uint32_t);
+    const uint64_t size64 = sizeof(fobj) / sizeof(uint64_t);
+    uint32_t * site_buf = (uint32_t *)site;
+    uint64_t * site_b64 = (uint64_t *)site;
+
+    uint32_t gsite29   = global_site%29;
+    uint32_t gsite31   = global_site%31;
+
+    uint32_t site_crc=0;
+    if ( read ) site_crc = crc32(0,(unsigned char *)site_buf,sizeof(fobj));
+    else for (uint64_t j = 0; j < size32; j++) nersc_csum += site_buf[j];
+
+    if ( swap ) {
+      if ( wordsize==4 ) for(uint64_t j=0;j<size32;j++) site_buf[j] = __builtin_bswap32(site_buf[j]);
+      else               for(uint64_t j=0;j<size64;j++) site_b64[j] = __builtin_bswap64(site_b64[j]);
+    }
+
+    if ( read ) for (uint64_t j = 0; j < size32; j++) nersc_csum += site_buf[j];
+    else site_crc = crc32(0,(unsigned char *)site_buf,sizeof(fobj));
+
+    scidac_csuma ^= site_crc<<gsite29 | site_crc>>(32-gsite29);
+    scidac_csumb ^= site_crc<<gsite31 | site_crc>>(32-gsite31);
+  }
+
+  template<class fobj> static inline void EndianChecksum(GridBase *grid,std::vector<fobj> &fbuf,
+							 int wordsize,int swap,int read,
+							 uint32_t &nersc_csum,uint32_t &scidac_csuma,uint32_t &scidac_csumb)
+  {
+    int nd = grid->_ndimension;
+
+    uint64_t lsites              =grid->lSites();
+    if (fbuf.size()==1) {
+      lsites=1;
+    }
+    Coordinate local_vol   =grid->LocalDimensions();
+    Coordinate local_start =grid->LocalStarts();
+    Coordinate global_vol  =grid->FullDimensions();
+
+    assert( (wordsize==4) || (wordsize==8) );
+    if ( wordsize==8 ) assert(sizeof(fobj)%sizeof(uint64_t)==0);
+
+    thread_region
+    { 
+      Coordinate coor(nd);
+      uint32_t nersc_csum_thr=0;
+      uint32_t scidac_csuma_thr=0;
+      uint32_t scidac_csumb_thr=0;
+
+      thread_for_in_region( local_site, lsites, 
+      {
+	int global_site;
+	Lexicographic::CoorFromIndex(coor,local_site,local_vol);
+	for(int d=0;d<nd;d++) {
+	  coor[d] = coor[d]+local_start[d];
+	}
+	Lexicographic::IndexFromCoor(coor,global_site,global_vol);
+
+	EndianChecksumSite(&fbuf[local_site],wordsize,swap,read,global_site,
+			   nersc_csum_thr,scidac_csuma_thr,scidac_csumb_thr);
+      });
+
+      thread_critical
+      {
+	nersc_csum  += nersc_csum_thr;
+	scidac_csuma^= scidac_csuma_thr;
+	scidac_csumb^= scidac_csumb_thr;
+      }
+    }
+  }
+
   // Network is big endian
   static inline void htobe32_v(void *file_object,uint32_t bytes){ be32toh_v(file_object,bytes);} 
   static inline void htobe64_v(void *file_object,uint32_t bytes){ be64toh_v(file_object,bytes);} 
@@ -344,6 +573,34 @@ class BinaryIO {
     int ieee64    = (format == std::string("IEEE64"));
     assert(ieee64||ieee32|ieee64big||ieee32big);
     assert((ieee64+ieee32+ieee64big+ieee32big)==1);
+    int wordsize = (ieee32||ieee32big) ? 4 : 8;
+    int swap     = (ieee32big||ieee64big) ? !HostBigEndian() : HostBigEndian();
+    //////////////////////////////////////////////////////////////////////////////
+    // Aggregated I/O: file extents of each row of the local array
+    //////////////////////////////////////////////////////////////////////////////
+    int aggregate = 0;
+#ifdef USE_MPI_IO
+    aggregate = (ioAggregators > 0) && !(control & BINARYIO_MASTER_APPEND);
+    int truncate  = (offset == 0) && !((control & BINARYIO_LEXICOGRAPHIC) && (nrank > 1));
+    uint64_t rowbytes = lsites*sizeof(fobj);
+    std::vector<uint64_t> fileoffs(1,offset+myrank*lsites*sizeof(fobj));
+    if ( aggregate && (control & BINARYIO_LEXICOGRAPHIC) ) {
+      uint64_t nrow = lsites/lLattice[0];
+      rowbytes = lLattice[0]*sizeof(fobj);
+      fileoffs.resize(nrow);
+      thread_for(r,nrow,{
+	Coordinate lcoor(ndim);
+	Lexicographic::CoorFromIndex(lcoor,r*lLattice[0],lLattice);
+	uint64_t gidx=0;
+	uint64_t mult=1;
+	for(int d=0;d<ndim;d++){
+	  gidx += mult*(gStart[d]+lcoor[d]);
+	  mult *= gLattice[d];
+	}
+	fileoffs[r] = offset+gidx*sizeof(fobj);
+      });
+    }
+#endif
     //////////////////////////////////////////////////////////////////////////////
     // Do the I/O
     //////////////////////////////////////////////////////////////////////////////
@@ -351,7 +608,14 @@ class BinaryIO {
 
       timer.Start();
 
-      if ( (control & BINARYIO_LEXICOGRAPHIC) && (nrank > 1) ) {
+      if ( aggregate ) { 
+#ifdef USE_MPI_IO
+	std::cout<< GridLogMessage<<"IOobject: aggregated read I/O "<< file<< std::endl;
+	AggregatorIO(grid,(void *)&iodata[0],rowbytes,fileoffs,file,0,0);
+	MPI_Type_free(&fileArray);
+	MPI_Type_free(&localArray);
+#endif
+      } else if ( (control & BINARYIO_LEXICOGRAPHIC) && (nrank > 1) ) {
 #ifdef USE_MPI_IO
 	std::cout<< GridLogMessage<<"IOobject: MPI read I/O "<< file<< std::endl;
 	ierr=MPI_File_open(grid->communicator,(char *) file.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);    assert(ierr==0);
@@ -385,30 +649,28 @@ class BinaryIO {
       grid->Barrier();
 
       bstimer.Start();
-      ScidacChecksum(grid,iodata,scidac_csuma,scidac_csumb);
-      if (ieee32big) be32toh_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      if (ieee32)    le32toh_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      if (ieee64big) be64toh_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      if (ieee64)    le64toh_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      NerscChecksum(grid,iodata,nersc_csum);
+      EndianChecksum(grid,iodata,wordsize,swap,1,nersc_csum,scidac_csuma,scidac_csumb);
       bstimer.Stop();
     }
     
     if ( control & BINARYIO_WRITE ) { 
 
       bstimer.Start();
-      NerscChecksum(grid,iodata,nersc_csum);
-      if (ieee32big) htobe32_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      if (ieee32)    htole32_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      if (ieee64big) htobe64_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      if (ieee64)    htole64_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      ScidacChecksum(grid,iodata,scidac_csuma,scidac_csumb);
+      EndianChecksum(grid,iodata,wordsize,swap,0,nersc_csum,scidac_csuma,scidac_csumb);
       bstimer.Stop();
 
       grid->Barrier();
 
       timer.Start();
-      if ( (control & BINARYIO_LEXICOGRAPHIC) && (nrank > 1) ) {
+      if ( aggregate ) { 
+#ifdef USE_MPI_IO
+	std::cout<< GridLogMessage<<"IOobject: aggregated write I/O "<< file<< std::endl;
+	AggregatorIO(grid,(void *)&iodata[0],rowbytes,fileoffs,file,1,truncate);
+	offset = offset + nrank*lsites*sizeof(fobj);
+	MPI_Type_free(&fileArray);
+	MPI_Type_free(&localArray);
+#endif
+      } else if ( (control & BINARYIO_LEXICOGRAPHIC) && (nrank > 1) ) {
 #ifdef USE_MPI_IO
         std::cout << GridLogMessage <<"IOobject: MPI write I/O " << file << std::endl;
         ierr = MPI_File_open(grid->communicator, (char *)file.c_str(), MPI_MODE_RDWR | MPI_MODE_CREATE, MPI_INFO_NULL, &fh);
@@ -524,6 +786,189 @@ class BinaryIO {
     }
   }
 
+  /////////////////////////////////////////////////////////////////////////////
+  // Read a Lattice of object through read only mappings of the file.
+  // The rank's slab is taken a window of slowest dimension slices at a
+  // time: only the rank's own contiguous runs of those slices are mapped and
+  // prefetched, each site checksummed, byte swapped and munged (e.g. two row
+  // reconstruction) in registers and inserted into its SIMD lane. Runs shorter
+  // than a page are pread into a window sized buffer instead. The scalar copy
+  // of the field is never staged, so peak memory is the field plus one window.
+  //////////////////////////////////////////////////////////////////////////////////////
+  template<class vobj,class fobj,class munger>
+  static inline void readLatticeObjectMmap(Lattice<vobj> &Umu,
+					   std::string file,
+					   munger munge,
+					   uint64_t offset,
+					   const std::string &format,
+					   uint32_t &nersc_csum,
+					   uint32_t &scidac_csuma,
+					   uint32_t &scidac_csumb)
+  {
+    typedef typename vobj::scalar_object sobj;
+
+    GridBase *grid = Umu.Grid();
+    int nd     = grid->_ndimension;
+    int tdim   = nd-1;
+    Coordinate global_vol  = grid->FullDimensions();
+    Coordinate local_vol   = grid->LocalDimensions();
+    Coordinate local_start = grid->LocalStarts();
+
+    int ieee32big = (format == std::string("IEEE32BIG"));
+    int ieee32    = (format == std::string("IEEE32"));
+    int ieee64big = (format == std::string("IEEE64BIG"));
+    int ieee64    = (format == std::string("IEEE64"));
+    assert((ieee64+ieee32+ieee64big+ieee32big)==1);
+    int wordsize = (ieee32||ieee32big) ? 4 : 8;
+    int swap     = (ieee32big||ieee64big) ? !HostBigEndian() : HostBigEndian();
+
+    GridStopWatch timer;
+    timer.Start();
+
+    int fd = ::open(file.c_str(),O_RDONLY);
+    if ( fd<0 ) {
+      std::cout << GridLogError << "readLatticeObjectMmap: cannot open " << file << " : " << strerror(errno) << std::endl;
+      assert(0);
+    }
+    struct stat st;
+    if ( fstat(fd,&st) ) {
+      std::cout << GridLogError << "readLatticeObjectMmap: cannot stat " << file << " : " << strerror(errno) << std::endl;
+      assert(0);
+    }
+    uint64_t bytes = offset + grid->gSites()*sizeof(fobj);
+    if ( (uint64_t)st.st_size < bytes ) {
+      std::cout << GridLogError << "readLatticeObjectMmap: " << file << " holds " << st.st_size
+		<< " bytes, expected " << bytes << std::endl;
+      assert(0);
+    }
+
+    // Slices per window: as many as span at most ioMmapWindow bytes of file, at least one
+    uint64_t slicebytes = (grid->gSites()/global_vol[tdim])*sizeof(fobj);
+    uint64_t slicesites = grid->lSites()/local_vol[tdim];
+    int nslice = std::max((uint64_t)1,std::min((uint64_t)local_vol[tdim],ioMmapWindow/slicebytes));
+    uint64_t page = sysconf(_SC_PAGESIZE);
+
+    // The rank's sites lie in runs contiguous in the file, spanning the leading
+    // dimensions up to and including the first one the rank holds only part of.
+    // Each run is mapped on its own so other ranks' rows are neither mapped nor
+    // read ahead; runs shorter than a page are read with pread instead.
+    const int maxruns = 4096;   // mappings per window
+    uint64_t slicerun = 1;
+    int partial = nd;
+    for(int d=0;d<tdim;d++){
+      slicerun *= local_vol[d];
+      if ( local_vol[d] != global_vol[d] ) { partial = d; break; }
+    }
+    if ( partial < tdim ) {
+      int slice_runs = slicesites/slicerun;
+      nslice = std::max(1,std::min(nslice,maxruns/slice_runs));
+    }
+
+    nersc_csum=0;
+    scidac_csuma=0;
+    scidac_csumb=0;
+
+    std::vector<fobj>     iobuf;
+    std::vector<char *>   runptr;
+    std::vector<char *>   mapaddr;
+    std::vector<uint64_t> maplen;
+    auto U_v = Umu.View();
+    for(int t0=0;t0<local_vol[tdim];t0+=nslice){
+
+      int nt = std::min(nslice,local_vol[tdim]-t0);
+      Coordinate wvol(local_vol);  wvol[tdim] = nt;
+      uint64_t wsites   = nt*slicesites;
+      uint64_t runsites = (partial < tdim) ? slicerun : wsites;
+      uint64_t nruns    = wsites/runsites;
+      uint64_t runbytes = runsites*sizeof(fobj);
+      int usepread = (runbytes < page);
+
+      // file offset of the first site of run r
+      auto runOffset = [&](uint64_t r) {
+	Coordinate rcoor(nd);
+	int global_site;
+	Lexicographic::CoorFromIndex(rcoor,r*runsites,wvol);
+	rcoor[tdim] += t0;
+	for(int d=0;d<nd;d++) rcoor[d] += local_start[d];
+	Lexicographic::IndexFromCoor(rcoor,global_site,global_vol);
+	return offset+(uint64_t)global_site*sizeof(fobj);
+      };
+
+      if ( usepread ) {
+	iobuf.resize(wsites);
+	thread_for(r,nruns,{
+	  uint64_t off  = runOffset(r);
+	  char    *dest = (char *)&iobuf[r*runsites];
+	  uint64_t done = 0;
+	  while ( done < runbytes ) {
+	    ssize_t n = ::pread(fd,dest+done,runbytes-done,off+done);
+	    assert(n > 0);
+	    done += n;
+	  }
+	});
+      } else {
+	runptr.resize(nruns);
+	mapaddr.resize(nruns);
+	maplen.resize(nruns);
+	for(uint64_t r=0;r<nruns;r++){
+	  uint64_t lo   = runOffset(r);
+	  uint64_t base = lo - lo%page;
+	  maplen[r]  = lo+runbytes-base;
+	  mapaddr[r] = (char *)mmap(NULL,maplen[r],PROT_READ,MAP_SHARED,fd,base);
+	  assert(mapaddr[r] != MAP_FAILED);
+	  madvise(mapaddr[r],maplen[r],MADV_WILLNEED);
+	  runptr[r]  = mapaddr[r]+(lo-base);
+	}
+      }
+
+      thread_region
+      {
+	uint32_t nersc_csum_thr=0;
+	uint32_t scidac_csuma_thr=0;
+	uint32_t scidac_csumb_thr=0;
+	Coordinate lcoor(nd), gcoor(nd);
+	fobj site;
+	sobj ssite;
+
+	thread_for_in_region( ws, wsites, {
+	  int global_site;
+	  Lexicographic::CoorFromIndex(lcoor,ws,wvol);
+	  lcoor[tdim] += t0;
+	  for(int d=0;d<nd;d++) gcoor[d] = lcoor[d]+local_start[d];
+	  Lexicographic::IndexFromCoor(gcoor,global_site,global_vol);
+
+	  const char *src = usepread ? (const char *)&iobuf[ws]
+	                             : runptr[ws/runsites]+(ws%runsites)*sizeof(fobj);
+	  memcpy((void *)&site,src,sizeof(fobj));
+	  EndianChecksumSite(&site,wordsize,swap,1,global_site,
+			     nersc_csum_thr,scidac_csuma_thr,scidac_csumb_thr);
+	  munge(site,ssite);
+	  insertLane(grid->iIndex(lcoor),U_v[grid->oIndex(lcoor)],ssite);
+	});
+
+	thread_critical
+	{
+	  nersc_csum  += nersc_csum_thr;
+	  scidac_csuma^= scidac_csuma_thr;
+	  scidac_csumb^= scidac_csumb_thr;
+	}
+      }
+      if ( !usepread ) {
+	for(uint64_t r=0;r<nruns;r++) munmap(mapaddr[r],maplen[r]);
+      }
+    }
+    ::close(fd);
+
+    grid->GlobalSum(nersc_csum);
+    grid->GlobalXOR(scidac_csuma);
+    grid->GlobalXOR(scidac_csumb);
+    timer.Stop();
+
+    uint64_t lbytes = grid->lSites()*sizeof(fobj);
+    std::cout<<GridLogMessage<<"readLatticeObjectMmap: "<< lbytes <<" bytes per rank in "<<timer.Elapsed()<<" "
+	     << (double)lbytes/(double)timer.useconds() <<" MB/s "<<std::endl;
+  }
+
   /////////////////////////////////////////////////////////////////////////////
   // Read a Lattice of object
   //////////////////////////////////////////////////////////////////////////////////////
@@ -543,6 +988,11 @@ class BinaryIO {
     GridBase *grid = Umu.Grid();
     uint64_t lsites = grid->lSites();
 
+    if ( ioMmap ) {
+      readLatticeObjectMmap<vobj,fobj>(Umu,file,munge,offset,format,nersc_csum,scidac_csuma,scidac_csumb);
+      return;
+    }
+
     std::vector<sobj> scalardata(lsites); 
     std::vector<fobj>     iodata(lsites); // Munge, checksum, byte order in here
     
@@ -628,6 +1078,14 @@ class BinaryIO {
     std::cout<<GridLogMessage<<"writeLatticeObject: unvectorize overhead "<<timer.Elapsed()  <<std::endl;
   }
   
+  /////////////////////////////////////////////////////////////////////////////
+  // RNG files hold the parallel states in lexicographic order, a format
+  // tag record {RngFileTag, counter based, RngStateCount, 0...} and the
+  // serial state last. The tag is outside the checksums; files without one
+  // predate it and were written by per site engines.
+  /////////////////////////////////////////////////////////////////////////////
+  static const uint32_t RngFileTag = 0x47524e47; // "GRNG"
+
   /////////////////////////////////////////////////////////////////////////////
   // Read a RNG;  use IOobject and lexico map to an array of state 
   //////////////////////////////////////////////////////////////////////////////////////
@@ -658,6 +1116,34 @@ class BinaryIO {
 
     std::cout << GridLogMessage << "RNG read I/O on file " << file << std::endl;
 
+    // The generator that wrote the file must be the one restoring it
+    RNGstate tag;
+    std::fill(tag.begin(),tag.end(),0);
+    if ( grid->IsBoss() ) {
+      uint64_t at = offset + gsites*sizeof(RNGstate);
+      std::ifstream fin(file,std::ios::binary|std::ios::ate);
+      if ( fin.good() && (uint64_t)fin.tellg() >= at+2*sizeof(RNGstate) ) {
+	fin.seekg(at);
+	fin.read((char *)&tag[0],sizeof(RNGstate));
+	be32toh_v((void *)&tag[0],sizeof(RNGstate)); // IEEE32BIG, as IOobject wrote it
+      }
+      if ( tag[0] != RngFileTag ) std::fill(tag.begin(),tag.end(),0);
+    }
+    grid->Broadcast(0,(void *)&tag[0],sizeof(RNGstate));
+    int file_counter = (tag[0]==RngFileTag) ? (int)tag[1] : 0;
+    if ( file_counter != parallel_rng.IsCounterBased() ) {
+      std::cout << GridLogError << "readRNG: " << file << " holds "
+		<< (file_counter ? "counter based (--rng-counter)" : "per site engine")
+		<< " RNG state; this RNG is "
+		<< (parallel_rng.IsCounterBased() ? "counter based" : "per site engines") << std::endl;
+      assert(0);
+    }
+    if ( (tag[0]==RngFileTag) && (tag[2] != RngStateCount) ) {
+      std::cout << GridLogError << "readRNG: " << file << " holds " << tag[2]
+		<< " state words per generator, this engine " << RngStateCount << std::endl;
+      assert(0);
+    }
+
     std::vector<RNGstate> iodata(lsites);
     IOobject(w,grid,iodata,file,offset,format,BINARYIO_READ|BINARYIO_LEXICOGRAPHIC,
 	     nersc_csum,scidac_csuma,scidac_csumb);
@@ -719,6 +1205,15 @@ class BinaryIO {
 
     std::cout << GridLogMessage << "RNG write I/O on file " << file << std::endl;
 
+    // Records are appended; drop any earlier contents past a header
+    if ( grid->IsBoss() ) {
+      if ( ::truncate(file.c_str(),offset) && (errno != ENOENT) ) {
+	std::cout << GridLogError << "writeRNG: cannot truncate " << file << " : " << strerror(errno) << std::endl;
+	assert(0);
+      }
+    }
+    grid->Barrier();
+
     timer.Start();
     std::vector<RNGstate> iodata(lsites);
     thread_for(lidx,lsites,{
@@ -731,6 +1226,12 @@ class BinaryIO {
     IOobject(w,grid,iodata,file,offset,format,BINARYIO_WRITE|BINARYIO_LEXICOGRAPHIC,
 	     nersc_csum,scidac_csuma,scidac_csumb);
     iodata.resize(1);
+    std::fill(iodata[0].begin(),iodata[0].end(),0);
+    iodata[0][0] = RngFileTag;
+    iodata[0][1] = parallel_rng.IsCounterBased();
+    iodata[0][2] = RngStateCount;
+    IOobject(w,grid,iodata,file,offset,format,BINARYIO_WRITE|BINARYIO_MASTER_APPEND,
+	     nersc_csum_tmp,scidac_csuma_tmp,scidac_csumb_tmp);
     {
       std::vector<RngStateType> tmp(RngStateCount);
       serial_rng.GetState(tmp,0);
@@ -0,0 +1,229 @@
+/*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./lib/parallelIO/CompressedIO.h
+
+    Copyright (C) 2015
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+*************************************************************************************/
+/*  END LEGAL */
+#ifndef GRID_COMPRESSED_IO_H
+#define GRID_COMPRESSED_IO_H
+
+#include <zlib.h>
+
+NAMESPACE_BEGIN(Grid);
+
+/////////////////////////////////////////////////////////////////////////////////
+// Block codec for lattice field records.
+//
+// A chunk of scalar site objects is byte shuffled, i.e. byte b of every word is
+// stored contiguously, so that exponents and high mantissa bytes of neighbouring
+// words line up into long runs, and then deflated at the fastest zlib level.
+// The byte planes run most significant first and the chunk size table is big
+// endian, so records move between hosts of either endianness.
+//
+// BoundedError first truncates the mantissa of every word so that the error is at
+// most Tolerance times the largest magnitude word of its site; the discarded bits
+// are zero and disappear under the entropy coder. Chunks are independent, so both
+// directions run one chunk per thread.
+/////////////////////////////////////////////////////////////////////////////////
+class CompressedIO {
+public:
+
+  enum { None=0, Lossless=1, BoundedError=2 };
+
+  static uint64_t ChunkSites;   // sites per independently coded chunk
+
+  static inline std::string ModeName(int mode)
+  {
+    switch(mode){
+    case None:         return std::string("none");
+    case Lossless:     return std::string("lossless");
+    case BoundedError: return std::string("bounded-error");
+    }
+    assert(0);
+    return std::string("");
+  }
+  // inverse of ModeName, an empty name is None; -1 if unknown
+  static inline int ModeFromName(const std::string &name)
+  {
+    if ( name.empty() || (name == ModeName(None)) ) return None;
+    if ( name == ModeName(Lossless) )               return Lossless;
+    if ( name == ModeName(BoundedError) )           return BoundedError;
+    return -1;
+  }
+
+  // Plane p holds byte p of every word counted from the most significant
+  static inline void Shuffle(unsigned char *out,const unsigned char *in,uint64_t words,int wordsize)
+  {
+    int swap = !BinaryIO::HostBigEndian();
+    for(uint64_t w=0;w<words;w++){
+      for(int b=0;b<wordsize;b++){
+	int p = swap ? wordsize-1-b : b;
+	out[p*words+w] = in[w*wordsize+b];
+      }
+    }
+  }
+  static inline void Unshuffle(unsigned char *out,const unsigned char *in,uint64_t words,int wordsize)
+  {
+    int swap = !BinaryIO::HostBigEndian();
+    for(uint64_t w=0;w<words;w++){
+      for(int b=0;b<wordsize;b++){
+	int p = swap ? wordsize-1-b : b;
+	out[w*wordsize+b] = in[p*words+w];
+      }
+    }
+  }
+
+  ////////////////////////////////////////////////////////////////////
+  // Zero the mantissa bits of each word below the per site error bound
+  ////////////////////////////////////////////////////////////////////
+  template<class word,class uword>
+  static inline void TruncateSite(word *w,int nwords,double tolerance)
+  {
+    const int mantissa = std::numeric_limits<word>::digits-1;
+    double m = 0.0;
+    for(int i=0;i<nwords;i++) m = std::max(m,(double)std::fabs(w[i]));
+    if ( m == 0.0 ) return;
+    double e = tolerance*m;
+    double log2e = std::log2(e);
+    for(int i=0;i<nwords;i++){
+      double x = std::fabs(w[i]);
+      if ( x <= e ) { w[i] = 0.0; continue; }
+      // |x| in [2^(ex-1),2^ex); keeping k mantissa bits errs by < 2^(ex-1-k)
+      int ex; std::frexp(x,&ex);
+      int keep = std::max(0,(int)std::ceil(ex-1-log2e));
+      int drop = mantissa-keep;
+      if ( drop <= 0 ) continue;
+      uword u;
+      memcpy(&u,&w[i],sizeof(u));
+      u &= ~((((uword)1)<<drop)-1);
+      memcpy(&w[i],&u,sizeof(u));
+    }
+  }
+  template<class sobj>
+  static inline void Truncate(sobj *site,uint64_t nsites,double tolerance)
+  {
+    typedef typename getPrecision<sobj>::real_scalar_type word;
+    const int nwords = sizeof(sobj)/sizeof(word);
+    for(uint64_t s=0;s<nsites;s++){
+      word *w = (word *)&site[s];
+      if ( sizeof(word)==4 ) TruncateSite<word,uint32_t>(w,nwords,tolerance);
+      else                   TruncateSite<word,uint64_t>(w,nwords,tolerance);
+    }
+  }
+
+  ////////////////////////////////////////////////////////////////////
+  // Compress nsites objects in place: on return data holds exactly what
+  // Decode will reproduce, so checksums may be taken from it
+  ////////////////////////////////////////////////////////////////////
+  template<class sobj>
+  static inline void Encode(sobj *data,uint64_t nsites,int mode,double tolerance,
+			    std::vector<unsigned char> &out)
+  {
+    typedef typename getPrecision<sobj>::real_scalar_type word;
+    assert( (mode==Lossless) || (mode==BoundedError) );
+    if ( mode==BoundedError ) Truncate(data,nsites,tolerance);
+
+    uint64_t bytes = nsites*sizeof(sobj);
+    std::vector<unsigned char> shuffled(bytes);
+    Shuffle(&shuffled[0],(unsigned char *)data,bytes/sizeof(word),sizeof(word));
+
+    uLongf zbytes = compressBound(bytes);
+    out.resize(zbytes);
+    int err = compress2(&out[0],&zbytes,&shuffled[0],bytes,Z_BEST_SPEED);
+    assert(err==Z_OK);
+    out.resize(zbytes);
+  }
+  template<class sobj>
+  static inline void Decode(sobj *data,uint64_t nsites,const unsigned char *in,uint64_t zbytes)
+  {
+    typedef typename getPrecision<sobj>::real_scalar_type word;
+    uint64_t bytes = nsites*sizeof(sobj);
+    std::vector<unsigned char> shuffled(bytes);
+
+    uLongf obytes = bytes;
+    int err = uncompress(&shuffled[0],&obytes,in,zbytes);
+    if ( (err!=Z_OK) || (obytes!=bytes) ) {
+      std::cout << GridLogError << "CompressedIO::Decode: corrupt chunk, zlib error " << err
+		<< " " << obytes << "/" << bytes << " bytes" << std::endl;
+      assert(0);
+    }
+    Unshuffle((unsigned char *)data,&shuffled[0],bytes/sizeof(word),sizeof(word));
+  }
+
+  ////////////////////////////////////////////////////////////////////
+  // SciDAC checksums of a local lexicographic array as it would be laid
+  // out big endian on disk, and its norm; the array is left untouched
+  ////////////////////////////////////////////////////////////////////
+  template<class sobj>
+  static inline void Checksum(GridBase *grid,std::vector<sobj> &data,
+			      uint32_t &scidac_csuma,uint32_t &scidac_csumb,RealD &nrm)
+  {
+    typedef typename getPrecision<sobj>::real_scalar_type word;
+    const int nwords = sizeof(sobj)/sizeof(word);
+    int nd = grid->_ndimension;
+    uint64_t lsites        = grid->lSites();
+    Coordinate local_vol   = grid->LocalDimensions();
+    Coordinate local_start = grid->LocalStarts();
+    Coordinate global_vol  = grid->FullDimensions();
+    int swap = !BinaryIO::HostBigEndian();
+
+    scidac_csuma=0;
+    scidac_csumb=0;
+    nrm=0.0;
+    thread_region
+    {
+      Coordinate coor(nd);
+      uint32_t nersc_csum_thr=0;
+      uint32_t scidac_csuma_thr=0;
+      uint32_t scidac_csumb_thr=0;
+      RealD nrm_thr=0.0;
+      sobj site;
+
+      thread_for_in_region( local_site, lsites, {
+	int global_site;
+	Lexicographic::CoorFromIndex(coor,local_site,local_vol);
+	for(int d=0;d<nd;d++) coor[d] = coor[d]+local_start[d];
+	Lexicographic::IndexFromCoor(coor,global_site,global_vol);
+
+	site = data[local_site];
+	word *w = (word *)&site;
+	for(int i=0;i<nwords;i++) nrm_thr += (RealD)w[i]*(RealD)w[i];
+	BinaryIO::EndianChecksumSite(&site,sizeof(word),swap,0,global_site,
+				     nersc_csum_thr,scidac_csuma_thr,scidac_csumb_thr);
+      });
+
+      thread_critical
+      {
+	scidac_csuma^= scidac_csuma_thr;
+	scidac_csumb^= scidac_csumb_thr;
+	nrm += nrm_thr;
+      }
+    }
+    grid->GlobalXOR(scidac_csuma);
+    grid->GlobalXOR(scidac_csumb);
+    grid->GlobalSum(nrm);
+  }
+};
+
+NAMESPACE_END(Grid);
+
+#endif
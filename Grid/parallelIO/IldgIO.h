@@ -221,10 +221,26 @@ class GridLimeReader : public BinaryIO {
       //      std::cout << GridLogMessage << limeReaderType(LimeR) << " "<< file_bytes <<" bytes "<<std::endl;
       //      std::cout << GridLogMessage<< " readLimeObject seeking "<<  record_name <<" found record :" <<limeReaderType(LimeR) <<std::endl;
 
-      if ( !strncmp(limeReaderType(LimeR), record_name.c_str(),strlen(record_name.c_str()) )  ) {
+      int compressed = !strncmp(limeReaderType(LimeR), GRID_COMPRESSED_FORMAT,strlen(GRID_COMPRESSED_FORMAT));
+
+      if ( compressed || !strncmp(limeReaderType(LimeR), record_name.c_str(),strlen(record_name.c_str()) )  ) {
 
 	//	std::cout << GridLogMessage<< " readLimeLatticeBinaryObject matches ! " <<std::endl;
 
+	if ( compressed ) {
+	  gridCompressedFormat compressedFormat;
+	  std::vector<char> xmlc(file_bytes+1,'\0');
+	  limeReaderReadData((void *)&xmlc[0], &file_bytes, LimeR);
+	  std::string xmlstring(&xmlc[0]);
+	  XmlReader RD(xmlstring, true, "");
+	  read(RD,compressedFormat.SerialisableClassName(),compressedFormat);
+
+	  int status = limeReaderNextRecord(LimeR);
+	  assert(status == LIME_SUCCESS);
+	  assert(!strncmp(limeReaderType(LimeR), GRID_COMPRESSED_DATA,strlen(GRID_COMPRESSED_DATA)));
+	  readLimeLatticeCompressedObject(field,compressedFormat,limeReaderBytes(LimeR),scidac_csuma,scidac_csumb);
+	} else {
+
 	uint64_t PayloadSize = sizeof(sobj) * field.Grid()->_gsites;
 
 	//	std::cout << "R sizeof(sobj)= " <<sizeof(sobj)<<std::endl;
@@ -238,6 +254,7 @@ class GridLimeReader : public BinaryIO {
 	//	std::cout << " ReadLatticeObject from offset "<<offset << std::endl;
 	BinarySimpleMunger<sobj,sobj> munge;
 	BinaryIO::readLatticeObject< vobj, sobj >(field, filename, munge, offset, format,nersc_csum,scidac_csuma,scidac_csumb);
+	}
 	std::cout << GridLogMessage << "SciDAC checksum A " << std::hex << scidac_csuma << std::dec << std::endl;
 	std::cout << GridLogMessage << "SciDAC checksum B " << std::hex << scidac_csumb << std::dec << std::endl;
 	/////////////////////////////////////////////
@@ -260,6 +277,119 @@ class GridLimeReader : public BinaryIO {
       }
     }
   }
+  ////////////////////////////////////////////
+  // Read a compressed lattice record; any processor grid may read a
+  // record written on any other. Each writer block overlapping this
+  // rank is fetched, its chunks decoded thread parallel, and the
+  // overlap copied out, so at most one writer block is held at once.
+  ////////////////////////////////////////////
+  template<class vobj>
+  void readLimeLatticeCompressedObject(Lattice<vobj> &field,gridCompressedFormat &compressedFormat,uint64_t PayloadSize,
+				       uint32_t &scidac_csuma,uint32_t &scidac_csumb)
+  {
+    typedef typename vobj::scalar_object sobj;
+    GridBase *grid = field.Grid();
+    int nd = grid->_ndimension;
+    uint64_t offset = ftello(File);
+
+    Coordinate fdims   = grid->FullDimensions();
+    Coordinate ldims   = grid->LocalDimensions();
+    Coordinate lstart  = grid->LocalStarts();
+    Coordinate wprocs(compressedFormat.processors);
+    Coordinate wldims(nd);
+
+    assert(compressedFormat.typesize       == sizeof(sobj));
+    assert(compressedFormat.floating_point == getFormatString<vobj>());
+    assert(compressedFormat.dimension.size() == nd);
+    assert(wprocs.size() == nd);
+    int nwriters = 1;
+    for(int d=0;d<nd;d++){
+      assert(compressedFormat.dimension[d] == fdims[d]);
+      wldims[d] = fdims[d]/wprocs[d];
+      nwriters *= wprocs[d];
+    }
+    uint64_t wlsites = 1; for(int d=0;d<nd;d++) wlsites *= wldims[d];
+    uint64_t chunk   = compressedFormat.chunksites;
+    uint64_t nchunk  = (wlsites+chunk-1)/chunk;
+
+    std::cout << GridLogMessage << "readLimeLatticeCompressedObject: " << compressedFormat.mode
+	      << " tolerance " << compressedFormat.tolerance << " written on " << wprocs
+	      << " " << PayloadSize << " bytes" << std::endl;
+
+    GridStopWatch timer;
+    timer.Start();
+
+    int fd = ::open(filename.c_str(),O_RDONLY);
+    assert(fd>=0);
+    auto pread_all = [&](void *buf,uint64_t bytes,uint64_t off) {
+      char *p = (char *)buf;
+      while ( bytes ) {
+	ssize_t n = ::pread(fd,p,bytes,off);
+	assert(n>0);
+	p+=n; off+=n; bytes-=n;
+      }
+    };
+
+    std::vector<uint64_t> table(nwriters*nchunk);
+    uint64_t tablebytes = table.size()*sizeof(uint64_t);
+    pread_all(&table[0],tablebytes,offset);
+    BinaryIO::be64toh_v(&table[0],tablebytes);
+    std::vector<uint64_t> chunkoff(table.size()+1);
+    chunkoff[0] = offset+tablebytes;
+    for(uint64_t c=0;c<table.size();c++) chunkoff[c+1] = chunkoff[c]+table[c];
+    assert(chunkoff[table.size()] == offset+PayloadSize);
+
+    std::vector<sobj> scalardata(grid->lSites());
+    std::vector<sobj> wdata(wlsites);
+    std::vector<unsigned char> zdata;
+    for(int w=0;w<nwriters;w++){
+
+      Coordinate wcoor(nd), lo(nd), hi(nd), olen(nd);
+      Lexicographic::CoorFromIndex(wcoor,w,wprocs);
+      uint64_t osites = 1;
+      for(int d=0;d<nd;d++){
+	lo[d]   = std::max(lstart[d],wcoor[d]*wldims[d]);
+	hi[d]   = std::min(lstart[d]+ldims[d],(wcoor[d]+1)*wldims[d]);
+	olen[d] = std::max(0,hi[d]-lo[d]);
+	osites *= olen[d];
+      }
+      if ( osites == 0 ) continue;
+
+      uint64_t c0 = w*nchunk;
+      zdata.resize(chunkoff[c0+nchunk]-chunkoff[c0]);
+      pread_all(&zdata[0],zdata.size(),chunkoff[c0]);
+
+      thread_for(c,nchunk,{
+	uint64_t s0 = c*chunk;
+	uint64_t ns = std::min(chunk,wlsites-s0);
+	CompressedIO::Decode(&wdata[s0],ns,&zdata[chunkoff[c0+c]-chunkoff[c0]],table[c0+c]);
+      });
+
+      thread_region
+      {
+	Coordinate coor(nd), wl(nd), ll(nd);
+	thread_for_in_region(o,osites,{
+	  int widx, lidx;
+	  Lexicographic::CoorFromIndex(coor,o,olen);
+	  for(int d=0;d<nd;d++){
+	    wl[d] = coor[d]+lo[d]-wcoor[d]*wldims[d];
+	    ll[d] = coor[d]+lo[d]-lstart[d];
+	  }
+	  Lexicographic::IndexFromCoor(wl,widx,wldims);
+	  Lexicographic::IndexFromCoor(ll,lidx,ldims);
+	  scalardata[lidx] = wdata[widx];
+	});
+      }
+    }
+    ::close(fd);
+
+    RealD nrm;
+    CompressedIO::Checksum(grid,scalardata,scidac_csuma,scidac_csumb,nrm);
+    vectorizeFromLexOrdArray(scalardata,field);
+    timer.Stop();
+    std::cout << GridLogMessage << "readLimeLatticeCompressedObject: " << grid->lSites()*sizeof(sobj)
+	      << " bytes per rank in " << timer.Elapsed() << std::endl;
+  }
   void readScidacChecksum(scidacChecksum     &scidacChecksum_,
 			  FieldNormMetaData  &FieldNormMetaData_)
   {
@@ -334,8 +464,22 @@ class GridLimeWriter : public BinaryIO
    LimeWriter *LimeW;
    std::string filename;
    bool        boss_node;
+   int         compressMode;
+   double      compressTolerance;
    GridLimeWriter( bool isboss = true) {
      boss_node = isboss;
+     compressMode = CompressedIO::None;
+     compressTolerance = 0.0;
+   }
+   ////////////////////////////////////////////////////////////
+   // Subsequent field records are written compressed; the
+   // tolerance is only used by CompressedIO::BoundedError
+   ////////////////////////////////////////////////////////////
+   void setCompression(int mode,double tolerance=0.0) {
+     assert( (mode==CompressedIO::None) || (mode==CompressedIO::Lossless) || (mode==CompressedIO::BoundedError) );
+     assert( (mode!=CompressedIO::BoundedError) || (tolerance>0.0) );
+     compressMode = mode;
+     compressTolerance = tolerance;
    }
    void open(const std::string &_filename) { 
      filename= _filename;
@@ -490,6 +634,121 @@ class GridLimeWriter : public BinaryIO
       writeLimeObject(0,1,checksum,std::string("scidacChecksum"),std::string(SCIDAC_CHECKSUM));
     }
   }
+  ////////////////////////////////////////////////////
+  // Write a lattice field as a compressed record pair
+  // (format, data) followed by norm and checksum.
+  // Collective; every rank codes and writes its own
+  // local volume, no data passes through the boss.
+  ////////////////////////////////////////////////////
+  template<class vobj>
+  void writeLimeLatticeCompressedObject(Lattice<vobj> &field)
+  {
+    typedef typename vobj::scalar_object sobj;
+    GridBase *grid = field.Grid();
+    assert(boss_node == field.Grid()->IsBoss() );
+
+    int nd          = grid->_ndimension;
+    uint64_t lsites = grid->lSites();
+    uint64_t chunk  = CompressedIO::ChunkSites;
+    uint64_t nchunk = (lsites+chunk-1)/chunk;
+    int nwriters    = grid->ProcessorCount();
+    int me;
+    Lexicographic::IndexFromCoor(grid->ThisProcessorCoor(),me,grid->_processors);
+
+    GridStopWatch timer;
+    timer.Start();
+
+    std::vector<sobj> scalardata(lsites);
+    unvectorizeToLexOrdArray(scalardata,field);
+
+    std::vector<std::vector<unsigned char> > zdata(nchunk);
+    thread_for(c,nchunk,{
+      uint64_t s0 = c*chunk;
+      uint64_t ns = std::min(chunk,lsites-s0);
+      CompressedIO::Encode(&scalardata[s0],ns,compressMode,compressTolerance,zdata[c]);
+    });
+
+    // Checksums and norm of the field as it will be read back
+    FieldNormMetaData FNMD;
+    uint32_t scidac_csuma,scidac_csumb;
+    CompressedIO::Checksum(grid,scalardata,scidac_csuma,scidac_csumb,FNMD.norm2);
+
+    ////////////////////////////////////////////
+    // Chunk size table, big endian on disk; exact in double below 2^53 bytes
+    ////////////////////////////////////////////
+    std::vector<RealD> sizes(nwriters*nchunk,0.0);
+    for(uint64_t c=0;c<nchunk;c++) sizes[me*nchunk+c] = zdata[c].size();
+    grid->GlobalSumVector(&sizes[0],sizes.size());
+    std::vector<uint64_t> table(sizes.size());
+    uint64_t PayloadSize = table.size()*sizeof(uint64_t);
+    uint64_t myoffset    = PayloadSize;
+    for(uint64_t c=0;c<table.size();c++){
+      table[c] = (uint64_t)sizes[c];
+      if ( c < me*nchunk ) myoffset += table[c];
+      PayloadSize += table[c];
+    }
+
+    gridCompressedFormat compressedFormat;
+    compressedFormat.mode           = CompressedIO::ModeName(compressMode);
+    compressedFormat.tolerance      = compressTolerance;
+    compressedFormat.floating_point = getFormatString<vobj>();
+    compressedFormat.typesize       = sizeof(sobj);
+    compressedFormat.chunksites     = chunk;
+    compressedFormat.dimension      = grid->FullDimensions().toVector();
+    compressedFormat.processors     = grid->_processors.toVector();
+
+    uint64_t offset1;
+    if ( boss_node ) {
+      writeLimeObject(0,0,compressedFormat,compressedFormat.SerialisableClassName(),std::string(GRID_COMPRESSED_FORMAT));
+      createLimeRecordHeader(std::string(GRID_COMPRESSED_DATA), 0, 0, PayloadSize);
+      fflush(File);
+      offset1 = ftello(File);
+    }
+    grid->Broadcast(0,(void *)&offset1,sizeof(offset1));
+
+    int fd = ::open(filename.c_str(),O_WRONLY);
+    assert(fd>=0);
+    auto pwrite_all = [&](const void *buf,uint64_t bytes,uint64_t off) {
+      const char *p = (const char *)buf;
+      while ( bytes ) {
+	ssize_t n = ::pwrite(fd,p,bytes,off);
+	assert(n>0);
+	p+=n; off+=n; bytes-=n;
+      }
+    };
+    if ( boss_node ) {
+      std::vector<uint64_t> betable(table);
+      BinaryIO::htobe64_v(&betable[0],betable.size()*sizeof(uint64_t));
+      pwrite_all(&betable[0],betable.size()*sizeof(uint64_t),offset1);
+    }
+    uint64_t off = offset1+myoffset;
+    for(uint64_t c=0;c<nchunk;c++){
+      pwrite_all(&zdata[c][0],zdata[c].size(),off);
+      off += zdata[c].size();
+    }
+    ::close(fd);
+    grid->Barrier();
+
+    if ( boss_node ) {
+      fseek(File,0,SEEK_END);
+      uint64_t offset2 = ftello(File);
+      assert( (offset2-offset1) == PayloadSize);
+      int err=limeWriterCloseRecord(LimeW);  assert(err>=0);
+    }
+    timer.Stop();
+    std::cout << GridLogMessage << "writeLimeLatticeCompressedObject: " << compressedFormat.mode
+	      << " " << grid->gSites()*sizeof(sobj) << " -> " << PayloadSize << " bytes in " << timer.Elapsed() << std::endl;
+
+    scidacChecksum checksum;
+    std::stringstream streama; streama << std::hex << scidac_csuma;
+    std::stringstream streamb; streamb << std::hex << scidac_csumb;
+    checksum.suma= streama.str();
+    checksum.sumb= streamb.str();
+    if ( boss_node ) {
+      writeLimeObject(0,0,FNMD,std::string(GRID_FIELD_NORM),std::string(GRID_FIELD_NORM));
+      writeLimeObject(0,1,checksum,std::string("scidacChecksum"),std::string(SCIDAC_CHECKSUM));
+    }
+  }
 };
 
 class ScidacWriter : public GridLimeWriter {
@@ -533,7 +792,11 @@ class ScidacWriter : public GridLimeWriter {
       writeLimeObject(0,0,_scidacRecord,_scidacRecord.SerialisableClassName(),std::string(SCIDAC_PRIVATE_RECORD_XML));
     }
     // Collective call
-    writeLimeLatticeBinaryObject(field,std::string(ILDG_BINARY_DATA));      // Closes message with checksum
+    if ( compressMode != CompressedIO::None ) {
+      writeLimeLatticeCompressedObject(field);                                // Closes message with checksum
+    } else {
+      writeLimeLatticeBinaryObject(field,std::string(ILDG_BINARY_DATA));      // Closes message with checksum
+    }
   }
 };
 
@@ -574,8 +837,10 @@ class ScidacReader : public GridLimeReader {
   }
   void skipPastBinaryRecord(void) {
     std::string rec_name(ILDG_BINARY_DATA);
+    std::string zrec_name(GRID_COMPRESSED_DATA);
     while ( limeReaderNextRecord(LimeR) == LIME_SUCCESS ) { 
-      if ( !strncmp(limeReaderType(LimeR), rec_name.c_str(),strlen(rec_name.c_str()) )  ) {
+      if ( !strncmp(limeReaderType(LimeR), rec_name.c_str(),strlen(rec_name.c_str()) ) ||
+	   !strncmp(limeReaderType(LimeR), zrec_name.c_str(),strlen(zrec_name.c_str()) ) ) {
 	skipPastObjectRecord(std::string(SCIDAC_CHECKSUM));
 	return;
       }
@@ -48,6 +48,8 @@ NAMESPACE_BEGIN(Grid);
 #define SCIDAC_PRIVATE_RECORD_XML "scidac-private-record-xml"
 #define SCIDAC_RECORD_XML         "scidac-record-xml"
 #define SCIDAC_BINARY_DATA        "scidac-binary-data"
+#define GRID_COMPRESSED_FORMAT    "grid-compressed-format"
+#define GRID_COMPRESSED_DATA      "grid-compressed-binary-data"
 // Unused SCIDAC records names; could move to support this functionality
 #define SCIDAC_SITELIST           "scidac-sitelist"
 
@@ -141,6 +143,28 @@ public:
   {}
 };
 
+///////////////////////////////////////////////////////////////////////
+// Compressed binary record; replaces ildg-binary-data, which it precedes.
+// The payload is a table of uint64 chunk sizes, processor major, followed
+// by each processor's chunks of its local volume in lexicographic order
+///////////////////////////////////////////////////////////////////////
+struct gridCompressedFormat : Serializable {
+public:
+  GRID_SERIALIZABLE_CLASS_MEMBERS(gridCompressedFormat,
+				  double, version,
+				  std::string, mode,
+				  double, tolerance,
+				  std::string, floating_point,
+				  int, typesize,
+				  int, chunksites,
+				  std::vector<int>, dimension,
+				  std::vector<int>, processors);
+
+  gridCompressedFormat()
+  : version(1.0), tolerance(0.0), typesize(0), chunksites(0)
+  {}
+};
+
 ////////////////////////
 // ILDG format
 ////////////////////////
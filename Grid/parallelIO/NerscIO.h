@@ -248,9 +248,10 @@ public:
     BinaryIO::writeLatticeObject<vobj,fobj3D>(Umu,file,munge,offset,header.floating_point,
 					      nersc_csum,scidac_csuma,scidac_csumb);
     header.checksum = nersc_csum;
-	if ( grid->IsBoss() ) { 
+	if ( grid->IsBoss() ) {
     writeHeader(header,file);
 	}
+	grid->Barrier(); // header carries the checksum before any rank reads it back
 
     std::cout<<GridLogMessage <<"Written NERSC Configuration on "<< file << " checksum "
 	     <<std::hex<<header.checksum
@@ -302,11 +303,12 @@ public:
     uint32_t nersc_csum,scidac_csuma,scidac_csumb;
     BinaryIO::writeRNG(serial,parallel,file,offset,nersc_csum,scidac_csuma,scidac_csumb);
     header.checksum = nersc_csum;
-	if ( grid->IsBoss() ) { 
+	if ( grid->IsBoss() ) {
     offset = writeHeader(header,file);
 	}
+	grid->Barrier(); // header carries the checksum before any rank reads it back
 
-    std::cout<<GridLogMessage 
+    std::cout<<GridLogMessage
 	     <<"Written NERSC RNG STATE "<<file<< " checksum "
 	     <<std::hex<<header.checksum
 	     <<std::dec<<std::endl;
@@ -92,6 +92,12 @@ NAMESPACE_CHECK(Overlap);
 #include <Grid/qcd/action/fermion/WilsonTMFermion5D.h>   
 NAMESPACE_CHECK(WilsonTM5);
 
+///////////////////////////////////////////////////////////////////////////////
+// Multiple right hand sides sharing links and halo exchange
+///////////////////////////////////////////////////////////////////////////////
+#include <Grid/qcd/action/fermion/WilsonFermionMultiRHS.h>
+NAMESPACE_CHECK(WilsonMultiRHS);
+
 ////////////////////////////////////////////////////////////////////////////////
 // Move this group to a DWF specific tools/algorithms subdir? 
 ////////////////////////////////////////////////////////////////////////////////
@@ -391,6 +391,7 @@ public:
       assert(this->same_node[Zm]==this->HaloGatherDir(source,ZpCompress,Zm,face_idx));
       assert(this->same_node[Tm]==this->HaloGatherDir(source,TpCompress,Tm,face_idx));
     }
+    this->GatherFaces();
     this->face_table_computed=1;
     assert(this->u_comm_offset==this->_unified_buffer_size);
     this->halogtime+=usecond();
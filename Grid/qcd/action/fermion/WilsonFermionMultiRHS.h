@@ -0,0 +1,151 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid 
+
+    Source file: ./lib/qcd/action/fermion/WilsonFermionMultiRHS.h
+
+    Copyright (C) 2015
+
+Author: paboyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#pragma once 
+
+#include <Grid/qcd/action/fermion/FermionCore.h>
+#include <Grid/qcd/action/fermion/WilsonFermion.h>
+
+NAMESPACE_BEGIN(Grid);
+
+////////////////////////////////////////////////////////////////////////////////
+// Wilson operator applied to a block of Nrhs sources on the same gauge field.
+//
+// The sources are stacked in the s-direction of a five dimensional grid with
+// Ls=Nrhs, so the WilsonFermion5D stencil and kernels do the work:
+//  * each doubled link U[sU] is loaded once and applied to all Nrhs spinors
+//    at that 4d site (the s loop is innermost in DhopKernel);
+//  * one HaloExchange moves the faces of the whole block, Nrhs times fewer
+//    (and Nrhs times larger) messages than solving the sources one by one.
+// There is no hopping in s, so the block is Nrhs independent Wilson operators.
+//
+// Pair it with BlockConjugateGradient(BlockCGrQ,0,...) on the Schur or MdagM
+// operator of this action; the Orthog dimension 0 is the rhs index.
+////////////////////////////////////////////////////////////////////////////////
+template<class Impl,int Nrhs>
+class WilsonFermionMultiRHS : public WilsonFermion5D<Impl>
+{
+ public:
+  INHERIT_IMPL_TYPES(Impl);
+ public:
+
+  static const int Nblock = Nrhs;
+  
+  virtual void   Instantiatable(void) {};
+  
+  // Constructors
+ WilsonFermionMultiRHS(GaugeField &_Umu,
+		       GridCartesian         &Fgrid,
+		       GridRedBlackCartesian &Frbgrid, 
+		       GridCartesian         &Ugrid,
+		       GridRedBlackCartesian &Urbgrid, 
+		       RealD _mass,
+		       const ImplParams &p= ImplParams()
+		       ) :
+  WilsonFermion5D<Impl>(_Umu,
+			Fgrid,
+			Frbgrid,
+			Ugrid,
+			Urbgrid,
+			4.0,p),
+    mass(_mass),
+    diag_mass(4.0+_mass)
+    {
+      assert(Fgrid._fdimensions[0]==Nrhs);
+    }
+
+  virtual RealD M(const FermionField &in, FermionField &out) {
+    out.Checkerboard() = in.Checkerboard();
+    this->Dhop(in, out, DaggerNo);
+    return axpy_norm(out, diag_mass, in, out);
+  }
+
+  virtual RealD Mdag(const FermionField &in, FermionField &out) {
+    out.Checkerboard() = in.Checkerboard();
+    this->Dhop(in, out, DaggerYes);
+    return axpy_norm(out, diag_mass, in, out);
+  }
+
+  virtual void Meooe(const FermionField &in, FermionField &out) {
+    if (in.Checkerboard() == Odd) {
+      this->DhopEO(in, out, DaggerNo);
+    } else {
+      this->DhopOE(in, out, DaggerNo);
+    }
+  }
+  
+  virtual void MeooeDag(const FermionField &in, FermionField &out) {
+    if (in.Checkerboard() == Odd) {
+      this->DhopEO(in, out, DaggerYes);
+    } else {
+      this->DhopOE(in, out, DaggerYes);
+    }
+  }	
+  
+  virtual void Mooee(const FermionField &in, FermionField &out) {
+    out.Checkerboard() = in.Checkerboard();
+    typename FermionField::scalar_type scal(diag_mass);
+    out = scal * in;
+  }
+  virtual void MooeeDag(const FermionField &in, FermionField &out) {
+    Mooee(in, out);
+  }
+  virtual void MooeeInv(const FermionField &in, FermionField &out) {
+    out.Checkerboard() = in.Checkerboard();
+    typename FermionField::scalar_type scal(1.0/diag_mass);
+    out = scal * in;
+  }
+  virtual void MooeeInvDag(const FermionField &in, FermionField &out) {
+    MooeeInv(in, out);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // Pack/unpack the block of 4d fields
+  ////////////////////////////////////////////////////////////////////////////////
+  void ImportRHS(const std::vector<FermionField> &in4d, FermionField &out5d) {
+    assert(in4d.size()==Nrhs);
+    for(int s=0;s<Nrhs;s++){
+      InsertSlice(in4d[s], out5d, s, 0);
+    }
+  }
+  void ExportRHS(const FermionField &in5d, std::vector<FermionField> &out4d) {
+    assert(out4d.size()==Nrhs);
+    for(int s=0;s<Nrhs;s++){
+      ExtractSlice(out4d[s], in5d, s, 0);
+    }
+  }
+
+ private:
+  RealD mass;
+  RealD diag_mass;
+};
+
+template<int Nrhs> using WilsonFermionMultiRHSR = WilsonFermionMultiRHS<WilsonImplR,Nrhs>;
+template<int Nrhs> using WilsonFermionMultiRHSF = WilsonFermionMultiRHS<WilsonImplF,Nrhs>;
+template<int Nrhs> using WilsonFermionMultiRHSD = WilsonFermionMultiRHS<WilsonImplD,Nrhs>;
+
+NAMESPACE_END(Grid);
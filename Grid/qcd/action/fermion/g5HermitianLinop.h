@@ -59,12 +59,12 @@ public:
 
     HermOp(in,out);
     
-    ComplexD dot;
-    dot= innerProduct(in,out);
-    n1=real(dot);
-    
-    dot = innerProduct(out,out);
-    n2=real(dot);
+    const Field *l[2] = { &in , &out };
+    const Field *r[2] = { &out, &out };
+    ComplexD dot[2];
+    innerProductBatch<2>(dot,l,r);
+    n1=real(dot[0]);
+    n2=real(dot[1]);
   }
   void HermOp(const Field &in, Field &out){
     Field tmp(in.Grid());
@@ -101,12 +101,12 @@ public:
 
     HermOp(in,out);
     
-    ComplexD dot;
-    dot= innerProduct(in,out);
-    n1=real(dot);
-    
-    dot = innerProduct(out,out);
-    n2=real(dot);
+    const Field *l[2] = { &in , &out };
+    const Field *r[2] = { &out, &out };
+    ComplexD dot[2];
+    innerProductBatch<2>(dot,l,r);
+    n1=real(dot[0]);
+    n2=real(dot[1]);
   }
   void HermOp(const Field &in, Field &out){
     Field tmp(in.Grid());
@@ -43,6 +43,7 @@ public:
 private:
   RealD c_plaq;
   RealD c_rect;
+  std::shared_ptr<GaugeStencil<Gimpl> > stencil;
 
 public:
   PlaqPlusRectangleAction(RealD b,RealD c): c_plaq(b),c_rect(c){};
@@ -62,8 +63,13 @@ public:
   virtual RealD S(const GaugeField &U) {
     RealD vol = U.Grid()->gSites();
 
-    RealD plaq = WilsonLoops<Gimpl>::avgPlaquette(U);
-    RealD rect = WilsonLoops<Gimpl>::avgRectangle(U);
+    RealD plaq, rect;
+    if ( GaugeStencil<Gimpl>::Prepare(stencil,U.Grid(),2) ) {
+      stencil->avgPlaquetteRectangle(U,plaq,rect);
+    } else {
+      plaq = WilsonLoops<Gimpl>::avgPlaquette(U);
+      rect = WilsonLoops<Gimpl>::avgRectangle(U);
+    }
 
     RealD action=c_plaq*(1.0 -plaq)*(Nd*(Nd-1.0))*vol*0.5
       +c_rect*(1.0 -rect)*(Nd*(Nd-1.0))*vol;
@@ -78,6 +84,21 @@ public:
 
     GridBase *grid = Umu.Grid();
 
+    // plaquette and rectangle staples from one depth two halo exchange
+    if ( GaugeStencil<Gimpl>::Prepare(stencil,grid,2) ) {
+      std::vector<GaugeLinkField> staple(Nd,grid);
+      std::vector<GaugeLinkField> rect  (Nd,grid);
+      GaugeLinkField Uk(grid);
+      GaugeLinkField dSdU_mu(grid);
+      stencil->RectStaple(staple,rect,Umu);
+      for (int mu=0; mu < Nd; mu++){
+	Uk = PeekIndex<LorentzIndex>(Umu,mu);
+	dSdU_mu = Ta(Uk*staple[mu])*factor_p + Ta(Uk*rect[mu])*factor_r;
+	PokeIndex<LorentzIndex>(dSdU, dSdU_mu, mu);
+      }
+      return;
+    }
+
     std::vector<GaugeLinkField> U (Nd,grid);
     std::vector<GaugeLinkField> U2(Nd,grid);
 
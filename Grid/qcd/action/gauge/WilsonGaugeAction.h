@@ -58,7 +58,12 @@ public:
                        GridParallelRNG &pRNG){};  // noop as no pseudoferms
 
   virtual RealD S(const GaugeField &U) {
-    RealD plaq = WilsonLoops<Gimpl>::avgPlaquette(U);
+    RealD plaq;
+    if ( GaugeStencil<Gimpl>::Prepare(stencil,U.Grid(),1) ) {
+      plaq = stencil->avgPlaquette(U);
+    } else {
+      plaq = WilsonLoops<Gimpl>::avgPlaquette(U);
+    }
     RealD vol = U.Grid()->gSites();
     RealD action = beta * (1.0 - plaq) * (Nd * (Nd - 1.0)) * vol * 0.5;
     return action;
@@ -72,6 +77,19 @@ public:
 
     GaugeLinkField Umu(U.Grid());
     GaugeLinkField dSdU_mu(U.Grid());
+
+    // all staples from one halo exchange
+    if ( GaugeStencil<Gimpl>::Prepare(stencil,U.Grid(),1) ) {
+      std::vector<GaugeLinkField> staple(Nd,U.Grid());
+      stencil->Staple(staple,U);
+      for (int mu = 0; mu < Nd; mu++) {
+	Umu = PeekIndex<LorentzIndex>(U, mu);
+	dSdU_mu = Ta(Umu * staple[mu]) * factor;
+	PokeIndex<LorentzIndex>(dSdU, dSdU_mu, mu);
+      }
+      return;
+    }
+
     for (int mu = 0; mu < Nd; mu++) {
 
       Umu = PeekIndex<LorentzIndex>(U, mu);
@@ -85,6 +103,7 @@ public:
   }
 private:
   RealD beta;  
+  std::shared_ptr<GaugeStencil<Gimpl> > stencil;
  };
 
 NAMESPACE_END(Grid);
@@ -63,6 +63,8 @@ NAMESPACE_BEGIN(Grid);
       SchurRedBlackDiagMooeeSolve<FermionField> DerivativeSolverL;
       SchurRedBlackDiagMooeeSolve<FermionField> DerivativeSolverR;
       FermionField Phi; // the pseudofermion field for this trajectory
+      ChronoGuesser<FermionField> DerivGuesserL; // force solve histories, off by default
+      ChronoGuesser<FermionField> DerivGuesserR;
 
     public:
 
@@ -84,7 +86,7 @@ NAMESPACE_BEGIN(Grid);
 	Rop(_Rop), 
 	SolverHB(HeatbathCG,false,true),
 	SolverL(ActionCGL, false, true), SolverR(ActionCGR, false, true), 
-	DerivativeSolverL(DerivCGL, false, true), DerivativeSolverR(DerivCGR, false, true), 
+	DerivativeSolverL(DerivCGL, false, false), DerivativeSolverR(DerivCGR, false, false), 
 	Phi(_Lop.FermionGrid()), 
 	param(p), 
         use_heatbath_forecasting(use_fc)
@@ -97,6 +99,13 @@ NAMESPACE_BEGIN(Grid);
         PowerNegHalf.Init(remez, param.tolerance, true);
       };
 
+      // Keep the last depth force solutions of each side for minimal residual extrapolation
+      void SetChronoDepth(int depth)
+      {
+        DerivGuesserL.Depth(depth);
+        DerivGuesserR.Depth(depth);
+      }
+
       virtual std::string action_name() { return "ExactOneFlavourRatioPseudoFermionAction"; }
 
       virtual std::string LogParameters() {
@@ -212,6 +221,10 @@ NAMESPACE_BEGIN(Grid);
 	RealD EtaDagEta = norm2(eta);
 	//	RealD PhiDagMPhi= norm2(eta);
 
+        // Force solve histories belong to the previous Phi
+        DerivGuesserL.Reset();
+        DerivGuesserR.Reset();
+
       };
 
       void Meofa(const GaugeField& U,const FermionField &phi, FermionField & Mphi) 
@@ -295,9 +308,16 @@ NAMESPACE_BEGIN(Grid);
         FermionField CG_src          (Lop.FermionGrid());
         FermionField Chi             (Lop.FermionGrid());
         FermionField g5_R5_Chi       (Lop.FermionGrid());
+        FermionField sol_o           (Lop.FermionRedBlackGrid());
 
         GaugeField force(Lop.GaugeGrid());
 
+        // Hermitian operators of the red-black solves, for the chronological guesses
+        SchurDiagMooeeOperator<AbstractEOFAFermion<Impl>,FermionField> HermOpL(Lop);
+        SchurDiagMooeeOperator<AbstractEOFAFermion<Impl>,FermionField> HermOpR(Rop);
+        typename ChronoGuesser<FermionField>::OperatorScope GuessOpL(DerivGuesserL,HermOpL);
+        typename ChronoGuesser<FermionField>::OperatorScope GuessOpR(DerivGuesserR,HermOpR);
+
 	/////////////////////////////////////////////
 	// PAB: 
 	//   Optional single precision derivative ?
@@ -308,8 +328,11 @@ NAMESPACE_BEGIN(Grid);
         spProj(Phi, spProj_Phi, -1, Lop.Ls);
         Lop.Omega(spProj_Phi, Omega_spProj_Phi, -1, 0);
         G5R5(CG_src, Omega_spProj_Phi);
-        spProj_Phi = Zero();
-        DerivativeSolverL(Lop, CG_src, spProj_Phi);
+        DerivativeSolverL(Lop, CG_src, spProj_Phi, DerivGuesserL);
+        if ( DerivGuesserL.Depth() ) {
+          pickCheckerboard(Odd, sol_o, spProj_Phi);
+          DerivGuesserL.Update(sol_o);
+        }
         Lop.Dtilde(spProj_Phi, Chi);
         G5R5(g5_R5_Chi, Chi);
         Lop.MDeriv(force, g5_R5_Chi, Chi, DaggerNo);
@@ -320,8 +343,11 @@ NAMESPACE_BEGIN(Grid);
         spProj(Phi, spProj_Phi, 1, Rop.Ls);
         Rop.Omega(spProj_Phi, Omega_spProj_Phi, 1, 0);
         G5R5(CG_src, Omega_spProj_Phi);
-        spProj_Phi = Zero();
-        DerivativeSolverR(Rop, CG_src, spProj_Phi);
+        DerivativeSolverR(Rop, CG_src, spProj_Phi, DerivGuesserR);
+        if ( DerivGuesserR.Depth() ) {
+          pickCheckerboard(Odd, sol_o, spProj_Phi);
+          DerivGuesserR.Update(sol_o);
+        }
         Rop.Dtilde(spProj_Phi, Chi);
         G5R5(g5_R5_Chi, Chi);
         Lop.MDeriv(force, g5_R5_Chi, Chi, DaggerNo);
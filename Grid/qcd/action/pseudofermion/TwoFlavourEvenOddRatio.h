@@ -50,6 +50,8 @@ NAMESPACE_BEGIN(Grid);
       FermionField PhiOdd;   // the pseudo fermion field for this trajectory
       FermionField PhiEven;  // the pseudo fermion field for this trajectory
 
+      ChronoGuesser<FermionField> DerivGuesser; // force solve history, off by default
+
     public:
       TwoFlavourEvenOddRatioPseudoFermionAction(FermionOperator<Impl>  &_NumOp, 
                                                 FermionOperator<Impl>  &_DenOp, 
@@ -75,6 +77,9 @@ NAMESPACE_BEGIN(Grid);
           conformable(_NumOp.GaugeRedBlackGrid(), _DenOp.GaugeRedBlackGrid());
         };
 
+      // Keep the last depth force solutions for minimal residual extrapolation
+      void SetChronoDepth(int depth) { DerivGuesser.Depth(depth); }
+
       virtual std::string action_name(){return "TwoFlavourEvenOddRatioPseudoFermionAction";}
 
       virtual std::string LogParameters(){
@@ -127,7 +132,8 @@ NAMESPACE_BEGIN(Grid);
 
         PhiOdd =PhiOdd*scale;
         PhiEven=PhiEven*scale;
-        
+
+        DerivGuesser.Reset();   // history belongs to the previous phi
       };
 
       //////////////////////////////////////////////////////
@@ -187,8 +193,12 @@ NAMESPACE_BEGIN(Grid);
         //X = (Mdag M)^-1 V^dag phi
         //Y = (Mdag)^-1 V^dag  phi
         Vpc.MpcDag(PhiOdd,Y);          // Y= Vdag phi
-        X=Zero();
+        {
+          typename ChronoGuesser<FermionField>::OperatorScope GuessOp(DerivGuesser,Mpc);
+          DerivGuesser(Y,X);           // X= chronological guess, zero without history
+        }
         DerivativeSolver(Mpc,Y,X);     // X= (MdagM)^-1 Vdag phi
+        if ( DerivGuesser.Depth() ) DerivGuesser.Update(X);
         Mpc.Mpc(X,Y);                  // Y=  Mdag^-1 Vdag phi
 
         // phi^dag V (Mdag M)^-1 dV^dag  phi
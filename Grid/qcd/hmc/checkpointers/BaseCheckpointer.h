@@ -29,6 +29,9 @@ directory
 #ifndef BASE_CHECKPOINTER
 #define BASE_CHECKPOINTER
 
+#include <thread>
+#include <atomic>
+
 NAMESPACE_BEGIN(Grid);
 
 class CheckpointerParameters : Serializable {
@@ -37,14 +40,17 @@ public:
 				  std::string, config_prefix, 
 				  std::string, rng_prefix, 
 				  int, saveInterval, 
-				  std::string, format, );
+				  std::string, format, 
+				  int, async, );
 
   CheckpointerParameters(std::string cf = "cfg", std::string rn = "rng",
-			 int savemodulo = 1, const std::string &f = "IEEE64BIG")
+			 int savemodulo = 1, const std::string &f = "IEEE64BIG",
+			 int as = 0)
     : config_prefix(cf),
       rng_prefix(rn),
       saveInterval(savemodulo),
-      format(f){};
+      format(f),
+      async(as){};
 
 
   template <class ReaderClass >
@@ -57,9 +63,116 @@ public:
 
 //////////////////////////////////////////////////////////////////////////////
 // Base class for checkpointers
+//
+// With Params.async the configuration and RNG state are copied to a staging
+// field on a private grid and WriteCheckpoint runs on a background thread,
+// munging, checksumming and writing while the next trajectory proceeds.
+// The staging grid has its own communicator, so the writer's collectives
+// never interleave with the HMC's; this needs MPI_THREAD_MULTIPLE.
+// One write is in flight at a time. The next checkpoint, a restore or the
+// end of the run waits for it.
+//
+// Every write, synchronous or not, is then checked against the record the
+// writer returns: no rank threw, each file holds at least the bytes the
+// writer put there, and all ranks computed the same checksums. A failed
+// write stops the run.
+//////////////////////////////////////////////////////////////////////////////
 template <class Impl>
 class BaseHmcCheckpointer : public HmcObservable<typename Impl::Field> {
+private:
+  typedef typename Impl::Field CheckpointField;
+
 public:
+  // What a WriteCheckpoint produced: each file with the bytes it must hold at
+  // least, and the checksums the writer computed (zero where it reports none)
+  struct CheckpointRecord {
+    std::vector<std::pair<std::string,uint64_t> > files;
+    uint32_t nersc_csum   = 0;
+    uint32_t scidac_csuma = 0;
+    uint32_t scidac_csumb = 0;
+  };
+
+private:
+  enum { AsyncIdle, AsyncPending, AsyncDone, AsyncFailed };
+
+  std::unique_ptr<GridCartesian>   async_grid;
+  std::unique_ptr<CheckpointField> async_U;
+  std::unique_ptr<GridParallelRNG> async_pRNG;
+  GridSerialRNG                    async_sRNG;
+  std::thread                      async_thread;
+  std::atomic<int>                 async_status;
+  std::string                      async_error;
+  CheckpointRecord                 async_record;
+  int                              async_traj;
+  double                           async_time;
+
+  void AsyncStage(CheckpointField &U, GridSerialRNG &sRNG, GridParallelRNG &pRNG) {
+    GridBase *grid = U.Grid();
+    if ( !async_grid ) {
+      async_grid.reset(new GridCartesian(grid->FullDimensions(),grid->_simd_layout,grid->ProcessorGrid()));
+      async_U.reset(new CheckpointField(async_grid.get()));
+      async_pRNG.reset(new GridParallelRNG(async_grid.get()));
+    }
+    // Same layout on both grids: a straight copy of the vector objects
+    {
+      auto U_v = U.View();
+      auto S_v = async_U->View();
+      thread_for(ss,grid->oSites(),{
+	S_v[ss] = U_v[ss];
+      });
+    }
+    async_U->Checkerboard() = U.Checkerboard();
+    async_sRNG = sRNG;
+    thread_for(g,grid->lSites(),{
+      std::vector<GridRNGbase::RngStateType> tmp;
+      pRNG.GetState(tmp,g);
+      async_pRNG->SetState(tmp,g);
+    });
+  }
+
+  // Check a finished write against its record; collective over grid, so
+  // every rank calls it, failed or not. Returns the number of failed ranks.
+  static uint32_t CheckpointVerify(GridBase *grid,const CheckpointRecord &record,
+				   uint32_t failed,std::string &error) {
+    if ( !failed && grid->IsBoss() ) {
+      for(auto &f : record.files){
+	std::ifstream fin(f.first.c_str(),std::ios::binary|std::ios::ate);
+	if ( !fin.good() ) {
+	  error  = "missing file "+f.first;
+	  failed = 1;
+	} else if ( (uint64_t)fin.tellg() < f.second ) {
+	  error  = f.first+" holds "+std::to_string((uint64_t)fin.tellg())
+	    +" bytes, expected at least "+std::to_string(f.second);
+	  failed = 1;
+	}
+      }
+    }
+    uint32_t csum[3] = { record.nersc_csum, record.scidac_csuma, record.scidac_csumb };
+    grid->Broadcast(0,(void *)csum,sizeof(csum));
+    if ( !failed && ( (csum[0] != record.nersc_csum)
+		      || (csum[1] != record.scidac_csuma)
+		      || (csum[2] != record.scidac_csumb) ) ) {
+      error  = "checksums differ from rank 0's";
+      failed = 1;
+    }
+    grid->GlobalSum(failed);
+    return failed;
+  }
+
+  static int AsyncSupported(void) {
+#ifdef GRID_COMMS_NONE
+    return 1;
+#else
+    return CartesianCommunicator::MultipleThreadsSupported();
+#endif
+  }
+
+public:
+  BaseHmcCheckpointer() : async_status(AsyncIdle), async_traj(-1), async_time(0) {};
+  virtual ~BaseHmcCheckpointer() {
+    if ( async_thread.joinable() ) async_thread.join();
+  }
+
   void build_filenames(int traj, CheckpointerParameters &Params,
                        std::string &conf_file, std::string &rng_file) {
     {
@@ -85,6 +198,94 @@ public:
 
   virtual void initialize(const CheckpointerParameters &Params) = 0;
 
+  // Lower bound on a BinaryIO::writeRNG file: the parallel states, the
+  // format tag and the serial state after offset bytes of header
+  static uint64_t RngFileBytes(GridBase *grid,uint64_t offset=0) {
+    return offset + (grid->gSites()+2)*GridRNGbase::RngStateCount*sizeof(GridRNGbase::RngStateType);
+  }
+
+  // Write a configuration and RNG state in the checkpointer's format,
+  // recording what was written
+  virtual void WriteCheckpoint(int traj, CheckpointField &U,
+			       GridSerialRNG &sRNG,
+			       GridParallelRNG &pRNG,
+			       CheckpointRecord &record) = 0;
+
+  void Checkpoint(int traj, CheckpointerParameters &Params, CheckpointField &U,
+		  GridSerialRNG &sRNG, GridParallelRNG &pRNG) {
+
+    if ( Params.async && !AsyncSupported() ) {
+      std::cout << GridLogWarning << "Checkpointer: asynchronous writes need MPI_THREAD_MULTIPLE; writing synchronously" << std::endl;
+      Params.async = 0;
+    }
+    if ( !Params.async ) {
+      CheckpointRecord record;
+      WriteCheckpoint(traj,U,sRNG,pRNG,record);
+      std::string error;
+      CheckpointFail(traj,CheckpointVerify(U.Grid(),record,0,error),error);
+      return;
+    }
+
+    CheckpointWait();
+
+    GridStopWatch StageTimer;
+    StageTimer.Start();
+    AsyncStage(U,sRNG,pRNG);
+    StageTimer.Stop();
+
+    async_traj   = traj;
+    async_status = AsyncPending;
+    async_record = CheckpointRecord();
+    async_thread = std::thread([this,traj](){
+#ifdef GRID_OMP
+      omp_set_num_threads(1); // leave the cores to the trajectory
+#endif
+      double t0 = usecond();
+      try {
+	WriteCheckpoint(traj,*async_U,async_sRNG,*async_pRNG,async_record);
+	async_status = AsyncDone;
+      } catch (std::exception &e) {
+	async_error  = e.what();
+	async_status = AsyncFailed;
+      }
+      async_time = usecond()-t0;
+    });
+    std::cout << GridLogMessage << "Checkpointer: trajectory " << traj << " staged in "
+	      << StageTimer.Elapsed() << "; writing in background" << std::endl;
+  }
+
+  // Wait for a background write and check it; collective
+  void CheckpointWait(void) {
+    if ( !async_thread.joinable() ) return;
+
+    GridStopWatch WaitTimer;
+    WaitTimer.Start();
+    async_thread.join();
+    WaitTimer.Stop();
+
+    // The writer's communicator is idle again; the check runs on it
+    std::string error  = async_error;
+    uint32_t    failed = (async_status != AsyncDone);
+    failed = CheckpointVerify(async_grid.get(),async_record,failed,error);
+    async_status = AsyncIdle;
+    CheckpointFail(async_traj,failed,error);
+    std::cout << GridLogMessage << "Checkpointer: trajectory " << async_traj << " written in "
+	      << async_time/1.0e6 << " s, waited " << WaitTimer.Elapsed() << std::endl;
+  }
+
+  // A checkpoint that did not reach the disk ends the run
+  static void CheckpointFail(int traj,uint32_t failed,const std::string &error) {
+    if ( !failed ) return;
+    if ( error.size() ) {
+      std::cout << GridLogError << "Checkpointer: writing trajectory " << traj << " failed: " << error << std::endl;
+    }
+    std::cout << GridLogError << "Checkpointer: " << failed << " ranks failed to write trajectory "
+	      << traj << "; stopping" << std::endl;
+    abort();
+  }
+
+  void Finalize(void) { CheckpointWait(); }
+
   virtual void CheckpointRestore(int traj, typename Impl::Field &U,
                                  GridSerialRNG &sRNG,
                                  GridParallelRNG &pRNG) = 0;
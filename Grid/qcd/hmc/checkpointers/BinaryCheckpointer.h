@@ -49,6 +49,7 @@ public:
   typedef typename vobj::scalar_object sobj;
   typedef typename getPrecision<sobj>::real_scalar_type sobj_stype;
   typedef typename sobj::DoublePrecision sobj_double;
+  typedef typename BaseHmcCheckpointer<Impl>::CheckpointRecord CheckpointRecord;
 
   BinaryHmcCheckpointer(const CheckpointerParameters &Params_) {
     initialize(Params_);
@@ -64,32 +65,44 @@ public:
   void TrajectoryComplete(int traj, Field &U, GridSerialRNG &sRNG, GridParallelRNG &pRNG) {
 
     if ((traj % Params.saveInterval) == 0) {
-      std::string config, rng;
-      this->build_filenames(traj, Params, config, rng);
-
-      uint32_t nersc_csum;
-      uint32_t scidac_csuma;
-      uint32_t scidac_csumb;
-      
-      BinarySimpleUnmunger<sobj_double, sobj> munge;
-      truncate(rng);
-      BinaryIO::writeRNG(sRNG, pRNG, rng, 0,nersc_csum,scidac_csuma,scidac_csumb);
-      truncate(config);
-
-      BinaryIO::writeLatticeObject<vobj, sobj_double>(U, config, munge, 0, Params.format,
+      this->Checkpoint(traj, Params, U, sRNG, pRNG);
+    }
+  };
+
+  void WriteCheckpoint(int traj, Field &U, GridSerialRNG &sRNG, GridParallelRNG &pRNG,
+		       CheckpointRecord &record) {
+    std::string config, rng;
+    this->build_filenames(traj, Params, config, rng);
+
+    uint32_t nersc_csum;
+    uint32_t scidac_csuma;
+    uint32_t scidac_csumb;
+    
+    BinarySimpleUnmunger<sobj_double, sobj> munge;
+    truncate(rng);
+    BinaryIO::writeRNG(sRNG, pRNG, rng, 0,nersc_csum,scidac_csuma,scidac_csumb);
+    truncate(config);
+
+    BinaryIO::writeLatticeObject<vobj, sobj_double>(U, config, munge, 0, Params.format,
 						      nersc_csum,scidac_csuma,scidac_csumb);
 
-      std::cout << GridLogMessage << "Written Binary Configuration " << config
-                << " checksum " << std::hex 
+    record.files.push_back({rng,this->RngFileBytes(U.Grid())});
+    record.files.push_back({config,U.Grid()->gSites()*sizeof(sobj_double)});
+    record.nersc_csum   = nersc_csum;
+    record.scidac_csuma = scidac_csuma;
+    record.scidac_csumb = scidac_csumb;
+
+    std::cout << GridLogMessage << "Written Binary Configuration " << config
+              << " checksum " << std::hex 
 		<< nersc_csum   <<"/"
 		<< scidac_csuma   <<"/"
 		<< scidac_csumb 
 		<< std::dec << std::endl;
-    }
-
   };
 
   void CheckpointRestore(int traj, Field &U, GridSerialRNG &sRNG, GridParallelRNG &pRNG) {
+    this->CheckpointWait();
+
     std::string config, rng;
     this->build_filenames(traj, Params, config, rng);
     this->check_filename(rng);
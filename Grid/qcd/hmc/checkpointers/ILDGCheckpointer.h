@@ -45,6 +45,7 @@ private:
 
 public:
   INHERIT_GIMPL_TYPES(Implementation);
+  typedef typename BaseHmcCheckpointer<Implementation>::CheckpointRecord CheckpointRecord;
 
   ILDGHmcCheckpointer(const CheckpointerParameters &Params_) { initialize(Params_); }
 
@@ -71,27 +72,40 @@ public:
   void TrajectoryComplete(int traj, GaugeField &U, GridSerialRNG &sRNG,
                           GridParallelRNG &pRNG) {
     if ((traj % Params.saveInterval) == 0) {
-      std::string config, rng;
-      this->build_filenames(traj, Params, config, rng);
-      GridBase *grid = U.Grid();
-      uint32_t nersc_csum,scidac_csuma,scidac_csumb;
-      BinaryIO::writeRNG(sRNG, pRNG, rng, 0,nersc_csum,scidac_csuma,scidac_csumb);
-      IldgWriter _IldgWriter(grid->IsBoss());
-      _IldgWriter.open(config);
-      _IldgWriter.writeConfiguration(U, traj, config, config);
-      _IldgWriter.close();
-
-      std::cout << GridLogMessage << "Written ILDG Configuration on " << config
-                << " checksum " << std::hex 
+      this->Checkpoint(traj, Params, U, sRNG, pRNG);
+    }
+  };
+
+  void WriteCheckpoint(int traj, GaugeField &U, GridSerialRNG &sRNG,
+                       GridParallelRNG &pRNG, CheckpointRecord &record) {
+    std::string config, rng;
+    this->build_filenames(traj, Params, config, rng);
+    GridBase *grid = U.Grid();
+    uint32_t nersc_csum,scidac_csuma,scidac_csumb;
+    BinaryIO::writeRNG(sRNG, pRNG, rng, 0,nersc_csum,scidac_csuma,scidac_csumb);
+    IldgWriter _IldgWriter(grid->IsBoss());
+    _IldgWriter.open(config);
+    _IldgWriter.writeConfiguration(U, traj, config, config);
+    _IldgWriter.close();
+
+    record.files.push_back({rng,this->RngFileBytes(grid)});
+    record.files.push_back({config,grid->gSites()*sizeof(typename GaugeField::vector_object::scalar_object)});
+    record.nersc_csum   = nersc_csum;
+    record.scidac_csuma = scidac_csuma;
+    record.scidac_csumb = scidac_csumb;
+
+    std::cout << GridLogMessage << "Written ILDG Configuration on " << config
+              << " checksum " << std::hex 
 		<< nersc_csum<<"/"
 		<< scidac_csuma<<"/"
 		<< scidac_csumb
 		<< std::dec << std::endl;
-    }
   };
 
   void CheckpointRestore(int traj, GaugeField &U, GridSerialRNG &sRNG,
                          GridParallelRNG &pRNG) {
+    this->CheckpointWait();
+
     std::string config, rng;
     this->build_filenames(traj, Params, config, rng);
     this->check_filename(rng);
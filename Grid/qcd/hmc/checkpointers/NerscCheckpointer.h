@@ -43,6 +43,7 @@ private:
 
 public:
   INHERIT_GIMPL_TYPES(Gimpl);  // only for gauge configurations
+  typedef typename BaseHmcCheckpointer<Gimpl>::CheckpointRecord CheckpointRecord;
 
   NerscHmcCheckpointer(const CheckpointerParameters &Params_) { initialize(Params_); }
 
@@ -54,18 +55,29 @@ public:
   void TrajectoryComplete(int traj, GaugeField &U, GridSerialRNG &sRNG,
                           GridParallelRNG &pRNG) {
     if ((traj % Params.saveInterval) == 0) {
-      std::string config, rng;
-      this->build_filenames(traj, Params, config, rng);
-
-      int precision32 = 1;
-      int tworow = 0;
-      NerscIO::writeRNGState(sRNG, pRNG, rng);
-      NerscIO::writeConfiguration(U, config, tworow, precision32);
+      this->Checkpoint(traj, Params, U, sRNG, pRNG);
     }
   };
 
+  void WriteCheckpoint(int traj, GaugeField &U, GridSerialRNG &sRNG,
+                       GridParallelRNG &pRNG, CheckpointRecord &record) {
+    std::string config, rng;
+    this->build_filenames(traj, Params, config, rng);
+
+    int precision32 = 1;
+    int tworow = 0;
+    NerscIO::writeRNGState(sRNG, pRNG, rng);
+    NerscIO::writeConfiguration(U, config, tworow, precision32);
+
+    // always 3x3 double after the header
+    record.files.push_back({rng,this->RngFileBytes(U.Grid())});
+    record.files.push_back({config,U.Grid()->gSites()*sizeof(LorentzColourMatrixD)});
+  };
+
   void CheckpointRestore(int traj, GaugeField &U, GridSerialRNG &sRNG,
                          GridParallelRNG &pRNG) {
+    this->CheckpointWait();
+
     std::string config, rng;
     this->build_filenames(traj, Params, config, rng);
     this->check_filename(rng);
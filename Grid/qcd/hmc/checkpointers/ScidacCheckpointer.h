@@ -43,6 +43,7 @@ class ScidacHmcCheckpointer : public BaseHmcCheckpointer<Implementation> {
   Metadata MData;
 
   typedef typename Implementation::Field Field;
+  typedef typename BaseHmcCheckpointer<Implementation>::CheckpointRecord CheckpointRecord;
 
  public:
   //INHERIT_GIMPL_TYPES(Implementation);
@@ -73,22 +74,35 @@ class ScidacHmcCheckpointer : public BaseHmcCheckpointer<Implementation> {
   void TrajectoryComplete(int traj, Field &U, GridSerialRNG &sRNG,
                           GridParallelRNG &pRNG) {
     if ((traj % Params.saveInterval) == 0) {
-      std::string config, rng;
-      this->build_filenames(traj, Params, config, rng);
-      GridBase *grid = U.Grid();
-      uint32_t nersc_csum,scidac_csuma,scidac_csumb;
-      BinaryIO::writeRNG(sRNG, pRNG, rng, 0,nersc_csum,scidac_csuma,scidac_csumb);
-      ScidacWriter _ScidacWriter(grid->IsBoss());
-      _ScidacWriter.open(config);
-      _ScidacWriter.writeScidacFieldRecord(U, MData);
-      _ScidacWriter.close();
-
-      std::cout << GridLogMessage << "Written Scidac Configuration on " << config << std::endl;
+      this->Checkpoint(traj, Params, U, sRNG, pRNG);
     }
   };
 
+  void WriteCheckpoint(int traj, Field &U, GridSerialRNG &sRNG,
+                       GridParallelRNG &pRNG, CheckpointRecord &record) {
+    std::string config, rng;
+    this->build_filenames(traj, Params, config, rng);
+    GridBase *grid = U.Grid();
+    uint32_t nersc_csum,scidac_csuma,scidac_csumb;
+    BinaryIO::writeRNG(sRNG, pRNG, rng, 0,nersc_csum,scidac_csuma,scidac_csumb);
+    ScidacWriter _ScidacWriter(grid->IsBoss());
+    _ScidacWriter.open(config);
+    _ScidacWriter.writeScidacFieldRecord(U, MData);
+    _ScidacWriter.close();
+
+    record.files.push_back({rng,this->RngFileBytes(grid)});
+    record.files.push_back({config,grid->gSites()*sizeof(typename Field::vector_object::scalar_object)});
+    record.nersc_csum   = nersc_csum;
+    record.scidac_csuma = scidac_csuma;
+    record.scidac_csumb = scidac_csumb;
+
+    std::cout << GridLogMessage << "Written Scidac Configuration on " << config << std::endl;
+  };
+
   void CheckpointRestore(int traj, Field &U, GridSerialRNG &sRNG,
                          GridParallelRNG &pRNG) {
+    this->CheckpointWait();
+
     std::string config, rng;
     this->build_filenames(traj, Params, config, rng);
     this->check_filename(rng);
@@ -80,6 +80,8 @@ protected:
 
   const ActionSet<Field, RepresentationPolicy> as;
 
+  Field Force;  // persistent force buffer, shared by all levels and actions
+
   void update_P(Field& U, int level, double ep) 
   {
     t_P[level] += ep;
@@ -96,7 +98,7 @@ protected:
     void operator()(std::vector<Action<FieldType>*> repr_set, Repr& Rep,
                     GF& Mom, GF& U, double ep) {
       for (int a = 0; a < repr_set.size(); ++a) {
-        FieldType forceR(U.Grid());
+        FieldType& forceR = Rep.Force;
         // Implement smearing only for the fundamental representation now
         repr_set.at(a)->deriv(Rep.U, forceR);
         GF force = Rep.RtoFundamentalProject(forceR);  // Ta for the fundamental rep
@@ -113,11 +115,12 @@ protected:
 
     for (int a = 0; a < as[level].actions.size(); ++a) {
       double start_full = usecond();
-      Field force(U.Grid());
+      Field& force = Force;
       conformable(U.Grid(), Mom.Grid());
+      conformable(force.Grid(), Mom.Grid());
 
-      Field& Us = Smearer.get_U(as[level].actions.at(a)->is_smeared);
       double start_force = usecond();
+      Field& Us = Smearer.get_U(as[level].actions.at(a)->is_smeared);
       as[level].actions.at(a)->deriv(Us, force);  // deriv should NOT include Ta
 
       std::cout << GridLogIntegrator << "Smearing (on/off): " << as[level].actions.at(a)->is_smeared << std::endl;
@@ -167,6 +170,7 @@ public:
     : Params(Par),
       as(Aset),
       P(grid),
+      Force(grid),
       levels(Aset.size()),
       Smearer(Sm),
       Representations(grid) 
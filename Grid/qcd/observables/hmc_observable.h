@@ -38,6 +38,8 @@ class HmcObservable {
                                   Field &U,
                                   GridSerialRNG &sRNG,
                                   GridParallelRNG &pRNG) = 0;
+  // End of the trajectory loop; complete any work still in flight
+  virtual void Finalize(void) {};
 };
 
 NAMESPACE_END(Grid);
@@ -25,8 +25,9 @@ public:
   static const bool isFundamental = false;
 
   LatticeField U;
+  LatticeField Force;  // HMC force workspace, kept across integrator steps
 
-  explicit AdjointRep(GridBase *grid) : U(grid) {}
+  explicit AdjointRep(GridBase *grid) : U(grid), Force(grid) {}
 
   void update_representation(const LatticeGaugeField &Uin) {
     std::cout << GridLogDebug << "Updating adjoint representation\n";
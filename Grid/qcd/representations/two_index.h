@@ -31,8 +31,9 @@ public:
   static const bool isFundamental = false;
 
   LatticeField U;
+  LatticeField Force;  // HMC force workspace, kept across integrator steps
 
-  explicit TwoIndexRep(GridBase *grid) : U(grid) {}
+  explicit TwoIndexRep(GridBase *grid) : U(grid), Force(grid) {}
 
   void update_representation(const LatticeGaugeField &Uin) {
     std::cout << GridLogDebug << "Updating TwoIndex representation\n";
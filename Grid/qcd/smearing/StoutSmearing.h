@@ -59,6 +59,12 @@ class Smear_Stout : public Smear<Gimpl> {
 public:
   INHERIT_GIMPL_TYPES(Gimpl)
 
+  typedef iMatrix<Simd,Nc> SiteMat;
+  typedef typename Simd::scalar_type SimdScalar;
+  // Per link f0,f1,f2 of exp(iQ) and b10..b12, b20..b22 of its derivative
+  typedef iVector<iVector<Simd,9>,Nd> SiteCoeff;
+  typedef Lattice<SiteCoeff> CoeffField;
+
   /*! Stout smearing with base explicitly specified */
   Smear_Stout(Smear<Gimpl>* base) : SmearBase{base} {
     assert(Nc == 3 && "Stout smearing currently implemented only for Nc==3");
@@ -66,8 +72,8 @@ public:
 
   /*! Construct stout smearing object from explicitly specified rho matrix */
   Smear_Stout(const std::vector<double>& rho_)
-    : OwnedBase{new Smear_APE<Gimpl>(rho_)}, SmearBase{OwnedBase.get()} {
-    std::cout << GridLogDebug << "Stout smearing constructor : Smear_Stout(const std::vector<double>& " << rho_ << " )" << std::endl
+    : SmearRho{rho_}, OwnedBase{new Smear_APE<Gimpl>(rho_)}, SmearBase{OwnedBase.get()} {
+    std::cout << GridLogDebug << "Stout smearing constructor : Smear_Stout(const std::vector<double>& " << rho_ << " )" << std::endl;
     assert(Nc == 3 && "Stout smearing currently implemented only for Nc==3");
     }
 
@@ -81,29 +87,101 @@ public:
 
   void smear(GaugeField& u_smr, const GaugeField& U) const {
     GaugeField C(U.Grid());
-    GaugeLinkField tmp(U.Grid()), iq_mu(U.Grid()), Umu(U.Grid());
+    CoeffField coeff(U.Grid());
+    smear(u_smr, C, coeff, U);
+  };
 
-    std::cout << GridLogDebug << "Stout smearing started\n";
+  /*! The staple base may run on a GaugeStencil when its weights are known */
+  bool StencilSmear(void) const { return OwnedBase && (SmearRho.size() == Nd*Nd); }
 
-    // Smear the configurations
-    SmearBase->smear(C, U);
+  /*! As smear, also returning the staple sum C and the exponential coefficients
+      of every link, which is all the force recursion needs */
+  void smear(GaugeField& u_smr, GaugeField& C, CoeffField& coeff, const GaugeField& U,
+             GaugeStencil<Gimpl>* st = nullptr) const {
+    std::cout << GridLogDebug << "Stout smearing started\n";
 
-    for (int mu = 0; mu < Nd; mu++) {
-      if( mu == OrthogDim )
-        tmp = 1.0;  // Don't smear in the orthogonal direction
-      else {
-        tmp = peekLorentz(C, mu);
-        Umu = peekLorentz(U, mu);
-        iq_mu = Ta(
-                   tmp *
-                   adj(Umu));  // iq_mu = Ta(Omega_mu) to match the signs with the paper
-        exponentiate_iQ(tmp, iq_mu);
-      }
-      pokeLorentz(u_smr, tmp * Umu, mu);  // u_smr = exp(iQ_mu)*U_mu
+    // Smear the configurations; the stencil returns the staples, C is their adjoint
+    if ( st ) {
+      assert(StencilSmear());
+      st->Staple(C, U, SmearRho);
+    } else {
+      SmearBase->smear(C, U);
     }
+    const bool adjoint = (st != nullptr);
+    const int orthog = OrthogDim;
+
+    GridBase* grid = U.Grid();
+    auto U_v = U.View();
+    auto C_v = C.View();
+    auto u_v = u_smr.View();
+    auto c_v = coeff.View();
+    thread_for(ss, grid->oSites(), {
+      for (int mu = 0; mu < Nd; mu++) {
+        SiteMat Umu = U_v[ss](mu)();
+        if ( adjoint ) C_v[ss](mu)() = adj(C_v[ss](mu)());
+        if ( mu == orthog ) {  // Don't smear in the orthogonal direction
+          c_v[ss](mu) = Zero();
+          u_v[ss](mu)() = Umu;
+          continue;
+        }
+        SiteMat iQ = Ta(C_v[ss](mu)() * adj(Umu));  // iq_mu = Ta(Omega_mu) to match the signs with the paper
+        SiteMat e_iQ;
+        exponentiate_iQ(e_iQ, c_v[ss](mu), iQ);
+        u_v[ss](mu)() = e_iQ * Umu;  // u_smr = exp(iQ_mu)*U_mu
+      }
+    });
     std::cout << GridLogDebug << "Stout smearing completed\n";
   };
 
+  /*! Chain rule through one level, Morningstar and Peardon eq (75): with U the
+      links the level was smeared from, C and coeff as returned by smear and
+      SigmaPrime the force on the smeared links,
+        Sigma = SigmaPrime exp(iQ) + C^dag iLambda + derivative of C wrt U,
+      and iLambda of eq (73). Passing the stencil of the smearing, stamped with
+      version, reuses its padded links U */
+  void force(GaugeField& Sigma, GaugeField& iLambda, const GaugeField& SigmaPrime,
+             const GaugeField& U, const GaugeField& C, const CoeffField& coeff,
+             GaugeStencil<Gimpl>* st = nullptr, uint64_t version = 0) const {
+    GridBase* grid = U.Grid();
+    const int orthog = OrthogDim;
+    {
+      auto S_v  = Sigma.View();
+      auto L_v  = iLambda.View();
+      auto Sp_v = SigmaPrime.View();
+      auto U_v  = U.View();
+      auto C_v  = C.View();
+      auto c_v  = coeff.View();
+      thread_for(ss, grid->oSites(), {
+        for (int mu = 0; mu < Nd; mu++) {
+          SiteMat Sp = Sp_v[ss](mu)();
+          if ( mu == orthog ) {
+            S_v[ss](mu)() = Sp;
+            L_v[ss](mu)() = Zero();
+            continue;
+          }
+          SiteMat Umu = U_v[ss](mu)();
+          SiteMat Cmu = C_v[ss](mu)();
+          const iVector<Simd,9> &f = c_v[ss](mu);
+          SiteMat iQ   = Ta(Cmu * adj(Umu));
+          SiteMat iQ2  = iQ * iQ;
+          SiteMat e_iQ = polynomial_iQ(f(0), f(1), f(2), iQ, iQ2);
+          SiteMat B1   = polynomial_iQ(f(3), f(4), f(5), iQ, iQ2);
+          SiteMat B2   = polynomial_iQ(f(6), f(7), f(8), iQ, iQ2);
+          SiteMat USigmap = Umu * Sp;
+          Simd tr1 = TensorRemove(trace(USigmap * B1));
+          Simd tr2 = TensorRemove(trace(USigmap * B2));
+          SiteMat iGamma = scale(iQ, tr1) - scale(iQ2, timesI(tr2)) +
+            scale(USigmap, timesI(f(1))) + scale(iQ * USigmap + USigmap * iQ, f(2));
+          SiteMat iLambda_mu = Ta(iGamma);
+          L_v[ss](mu)() = iLambda_mu;
+          S_v[ss](mu)() = Sp * e_iQ + adj(Cmu) * iLambda_mu;
+        }
+      });
+    }
+    if ( st ) st->ApeDerivative(Sigma, iLambda, U, SmearRho, version);
+    else      SmearBase->derivative(Sigma, iLambda, U);
+  };
+
   void derivative(GaugeField& SigmaTerm, const GaugeField& iLambda,
                   const GaugeField& Gauge) const {
     SmearBase->derivative(SigmaTerm, iLambda, Gauge);
@@ -116,97 +194,148 @@ public:
 
   // Repetion of code here (use the Tensor_exp.h function)
   void exponentiate_iQ(GaugeLinkField& e_iQ, const GaugeLinkField& iQ) const {
-    // Put this outside
     // only valid for SU(3) matrices
 
-    // only one Lorentz direction at a time
-
     // notice that it actually computes
     // exp ( input matrix )
     // the i sign is coming from outside
     // input matrix is anti-hermitian NOT hermitian
-
     GridBase* grid = iQ.Grid();
-    GaugeLinkField unity(grid);
-    unity = 1.0;
-
-    GaugeLinkField iQ2(grid), iQ3(grid);
-    LatticeComplex u(grid), w(grid);
-    LatticeComplex f0(grid), f1(grid), f2(grid);
-
-    iQ2 = iQ * iQ;
-    iQ3 = iQ * iQ2;
-
-    //We should check sgn(c0) here already and then apply eq (34) from 0311018
-    set_uw(u, w, iQ2, iQ3);
-    set_fj(f0, f1, f2, u, w);
-
-    e_iQ = f0 * unity + timesMinusI(f1) * iQ - f2 * iQ2;
+    auto e_v = e_iQ.View();
+    auto q_v = iQ.View();
+    thread_for(ss, grid->oSites(), {
+      iVector<Simd,9> f;
+      exponentiate_iQ(e_v[ss]()(), f, q_v[ss]()());
+    });
   };
 
-  void set_uw(LatticeComplex& u, LatticeComplex& w, GaugeLinkField& iQ2,
-              GaugeLinkField& iQ3) const {
-    Complex one_over_three = 1.0 / 3.0;
-    Complex one_over_two = 1.0 / 2.0;
-
-    GridBase* grid = u.Grid();
-    LatticeComplex c0(grid), c1(grid), tmp(grid), c0max(grid), theta(grid);
-
-    // sign in c0 from the conventions on the Ta
-    c0 = -imag(trace(iQ3)) * one_over_three;  
-    c1 = -real(trace(iQ2)) * one_over_two;
-
-    // Cayley Hamilton checks to machine precision, tested
-    tmp = c1 * one_over_three;
-    c0max = 2.0 * pow(tmp, 1.5);
-
-    theta = acos(c0 / c0max) *
-      one_over_three;  // divide by three here, now leave as it is
-    u = sqrt(tmp) * cos(theta);
-    w = sqrt(c1) * sin(theta);
+  ////////////////////////////////////////////////////////////////////
+  // Site local exp(iQ) = f0 + f1 Q + f2 Q^2; the coefficients are scalar
+  // per lane, the matrix algebra stays vectorised
+  ////////////////////////////////////////////////////////////////////
+  static inline void exponentiate_iQ(SiteMat& e_iQ, iVector<Simd,9>& f, const SiteMat& iQ) {
+    SiteMat iQ2 = iQ * iQ;
+    Simd tr2 = TensorRemove(trace(iQ2));
+    Simd tr3 = TensorRemove(trace(iQ * iQ2));
+    ComplexD c[9];
+    for (int l = 0; l < Simd::Nsimd(); l++) {
+      // sign in c0 from the conventions on the Ta
+      SimdScalar t2 = tr2.getlane(l);
+      SimdScalar t3 = tr3.getlane(l);
+      set_coefficients(c, -imag(t3) / 3.0, -real(t2) / 2.0);
+      for (int j = 0; j < 9; j++) f(j).putlane(SimdScalar(real(c[j]), imag(c[j])), l);
+    }
+    e_iQ = polynomial_iQ(f(0), f(1), f(2), iQ, iQ2);
   }
 
-  void set_fj(LatticeComplex& f0, LatticeComplex& f1, LatticeComplex& f2,
-              const LatticeComplex& u, const LatticeComplex& w) const {
-    GridBase* grid = u.Grid();
-    LatticeComplex xi0(grid), u2(grid), w2(grid), cosw(grid);
-    LatticeComplex fden(grid);
-    LatticeComplex h0(grid), h1(grid), h2(grid);
-    LatticeComplex e2iu(grid), emiu(grid), ixi0(grid), qt(grid);
-    LatticeComplex unity(grid);
-    unity = 1.0;
-
-    xi0 = func_xi0(w);
-    u2 = u * u;
-    w2 = w * w;
-    cosw = cos(w);
-
-    ixi0 = timesI(xi0);
-    emiu = cos(u) - timesI(sin(u));
-    e2iu = cos(2.0 * u) + timesI(sin(2.0 * u));
-
-    h0 = e2iu * (u2 - w2) +
-      emiu * ((8.0 * u2 * cosw) + (2.0 * u * (3.0 * u2 + w2) * ixi0));
-    h1 = e2iu * (2.0 * u) - emiu * ((2.0 * u * cosw) - (3.0 * u2 - w2) * ixi0);
-    h2 = e2iu - emiu * (cosw + (3.0 * u) * ixi0);
-
-    fden = unity / (9.0 * u2 - w2);  // reals
-    f0 = h0 * fden;
-    f1 = h1 * fden;
-    f2 = h2 * fden;
+  // a0 + a1 Q + a2 Q^2 with Q = -i iQ
+  static inline SiteMat polynomial_iQ(const Simd& a0, const Simd& a1, const Simd& a2,
+                                      const SiteMat& iQ, const SiteMat& iQ2) {
+    SiteMat r;
+    Simd ma1 = timesMinusI(a1);
+    for (int i = 0; i < Nc; i++) {
+      for (int j = 0; j < Nc; j++) {
+        r(i, j) = ma1 * iQ(i, j) - a2 * iQ2(i, j);
+      }
+      r(i, i) = r(i, i) + a0;
+    }
+    return r;
   }
-
-  LatticeComplex func_xi0(const LatticeComplex& w) const {
-    // Definition from arxiv 0311018
-    //if (abs(w) < 0.05) {w2 = w*w; return 1.0 - w2/6.0 * (1.0-w2/20.0 * (1.0-w2/42.0));}
-    return sin(w) / w;
+  static inline SiteMat scale(const SiteMat& m, const Simd& a) {
+    SiteMat r;
+    for (int i = 0; i < Nc; i++)
+      for (int j = 0; j < Nc; j++) r(i, j) = a * m(i, j);
+    return r;
   }
 
-  LatticeComplex func_xi1(const LatticeComplex& w) const {
-    // Define a function to do the check
-    // if( w < 1e-4 ) std::cout << GridLogWarning << "[Smear_stout] w too small:
-    // "<< w <<"\n";
-    return cos(w) / (w * w) - sin(w) / (w * w * w);
+  ////////////////////////////////////////////////////////////////////
+  // f0..f2 for c0 = det Q, c1 = tr Q^2 / 2, eqs (23)-(34) of hep-lat/0311018,
+  // then b1j = df_j/dc1 and b2j = df_j/dc0, eqs (57)-(65). c0 < 0 is mapped to
+  // -c0 by eq (34), which keeps 9u^2-w^2 away from zero. For small Q the
+  // closed form is 0/0 and the series of exp(iQ) is summed instead, reduced
+  // with Q^3 = c1 Q + c0.
+  ////////////////////////////////////////////////////////////////////
+  static inline void set_coefficients(ComplexD* f, RealD c0, RealD c1) {
+    const ComplexD I(0.0, 1.0);
+    if (c1 < 0.1) {
+      RealD a[3] = {1.0, 0.0, 0.0}, da0[3] = {0.0, 0.0, 0.0}, da1[3] = {0.0, 0.0, 0.0};
+      ComplexD cn(1.0, 0.0);
+      for (int j = 0; j < 9; j++) f[j] = 0.0;
+      for (int n = 0; n <= 24; n++) {  // |q| < 0.45; converged to rounding
+        for (int j = 0; j < 3; j++) {
+          f[j]     += cn * a[j];
+          f[3 + j] += cn * da1[j];
+          f[6 + j] += cn * da0[j];
+        }
+        RealD an[3]   = {c0 * a[2], a[0] + c1 * a[2], a[1]};
+        RealD da0n[3] = {a[2] + c0 * da0[2], da0[0] + c1 * da0[2], da0[1]};
+        RealD da1n[3] = {c0 * da1[2], da1[0] + a[2] + c1 * da1[2], da1[1]};
+        for (int j = 0; j < 3; j++) {
+          a[j] = an[j];
+          da0[j] = da0n[j];
+          da1[j] = da1n[j];
+        }
+        cn = cn * I / (RealD)(n + 1);
+      }
+      return;
+    }
+    bool negative = (c0 < 0.0);
+    c0 = std::fabs(c0);
+
+    // Cayley Hamilton checks to machine precision, tested
+    RealD c0max = 2.0 * std::pow(c1 / 3.0, 1.5);
+    RealD theta = std::acos(std::min(c0 / c0max, 1.0));
+    RealD u = std::sqrt(c1 / 3.0) * std::cos(theta / 3.0);
+    RealD w = std::sqrt(c1) * std::sin(theta / 3.0);
+
+    RealD u2 = u * u, w2 = w * w, cosw = std::cos(w);
+    RealD xi0, xi1;
+    if (w < 0.05) {
+      xi0 = 1.0 - w2 / 6.0 * (1.0 - w2 / 20.0 * (1.0 - w2 / 42.0));
+      xi1 = -(1.0 - w2 / 10.0 * (1.0 - w2 / 28.0 * (1.0 - w2 / 54.0))) / 3.0;
+    } else {
+      xi0 = std::sin(w) / w;
+      xi1 = std::cos(w) / w2 - std::sin(w) / (w2 * w);
+    }
+    ComplexD emiu(std::cos(u), -std::sin(u));
+    ComplexD e2iu(std::cos(2.0 * u), std::sin(2.0 * u));
+
+    ComplexD h0 = e2iu * (u2 - w2) +
+      emiu * (8.0 * u2 * cosw + I * (2.0 * u * (3.0 * u2 + w2) * xi0));
+    ComplexD h1 = e2iu * (2.0 * u) - emiu * (2.0 * u * cosw - I * ((3.0 * u2 - w2) * xi0));
+    ComplexD h2 = e2iu - emiu * (cosw + I * (3.0 * u * xi0));
+
+    RealD fden = 9.0 * u2 - w2;
+    f[0] = h0 / fden;
+    f[1] = h1 / fden;
+    f[2] = h2 / fden;
+
+    ComplexD r1[3], r2[3];
+    r1[0] = (2.0 * u + I * (2.0 * (u2 - w2))) * e2iu +
+      emiu * ((16.0 * u * cosw + 2.0 * u * (3.0 * u2 + w2) * xi0) +
+              I * (-8.0 * u2 * cosw + 2.0 * (9.0 * u2 + w2) * xi0));
+    r1[1] = (2.0 + I * (4.0 * u)) * e2iu +
+      emiu * ((-2.0 * cosw + (3.0 * u2 - w2) * xi0) + I * (2.0 * u * cosw + 6.0 * u * xi0));
+    r1[2] = 2.0 * I * e2iu + emiu * (-3.0 * u * xi0 + I * (cosw - 3.0 * xi0));
+    r2[0] = -2.0 * e2iu + emiu * (-8.0 * u2 * xi0 + I * (2.0 * u * (cosw + xi0 + 3.0 * u2 * xi1)));
+    r2[1] = emiu * (2.0 * u * xi0 + I * (-cosw - xi0 + 3.0 * u2 * xi1));
+    r2[2] = emiu * (xi0 - I * (3.0 * u * xi1));
+
+    RealD bden = 1.0 / (2.0 * fden * fden);
+    for (int j = 0; j < 3; j++) {
+      f[3 + j] = (2.0 * u * r1[j] + (3.0 * u2 - w2) * r2[j] - (30.0 * u2 + 2.0 * w2) * f[j]) * bden;
+      f[6 + j] = (r1[j] - 3.0 * u * r2[j] - 24.0 * u * f[j]) * bden;
+    }
+
+    // f_j(-c0) = (-1)^j f_j(c0)^*, b_ij(-c0) = (-1)^(i+j+1) b_ij(c0)^*
+    if (negative) {
+      for (int j = 0; j < 3; j++) {
+        RealD sign = (j & 1) ? -1.0 : 1.0;
+        f[j]     =  sign * std::conj(f[j]);
+        f[3 + j] =  sign * std::conj(f[3 + j]);
+        f[6 + j] = -sign * std::conj(f[6 + j]);
+      }
+    }
   }
 };
 
@@ -0,0 +1,623 @@
+/*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./lib/qcd/utils/GaugeStencil.h
+
+    Copyright (C) 2015
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution
+directory
+*************************************************************************************/
+/*  END LEGAL */
+#ifndef QCD_UTILS_GAUGE_STENCIL_H
+#define QCD_UTILS_GAUGE_STENCIL_H
+
+#include <Grid/stencil/GeneralLocalStencil.h>
+
+NAMESPACE_BEGIN(Grid);
+
+/////////////////////////////////////////////////////////////////////////////////
+// Fused staple and plaquette kernels.
+//
+// Each call copies the links into a local volume padded by Depth sites in every
+// processor decomposed dimension. This is the whole halo exchange: the two faces
+// Depth sites thick are swapped with the neighbours in each such dimension, taken
+// dimension by dimension so the corners come along. Every loop is then a site
+// local product read through a GeneralLocalStencil, all directions in one sweep
+// and no intermediate lattices. Depth 1 covers plaquettes and staples, depth 2
+// the 2x1 rectangles.
+//
+// The padded links may be stamped with a configuration version by the caller;
+// ApeDerivative at the same version, as the force of a stout level, then only
+// exchanges its own field. Any other call clears the stamp.
+//
+// Conventions are those of WilsonLoops: Staple(mu) is the sum of the open loops
+// such that U_mu(x)*Staple(mu) closes them, RectStaple likewise for the six 2x1
+// shapes of RectStapleUnoptimised.
+//
+// Only periodic gauge implementations qualify; conjugate boundaries need a twist at
+// the wrap and stay on the WilsonLoops path.
+/////////////////////////////////////////////////////////////////////////////////
+class GaugeStencilBase {
+public:
+  static int Fused;    // --gauge-stencil
+};
+
+template<class Gimpl>
+class GaugeStencil : public GaugeStencilBase {
+public:
+  INHERIT_GIMPL_TYPES(Gimpl);
+
+  typedef typename Gimpl::GaugeLinkField GaugeMat;
+  typedef typename Gimpl::GaugeField     GaugeLorentz;
+  typedef typename GaugeLorentz::vector_object lorentz_obj;
+  typedef typename std::remove_reference<decltype(std::declval<lorentz_obj>()(0))>::type link_obj;
+  typedef typename lorentz_obj::scalar_object lorentz_sobj;
+
+  static bool Supported(GridBase *grid)
+  {
+    if ( !Gimpl::isPeriodicGaugeField() ) return false;
+    if ( grid->_isCheckerBoarded ) return false;
+    if ( dynamic_cast<GridCartesian *>(grid) == nullptr ) return false;
+    for(int d=0;d<grid->_ndimension;d++){
+      if ( grid->_simd_layout[d] > 2 ) return false;   // GeneralLocalStencil restriction
+    }
+    return true;
+  }
+
+  ////////////////////////////////////////////////////////////////////
+  // Build or reuse st for grid when the fused path is enabled and applies
+  ////////////////////////////////////////////////////////////////////
+  static bool Prepare(std::shared_ptr<GaugeStencil> &st,GridBase *grid,int depth)
+  {
+    if ( !Fused || !Supported(grid) ) return false;
+    if ( !st || (st->Grid() != grid) || (st->Depth() < depth) ) {
+      st = std::make_shared<GaugeStencil>(grid,depth);
+    }
+    return true;
+  }
+
+  GaugeStencil(GridBase *grid,int depth) : _grid(grid), _depth(depth)
+  {
+    assert(Supported(grid));
+    assert((depth==1)||(depth==2));
+    const int nd    = grid->_ndimension;
+    const int Nsimd = grid->Nsimd();
+
+    //////////////////////////////////////////////
+    // Successive paddings of the decomposed dimensions
+    //////////////////////////////////////////////
+    GridCartesian *parent = dynamic_cast<GridCartesian *>(grid);
+    Coordinate ldims = grid->_ldimensions;
+    GridBase *prev = grid;
+    for(int mu=0;mu<nd;mu++){
+      if ( grid->_processors[mu] == 1 ) continue;
+      ldims[mu] += 2*depth;
+      Coordinate gdims(nd);
+      for(int d=0;d<nd;d++) gdims[d] = ldims[d]*grid->_processors[d];
+      std::shared_ptr<GridCartesian> g(new GridCartesian(gdims,grid->_simd_layout,grid->_processors,*parent));
+      _stages.push_back(Stage());
+      Stage &s = _stages.back();
+      s.mu   = mu;
+      s.grid = g;
+      s.field.reset(new GaugeLorentz(g.get()));
+      // Faces are depth slices of prev in lexicographic order on fdims
+      const int L = prev->_ldimensions[mu];
+      Coordinate fdims = prev->_ldimensions;
+      fdims[mu] = depth;
+      int nface = 1;
+      for(int d=0;d<nd;d++) nface *= fdims[d];
+      s.send_lo.resize(nface);  s.send_hi.resize(nface);
+      s.recv_lo.resize(nface);  s.recv_hi.resize(nface);
+      s.buf_lo.resize(nface);   s.buf_hi.resize(nface);
+      Coordinate ocoor, icoor, lcoor, fcoor;
+      for(int f=0;f<nface;f++){
+	Lexicographic::CoorFromIndex(fcoor,f,fdims);
+	lcoor = fcoor;
+	s.send_lo[f] = prev->oIndex(lcoor)*(uint64_t)Nsimd + prev->iIndex(lcoor);
+	lcoor[mu] += L-depth;
+	s.send_hi[f] = prev->oIndex(lcoor)*(uint64_t)Nsimd + prev->iIndex(lcoor);
+      }
+      // padded site -> source (0 prev, 1 face from below, 2 face from above) and index
+      s.table.resize(g->oSites()*Nsimd);
+      for(int o=0;o<g->oSites();o++){
+	for(int l=0;l<Nsimd;l++){
+	  g->oCoorFromOindex(ocoor,o);
+	  g->iCoorFromIindex(icoor,l);
+	  g->InOutCoorToLocalCoor(ocoor,icoor,lcoor);
+	  int x = lcoor[mu];
+	  uint64_t src, a;
+	  int f;
+	  if ( x < depth ) {
+	    src = 1;
+	    Lexicographic::IndexFromCoor(lcoor,f,fdims);
+	    a = f;
+	  } else if ( x < L+depth ) {
+	    src = 0;
+	    lcoor[mu] = x-depth;
+	    a = prev->oIndex(lcoor)*(uint64_t)Nsimd + prev->iIndex(lcoor);
+	  } else {
+	    src = 2;
+	    lcoor[mu] = x-L-depth;
+	    Lexicographic::IndexFromCoor(lcoor,f,fdims);
+	    a = f;
+	  }
+	  s.table[o*Nsimd+l] = (src<<62) | a;
+	}
+      }
+      prev = g.get();
+    }
+    _padded = prev;
+
+    //////////////////////////////////////////////
+    // Interior of the padded volume: extraction map and live outer sites
+    //////////////////////////////////////////////
+    Coordinate pad(nd,0);
+    for(int d=0;d<nd;d++) if ( grid->_processors[d] > 1 ) pad[d] = depth;
+    if ( _stages.size() ) {
+      _extract.resize(grid->oSites()*Nsimd);
+      std::vector<int> live(_padded->oSites(),0);
+      Coordinate ocoor, icoor, lcoor;
+      for(int o=0;o<grid->oSites();o++){
+	for(int l=0;l<Nsimd;l++){
+	  grid->oCoorFromOindex(ocoor,o);
+	  grid->iCoorFromIindex(icoor,l);
+	  grid->InOutCoorToLocalCoor(ocoor,icoor,lcoor);
+	  for(int d=0;d<nd;d++) lcoor[d] += pad[d];
+	  int po = _padded->oIndex(lcoor);
+	  _extract[o*Nsimd+l] = po*(uint64_t)Nsimd + _padded->iIndex(lcoor);
+	  live[po] = 1;
+	}
+      }
+      for(int o=0;o<_padded->oSites();o++) if ( live[o] ) _sites.push_back(o);
+    } else {
+      for(int o=0;o<grid->oSites();o++) _sites.push_back(o);
+    }
+
+    //////////////////////////////////////////////
+    // Stencil points; _point[a][da][b][db] for the shift da e_a + db e_b
+    //////////////////////////////////////////////
+    _point.resize(Nd*5*Nd*5,-1);
+    for(int m=0;m<Nd;m++){
+      for(int n=0;n<Nd;n++){
+	if ( m==n ) continue;
+	AddPoint(m, 0,n, 0);
+	AddPoint(m, 1,n, 0); AddPoint(n, 1,m, 0); AddPoint(n,-1,m, 0);
+	AddPoint(m, 1,n,-1);
+	if ( depth==2 ) {
+	  AddPoint(m,-1,n, 0); AddPoint(m, 2,n, 0); AddPoint(n, 2,m, 0); AddPoint(n,-2,m, 0);
+	  AddPoint(m, 1,n, 1); AddPoint(m,-1,n, 1); AddPoint(m,-1,n,-1);
+	  AddPoint(m, 2,n,-1); AddPoint(m, 1,n,-2);
+	}
+      }
+    }
+    _stencil.reset(new GeneralLocalStencil(_padded,_shifts));
+
+    if ( _stages.size() ) _Upad = _stages.back().field;
+    else                  _Upad.reset(new GaugeLorentz(grid));
+    _Opad.reset(new GaugeLorentz(_padded));
+    _Cpad.reset(new ComplexField(_padded));
+  }
+
+  GridBase *Grid(void)  const { return _grid; }
+  int       Depth(void) const { return _depth; }
+
+  // Tag the links padded by the last call with the caller's configuration
+  // version, nonzero; Invalidate when those links may have changed
+  void Stamp(uint64_t version) { _version = version; }
+  void Invalidate(void)        { _version = 0; }
+
+  ////////////////////////////////////////////////////////////////////
+  // Staples for all mu, or a single one, from a single halo exchange
+  ////////////////////////////////////////////////////////////////////
+  void Staple(std::vector<GaugeMat> &staple,const GaugeLorentz &U)
+  {
+    Pad(U);
+    StapleKernel(*_Opad,0,Nd,false);
+    for(int mu=0;mu<Nd;mu++) ExtractLink(staple[mu],*_Opad,mu);
+  }
+  void Staple(GaugeMat &staple,const GaugeLorentz &U,int mu)
+  {
+    Pad(U);
+    StapleKernel(*_Opad,mu,mu+1,false);
+    ExtractLink(staple,*_Opad,mu);
+  }
+  // Staple and 2x1 rectangle staples together; needs depth 2
+  void RectStaple(std::vector<GaugeMat> &staple,std::vector<GaugeMat> &rect,const GaugeLorentz &U)
+  {
+    assert(_depth>=2);
+    Pad(U);
+    StapleKernel(*_Opad,0,Nd,false);
+    for(int mu=0;mu<Nd;mu++) ExtractLink(staple[mu],*_Opad,mu);
+    StapleKernel(*_Opad,0,Nd,true);
+    for(int mu=0;mu<Nd;mu++) ExtractLink(rect[mu],*_Opad,mu);
+  }
+
+  // Sum over nu of rho[mu+Nd*nu] WilsonLoops::Staple(mu,nu), all mu
+  void Staple(GaugeLorentz &staple,const GaugeLorentz &U,const std::vector<double> &rho)
+  {
+    assert(rho.size()==Nd*Nd);
+    Pad(U);
+    StapleKernel(*_Opad,0,Nd,false,&rho[0]);
+    Extract(staple,*_Opad);
+  }
+
+  ////////////////////////////////////////////////////////////////////
+  // Sigma += the derivative of the rho weighted staples contracted with
+  // iLambda, as Smear_APE::derivative. Links stamped with version are
+  // not exchanged again; version 0 always exchanges.
+  ////////////////////////////////////////////////////////////////////
+  void ApeDerivative(GaugeLorentz &Sigma,const GaugeLorentz &iLambda,const GaugeLorentz &U,
+		     const std::vector<double> &rho,uint64_t version=0)
+  {
+    assert(rho.size()==Nd*Nd);
+    if ( !version || (version != _version) ) Pad(U);
+    if ( !_Lpad ) {
+      for(auto &s: _stages) s.aux.reset(new GaugeLorentz(s.grid.get()));
+      if ( _stages.size() ) _Lpad = _stages.back().aux;
+      else                  _Lpad.reset(new GaugeLorentz(_grid));
+      _work.reset(new GaugeLorentz(_grid));
+    }
+    Pad(iLambda,true);
+    ApeDerivativeKernel(*_Opad,&rho[0]);
+    Extract(*_work,*_Opad);
+    Sigma = Sigma + *_work;
+  }
+
+  ////////////////////////////////////////////////////////////////////
+  // sum over x and all planes of tr(plaquette), as WilsonLoops::sumPlaquette
+  ////////////////////////////////////////////////////////////////////
+  RealD sumPlaquette(const GaugeLorentz &U)
+  {
+    Pad(U);
+    return SumLoops(false);
+  }
+  RealD avgPlaquette(const GaugeLorentz &U)
+  {
+    RealD sumplaq = sumPlaquette(U);
+    double vol = U.Grid()->gSites();
+    double faces = (1.0 * Nd * (Nd - 1)) / 2.0;
+    return sumplaq / vol / faces / Nc;
+  }
+  // as WilsonLoops::sumRectangle, both orientations; needs depth 2
+  RealD sumRectangle(const GaugeLorentz &U)
+  {
+    assert(_depth>=2);
+    Pad(U);
+    return SumLoops(true);
+  }
+  RealD avgRectangle(const GaugeLorentz &U)
+  {
+    RealD sumrect = sumRectangle(U);
+    double vol = U.Grid()->gSites();
+    double faces = (1.0 * Nd * (Nd - 1));
+    return sumrect / vol / faces / Nc;
+  }
+  // Both averages from a single halo exchange
+  void avgPlaquetteRectangle(const GaugeLorentz &U,RealD &plaq,RealD &rect)
+  {
+    assert(_depth>=2);
+    Pad(U);
+    double vol = U.Grid()->gSites();
+    double faces = (1.0 * Nd * (Nd - 1));
+    plaq = SumLoops(false) / vol / (0.5*faces) / Nc;
+    rect = SumLoops(true)  / vol / faces / Nc;
+  }
+
+private:
+
+  struct Stage {
+    int mu;
+    std::shared_ptr<GridCartesian> grid;
+    std::shared_ptr<GaugeLorentz>  field;
+    std::shared_ptr<GaugeLorentz>  aux;
+    Vector<uint64_t>               table;
+    Vector<uint64_t>               send_lo, send_hi;   // faces x < depth and x >= L-depth
+    commVector<lorentz_sobj>       buf_lo, buf_hi, recv_lo, recv_hi;
+  };
+
+  void AddPoint(int a,int da,int b,int db)
+  {
+    Coordinate shift(_grid->_ndimension,0);
+    shift[a] += da;
+    shift[b] += db;
+    int p;
+    for(p=0;p<_shifts.size();p++){
+      bool same = true;
+      for(int d=0;d<shift.size();d++) same = same && (_shifts[p][d]==shift[d]);
+      if ( same ) break;
+    }
+    if ( p==_shifts.size() ) _shifts.push_back(shift);
+    _point[((a*5+da+2)*Nd+b)*5+db+2] = p;
+  }
+
+  template<class obj>
+  static accelerator_inline obj Permuted(const obj &in,int perm)
+  {
+    obj out = in, tmp;
+    for(int d=0;(obj::Nsimd()>>(d+1))>0;d++){
+      int mask = obj::Nsimd() >> (d+1);
+      if ( perm & mask ) { permute(tmp,out,d); out = tmp; }
+    }
+    return out;
+  }
+  // Link U_dir(x + da e_a + db e_b) at padded outer site ss
+  template<class View,class StView>
+  static accelerator_inline link_obj Link(const View &U_v,StView &st_v,const int *pt,int ss,
+					  int dir,int a,int da,int b,int db)
+  {
+    auto SE = st_v.GetEntry(pt[((a*5+da+2)*Nd+b)*5+db+2],ss);
+    link_obj l = U_v[SE->_offset](dir);
+    if ( SE->_permute ) l = Permuted(l,SE->_permute);
+    return l;
+  }
+
+  ////////////////////////////////////////////////////////////////////
+  // Copy U into the padded volume, one decomposed dimension at a time,
+  // swapping only the faces with the neighbours; aux pads a second field
+  // alongside the resident links
+  ////////////////////////////////////////////////////////////////////
+  void Pad(const GaugeLorentz &U,bool aux=false)
+  {
+    conformable(U.Grid(),_grid);
+    if ( !aux ) _version = 0;
+    if ( _stages.size()==0 ) { *(aux ? _Lpad : _Upad) = U; return; }
+    const int Nsimd = _grid->Nsimd();
+    const GaugeLorentz *prev = &U;
+    for(auto &s: _stages){
+      GaugeLorentz &dst = aux ? *s.aux : *s.field;
+      const int nface = s.send_lo.size();
+      const int bytes = nface*sizeof(lorentz_sobj);
+      {
+	auto p_v = prev->View();
+	const uint64_t *slo = &s.send_lo[0];
+	const uint64_t *shi = &s.send_hi[0];
+	lorentz_sobj *blo = &s.buf_lo[0];
+	lorentz_sobj *bhi = &s.buf_hi[0];
+	thread_for(f,nface,{
+	  blo[f] = extractLane(slo[f]%Nsimd,p_v[slo[f]/Nsimd]);
+	  bhi[f] = extractLane(shi[f]%Nsimd,p_v[shi[f]/Nsimd]);
+	});
+      }
+      int below, above;
+      _grid->ShiftedRanks(s.mu,1,below,above);
+      _grid->SendToRecvFrom((void *)&s.buf_hi[0],above,(void *)&s.recv_lo[0],below,bytes);
+      _grid->SendToRecvFrom((void *)&s.buf_lo[0],below,(void *)&s.recv_hi[0],above,bytes);
+      auto p_v = prev->View();
+      auto o_v = dst.View();
+      const lorentz_sobj *rlo = &s.recv_lo[0];
+      const lorentz_sobj *rhi = &s.recv_hi[0];
+      const uint64_t *tab = &s.table[0];
+      thread_for(o,s.grid->oSites(),{
+	for(int l=0;l<Nsimd;l++){
+	  uint64_t e   = tab[o*Nsimd+l];
+	  uint64_t src = e>>62;
+	  uint64_t a   = e & ((1ULL<<62)-1);
+	  if      ( src==0 ) insertLane(l,o_v[o],extractLane(a%Nsimd,p_v[a/Nsimd]));
+	  else if ( src==1 ) insertLane(l,o_v[o],rlo[a]);
+	  else               insertLane(l,o_v[o],rhi[a]);
+	}
+      });
+      prev = &dst;
+    }
+  }
+
+  ////////////////////////////////////////////////////////////////////
+  // Real part of the sum of tr(plaquette) over mu > nu, or of tr(2x1
+  // rectangle) over mu != nu with the long side along mu, of the
+  // resident links
+  ////////////////////////////////////////////////////////////////////
+  RealD SumLoops(bool rect)
+  {
+    {
+      auto U_v  = _Upad->View();
+      auto P_v  = _Cpad->View();
+      auto st_v = _stencil->View();
+      const int *pt = &_point[0];
+      const int *sites = &_sites[0];
+#define LINK(dir,a,da,b,db) Link(U_v,st_v,pt,ss,dir,a,da,b,db)
+      thread_for(i,_sites.size(),{
+	int ss = sites[i];
+	typename ComplexField::vector_object p = Zero();
+	for(int mu=0;mu<Nd;mu++){
+	  for(int nu=0;nu<Nd;nu++){
+	    if ( nu==mu ) continue;
+	    link_obj w;
+	    if ( !rect ) {
+	      if ( nu > mu ) continue;
+	      w = LINK(mu,mu,0,nu,0)*LINK(nu,mu,1,nu,0)*adj(LINK(mu,nu,1,mu,0))*adj(LINK(nu,mu,0,nu,0));
+	    } else {
+	      w = LINK(mu,mu,0,nu,0)*LINK(mu,mu,1,nu,0)*LINK(nu,mu,2,nu,0)
+		 *adj(LINK(mu,mu,1,nu,1))*adj(LINK(mu,nu,1,mu,0))*adj(LINK(nu,mu,0,nu,0));
+	    }
+	    p() = p() + trace(w);
+	  }
+	}
+	P_v[ss] = p;
+      });
+#undef LINK
+    }
+    ComplexField loops(_grid);
+    Extract(loops,*_Cpad);
+    return TensorRemove(sum(loops)).real();
+  }
+
+  // interior of a padded field back onto _grid
+  template<class vobj>
+  void Extract(Lattice<vobj> &out,const Lattice<vobj> &in)
+  {
+    if ( _stages.size()==0 ) { out = in; return; }
+    const int Nsimd = _grid->Nsimd();
+    out.Checkerboard() = in.Checkerboard();
+    auto o_v = out.View();
+    auto i_v = in.View();
+    const uint64_t *tab = &_extract[0];
+    thread_for(o,_grid->oSites(),{
+      for(int l=0;l<Nsimd;l++){
+	uint64_t a = tab[o*Nsimd+l];
+	insertLane(l,o_v[o],extractLane(a%Nsimd,i_v[a/Nsimd]));
+      }
+    });
+  }
+  void ExtractLink(GaugeMat &out,const GaugeLorentz &in,int mu)
+  {
+    if ( _stages.size()==0 ) { out = PeekIndex<LorentzIndex>(in,mu); return; }
+    const int Nsimd = _grid->Nsimd();
+    auto o_v = out.View();
+    auto i_v = in.View();
+    const uint64_t *tab = &_extract[0];
+    thread_for(o,_grid->oSites(),{
+      for(int l=0;l<Nsimd;l++){
+	uint64_t a = tab[o*Nsimd+l];
+	auto s = extractLane(a%Nsimd,i_v[a/Nsimd]);
+	typename GaugeMat::vector_object::scalar_object m;
+	m() = s(mu);
+	insertLane(l,o_v[o],m);
+      }
+    });
+  }
+
+  ////////////////////////////////////////////////////////////////////
+  // Plaquette (rect=false) or 2x1 (rect=true) staples for mu in [mu0,mu1),
+  // stored as out(mu) on the padded volume; plane mu,nu weighted by
+  // rho[mu+Nd*nu] if given
+  ////////////////////////////////////////////////////////////////////
+  void StapleKernel(GaugeLorentz &out,int mu0,int mu1,bool rect,const double *rho=nullptr)
+  {
+    auto U_v  = _Upad->View();
+    auto O_v  = out.View();
+    auto st_v = _stencil->View();
+    const int *pt = &_point[0];
+    const int *sites = &_sites[0];
+#define LINK(dir,a,da,b,db) Link(U_v,st_v,pt,ss,dir,a,da,b,db)
+    thread_for(i,_sites.size(),{
+      int ss = sites[i];
+      for(int m=mu0;m<mu1;m++){
+	link_obj stap = Zero();
+	for(int n=0;n<Nd;n++){
+	  if ( n==m ) continue;
+	  if ( !rect ) {
+	    //    __
+	    //      |
+	    //    __|
+	    link_obj plane = LINK(n,m,1,n,0)*adj(LINK(m,n,1,m,0))*adj(LINK(n,m,0,n,0));
+	    //  __
+	    // |
+	    // |__
+	    plane = plane + adj(LINK(n,m,1,n,-1))*adj(LINK(m,n,-1,m,0))*LINK(n,n,-1,m,0);
+	    if ( rho ) plane = plane*rho[m+Nd*n];
+	    stap = stap + plane;
+	  } else {
+	    //           __ ___
+	    //          |    __ |
+	    stap = stap + LINK(m,m,1,n,0)*LINK(n,m,2,n,0)*adj(LINK(m,m,1,n,1))
+	                 *adj(LINK(m,n,1,m,0))*adj(LINK(n,m,0,n,0));
+	    //              __
+	    //          |__ __ |
+	    stap = stap + LINK(m,m,1,n,0)*adj(LINK(n,m,2,n,-1))*adj(LINK(m,m,1,n,-1))
+	                 *adj(LINK(m,n,-1,m,0))*LINK(n,n,-1,m,0);
+	    //           __
+	    //          |__ __ |
+	    stap = stap + adj(LINK(n,m,1,n,-1))*adj(LINK(m,n,-1,m,0))*adj(LINK(m,m,-1,n,-1))
+	                 *LINK(n,m,-1,n,-1)*LINK(m,m,-1,n,0);
+	    //           __ ___
+	    //          |__    |
+	    stap = stap + LINK(n,m,1,n,0)*adj(LINK(m,n,1,m,0))*adj(LINK(m,m,-1,n,1))
+	                 *adj(LINK(n,m,-1,n,0))*LINK(m,m,-1,n,0);
+	    //       --
+	    //      |  |
+	    //
+	    //      |  |
+	    stap = stap + LINK(n,m,1,n,0)*LINK(n,m,1,n,1)*adj(LINK(m,n,2,m,0))
+	                 *adj(LINK(n,n,1,m,0))*adj(LINK(n,m,0,n,0));
+	    //      |  |
+	    //
+	    //      |  |
+	    //       --
+	    stap = stap + adj(LINK(n,m,1,n,-1))*adj(LINK(n,m,1,n,-2))*adj(LINK(m,n,-2,m,0))
+	                 *LINK(n,n,-2,m,0)*LINK(n,n,-1,m,0);
+	  }
+	}
+	O_v[ss](m) = stap;
+      }
+    });
+#undef LINK
+  }
+
+  ////////////////////////////////////////////////////////////////////
+  // Smear_APE::derivative as one site local sum: with the upper staple
+  // S = U_n(x+m) U_m^dag(x+n) U_n^dag(x) and y = x-n,
+  //   out(m) = sum_n  r_nm (L_n(x+m) S - S L_n(x)) - r_mn S U_n(x) L_m(x+n) U_n^dag(x)
+  //        + U_n^dag(y+m) [ U_m^dag(y) (r_nm L_n(y) - r_mn L_m(y)) - r_nm L_n(y+m) U_m^dag(y) ] U_n(y)
+  // for L = iLambda and r_mn = rho[m+Nd*n]
+  ////////////////////////////////////////////////////////////////////
+  void ApeDerivativeKernel(GaugeLorentz &out,const double *rho)
+  {
+    auto U_v  = _Upad->View();
+    auto L_v  = _Lpad->View();
+    auto O_v  = out.View();
+    auto st_v = _stencil->View();
+    const int *pt = &_point[0];
+    const int *sites = &_sites[0];
+#define LINK(dir,a,da,b,db)   Link(U_v,st_v,pt,ss,dir,a,da,b,db)
+#define LAMBDA(dir,a,da,b,db) Link(L_v,st_v,pt,ss,dir,a,da,b,db)
+    thread_for(i,_sites.size(),{
+      int ss = sites[i];
+      for(int m=0;m<Nd;m++){
+	link_obj sig = Zero();
+	for(int n=0;n<Nd;n++){
+	  if ( n==m ) continue;
+	  RealD r_mn = rho[m+Nd*n];
+	  RealD r_nm = rho[n+Nd*m];
+	  link_obj Un  = LINK(n,m,0,n,0);
+	  link_obj S   = LINK(n,m,1,n,0)*adj(LINK(m,n,1,m,0))*adj(Un);
+	  sig = sig + (LAMBDA(n,m,1,n,0)*S - S*LAMBDA(n,m,0,n,0))*r_nm
+	            - S*Un*LAMBDA(m,n,1,m,0)*adj(Un)*r_mn;
+	  link_obj Uny  = LINK(n,n,-1,m,0);
+	  link_obj Umy  = adj(LINK(m,n,-1,m,0));
+	  link_obj Unym = adj(LINK(n,m,1,n,-1));
+	  link_obj Ly   = LAMBDA(n,n,-1,m,0)*r_nm - LAMBDA(m,n,-1,m,0)*r_mn;
+	  sig = sig + Unym*(Umy*Ly - LAMBDA(n,m,1,n,-1)*Umy*r_nm)*Uny;
+	}
+	O_v[ss](m) = sig;
+      }
+    });
+#undef LAMBDA
+#undef LINK
+  }
+
+  GridBase *_grid;
+  GridBase *_padded;
+  int _depth;
+  std::vector<Stage>             _stages;
+  Vector<uint64_t>               _extract;
+  std::vector<int>               _sites;
+  std::vector<Coordinate>        _shifts;
+  std::vector<int>               _point;
+  std::shared_ptr<GeneralLocalStencil> _stencil;
+  std::shared_ptr<GaugeLorentz>  _Upad;
+  std::shared_ptr<GaugeLorentz>  _Opad;
+  std::shared_ptr<ComplexField>  _Cpad;
+  std::shared_ptr<GaugeLorentz>  _Lpad;     // second padded field, allocated on first use
+  std::shared_ptr<GaugeLorentz>  _work;
+  uint64_t                       _version = 0;   // stamp of the links in _Upad
+};
+
+NAMESPACE_END(Grid);
+
+#endif
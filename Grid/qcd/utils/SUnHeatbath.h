@@ -0,0 +1,276 @@
+/*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./lib/qcd/utils/SUnHeatbath.h
+
+    Copyright (C) 2015
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution
+directory
+*************************************************************************************/
+/*  END LEGAL */
+#ifndef QCD_UTILS_SUN_HEATBATH_H
+#define QCD_UTILS_SUN_HEATBATH_H
+
+NAMESPACE_BEGIN(Grid);
+
+/////////////////////////////////////////////////////////////////////////////////
+// Site local heatbath and overrelaxation for the Wilson gauge action.
+//
+// For one checkerboard and one direction the links are independent given their
+// staples, so the staple is formed once (GaugeStencil where it applies, else
+// WilsonLoops), the links and staples of that checkerboard are picked onto the
+// red-black grid, and each link is then updated in registers: a Kennedy-Pendleton
+// heatbath followed by noverrelax overrelaxation hits, each over all
+// Cabibbo-Marinari SU(2) subgroups, with V = U * staple carried along.
+//
+// For a 2x2 block w of V, Re Tr(X w) = x.r with X = x0 + i x.sigma and
+//
+//   r = ( Re(w00+w11), -Im(w01+w10), Re(w10-w01), -Im(w00-w11) ) = k q ,
+//
+// so the heatbath draws Y with weight exp(k y0) and takes X = Y Q, and the
+// overrelaxation step is X = Q Q, which leaves x.r unchanged.
+//
+// Random numbers come from a Philox stream per lattice site, keyed from the
+// serial RNG for every checkerboard and direction, so a sweep is independent of
+// the MPI, SIMD and thread layout. All work fields are allocated once.
+/////////////////////////////////////////////////////////////////////////////////
+template<class Gimpl>
+class SUnHeatbath {
+public:
+  INHERIT_GIMPL_TYPES(Gimpl);
+
+  typedef typename GaugeLinkField::vector_object vobj;
+  typedef typename vobj::scalar_object sobj;
+  typedef typename vobj::scalar_type   scalar;
+
+  SUnHeatbath(GridBase *grid) :
+    _grid(grid),
+    _rbgrid(SpaceTimeGrid::makeFourDimRedBlackGrid(dynamic_cast<GridCartesian *>(grid))),
+    _link(grid), _staple(grid), _link_cb(_rbgrid), _staple_cb(_rbgrid)
+  {
+    assert(Nd==4);
+    if ( GaugeStencil<Gimpl>::Supported(grid) ) {
+      _stencil = std::make_shared<GaugeStencil<Gimpl> >(grid,1);
+    }
+    //////////////////////////////////////////////
+    // Global lexicographic site index of every lane of either
+    // checkerboard, in 64 bits on the host
+    //////////////////////////////////////////////
+    const int nd    = grid->_ndimension;
+    const int Nsimd = grid->Nsimd();
+    Coordinate gdims  = grid->FullDimensions();
+    Coordinate ldims  = grid->LocalDimensions();
+    Coordinate lstart = grid->LocalStarts();
+    Coordinate lcoor, gcoor(nd);
+    for(int cb=0;cb<2;cb++) _gsite[cb].resize(_rbgrid->oSites()*Nsimd);
+    for(int idx=0;idx<grid->lSites();idx++){
+      Lexicographic::CoorFromIndex(lcoor,idx,ldims);
+      uint64_t g = 0;
+      for(int d=nd-1;d>=0;d--){
+	gcoor[d] = lstart[d] + lcoor[d];
+	g = g*gdims[d] + gcoor[d];
+      }
+      int rank, o, l;
+      _rbgrid->GlobalCoorToRankIndex(rank,o,l,gcoor);
+      _gsite[_rbgrid->CheckerBoard(gcoor)==Even ? 0 : 1][o*Nsimd+l] = g;
+    }
+  }
+  ~SUnHeatbath() { delete _rbgrid; }
+
+  ////////////////////////////////////////////////////////////////////
+  // One sweep over both checkerboards and all directions; returns the
+  // heatbath acceptance rate. beta multiplies (1 - 1/Nc Re Tr P).
+  ////////////////////////////////////////////////////////////////////
+  RealD Sweep(GridSerialRNG &sRNG,RealD beta,GaugeField &U,int noverrelax=0,int nheatbath=20)
+  {
+    uint64_t hits=0, accepted=0;
+    int cbs[2] = { Even, Odd };
+    for(int cb=0;cb<2;cb++){
+      for(int mu=0;mu<Nd;mu++){
+	Update(sRNG,beta,U,cbs[cb],mu,true,noverrelax,nheatbath,hits,accepted);
+      }
+    }
+    ProjectOnGroup(U);
+    return (hits>0) ? ((RealD)accepted)/hits : 1.0;
+  }
+  // Overrelaxation only; microcanonical
+  void OverRelax(GridSerialRNG &sRNG,RealD beta,GaugeField &U,int noverrelax=1)
+  {
+    uint64_t hits=0, accepted=0;
+    int cbs[2] = { Even, Odd };
+    for(int cb=0;cb<2;cb++){
+      for(int mu=0;mu<Nd;mu++){
+	Update(sRNG,beta,U,cbs[cb],mu,false,noverrelax,0,hits,accepted);
+      }
+    }
+    ProjectOnGroup(U);
+  }
+
+  ////////////////////////////////////////////////////////////////////
+  // Links of checkerboard cb, direction mu
+  ////////////////////////////////////////////////////////////////////
+  void Update(GridSerialRNG &sRNG,RealD beta,GaugeField &U,int cb,int mu,
+	      bool heatbath,int noverrelax,int nheatbath,uint64_t &hits,uint64_t &accepted)
+  {
+    conformable(U.Grid(),_grid);
+    if ( _stencil ) _stencil->Staple(_staple,U,mu);
+    else            WilsonLoops<Gimpl>::Staple(_staple,U,mu);
+    _link = PeekIndex<LorentzIndex>(U,mu);
+
+    pickCheckerboard(cb,_link_cb,_link);
+    pickCheckerboard(cb,_staple_cb,_staple);
+
+    uint32_t key[2];
+    for(int i=0;i<2;i++){
+      RealD r;
+      random(sRNG,r);
+      key[i] = (uint32_t)(r*4294967296.0);
+    }
+
+    const int Nsimd = _rbgrid->Nsimd();
+    const uint64_t *gsite = &_gsite[cb==Even ? 0 : 1][0];
+    const RealD scale = beta/Nc;
+    Vector<uint64_t> acc(_rbgrid->oSites()*2,0);
+    uint64_t *acc_p = &acc[0];
+    {
+      auto l_v = _link_cb.View();
+      auto s_v = _staple_cb.View();
+      thread_for(ss,_rbgrid->oSites(),{
+	for(int l=0;l<Nsimd;l++){
+	  sobj link   = extractLane(l,l_v[ss]);
+	  sobj staple = extractLane(l,s_v[ss]);
+	  GridPhiloxStream rng(key,gsite[ss*Nsimd+l],0);
+	  UpdateLink(link,staple,scale,rng,heatbath,noverrelax,nheatbath,acc_p[2*ss],acc_p[2*ss+1]);
+	  insertLane(l,l_v[ss],link);
+	}
+      });
+    }
+    for(int ss=0;ss<_rbgrid->oSites();ss++){
+      hits     += acc[2*ss];
+      accepted += acc[2*ss+1];
+    }
+    _grid->GlobalSum(hits);
+    _grid->GlobalSum(accepted);
+
+    setCheckerboard(_link,_link_cb);
+    PokeIndex<LorentzIndex>(U,_link,mu);
+  }
+
+private:
+
+  static inline RealD Uniform(GridPhiloxStream &rng)
+  {
+    uint64_t a = rng();
+    uint64_t b = rng();
+    return ((RealD)((a<<21)^(b>>11)) + 0.5) * (1.0/9007199254740992.0);  // (0,1), 53 bits
+  }
+  // m = a0 + i a.sigma
+  static inline void Quaternion(scalar m[2][2],RealD a0,RealD a1,RealD a2,RealD a3)
+  {
+    m[0][0] = scalar( a0, a3);
+    m[0][1] = scalar( a2, a1);
+    m[1][0] = scalar(-a2, a1);
+    m[1][1] = scalar( a0,-a3);
+  }
+  // Rows i0,i1 of M <- X rows i0,i1 of M
+  template<class mat>
+  static inline void RotateRows(mat &M,const scalar X[2][2],int i0,int i1)
+  {
+    for(int c=0;c<Nc;c++){
+      scalar m0 = M(i0,c);
+      scalar m1 = M(i1,c);
+      M(i0,c) = X[0][0]*m0 + X[0][1]*m1;
+      M(i1,c) = X[1][0]*m0 + X[1][1]*m1;
+    }
+  }
+
+  static inline void UpdateLink(sobj &link,const sobj &staple,RealD scale,GridPhiloxStream &rng,
+				bool heatbath,int noverrelax,int nheatbath,uint64_t &hits,uint64_t &accepted)
+  {
+    const RealD twopi = 2.0*M_PI;
+    auto &L = link()();
+    auto V  = L*staple()();
+    V = V*scalar(scale);
+
+    const int nsub = (Nc*(Nc-1))/2;
+    const int npass = (heatbath ? 1 : 0) + noverrelax;
+    for(int pass=0;pass<npass;pass++){
+      const bool hb = heatbath && (pass==0);
+      for(int su2=0;su2<nsub;su2++){
+	int i0, i1;
+	SU<Nc>::su2SubGroupIndex(i0,i1,su2);
+
+	RealD r0 =  real(V(i0,i0)+V(i1,i1));
+	RealD r1 = -imag(V(i0,i1)+V(i1,i0));
+	RealD r2 =  real(V(i1,i0)-V(i0,i1));
+	RealD r3 = -imag(V(i0,i0)-V(i1,i1));
+	RealD k  = std::sqrt(r0*r0+r1*r1+r2*r2+r3*r3);
+	if ( k < 1.0e-12 ) continue;   // subgroup projects to zero; leave it
+	scalar Q[2][2], Y[2][2], X[2][2];
+	Quaternion(Q,r0/k,r1/k,r2/k,r3/k);
+
+	if ( hb ) {
+	  //////////////////////////////////////////
+	  // Kennedy-Pendleton, PLB 156 P393 (1985): y0 with weight
+	  // (1-y0^2)^1/2 exp(k y0), alpha = k
+	  //////////////////////////////////////////
+	  hits++;
+	  RealD d = 0.0;
+	  bool ok = false;
+	  for(int t=0;(t<nheatbath)&&(!ok);t++){
+	    RealD R0 = Uniform(rng);
+	    RealD X1 = -std::log(Uniform(rng))/k;
+	    RealD X2 = -std::log(Uniform(rng))/k;
+	    RealD C  =  std::cos(twopi*Uniform(rng));
+	    d  = X2 + X1*C*C;
+	    ok = (R0*R0 <= 1.0-0.5*d);
+	  }
+	  if ( !ok ) continue;
+	  accepted++;
+	  RealD y0  = 1.0-d;
+	  RealD mag = std::sqrt(std::fabs(1.0-y0*y0));
+	  RealD cth = 2.0*Uniform(rng)-1.0;
+	  RealD sth = std::sqrt(std::fabs(1.0-cth*cth));
+	  RealD phi = twopi*Uniform(rng);
+	  Quaternion(Y,y0,mag*sth*std::cos(phi),mag*sth*std::sin(phi),mag*cth);
+	} else {
+	  for(int i=0;i<2;i++) for(int j=0;j<2;j++) Y[i][j] = Q[i][j];
+	}
+	for(int i=0;i<2;i++){
+	  for(int j=0;j<2;j++){
+	    X[i][j] = Y[i][0]*Q[0][j] + Y[i][1]*Q[1][j];
+	  }
+	}
+	RotateRows(L,X,i0,i1);
+	RotateRows(V,X,i0,i1);
+      }
+    }
+  }
+
+  GridBase *_grid;
+  GridRedBlackCartesian *_rbgrid;
+  std::shared_ptr<GaugeStencil<Gimpl> > _stencil;
+  GaugeLinkField _link, _staple;
+  GaugeLinkField _link_cb, _staple_cb;
+  std::vector<uint64_t> _gsite[2];
+};
+
+NAMESPACE_END(Grid);
+
+#endif
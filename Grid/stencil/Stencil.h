@@ -106,6 +106,34 @@ void Gather_plane_exchange_table(Vector<std::pair<int,int> >& table,const Lattic
   });
 }
 
+///////////////////////////////////////////////////////////////////
+// Range restricted bodies of the above, called from the fused face
+// gather where one threaded sweep covers every face of every leg
+///////////////////////////////////////////////////////////////////
+template<class vobj,class cobj,class compressor>
+inline void Gather_plane_simple_range(const std::pair<int,int> *table,const vobj *rhs_p,cobj *buffer,
+				      compressor &compress,int off,int so,uint64_t lo,uint64_t hi)
+{
+  for(uint64_t i=lo;i<hi;i++){
+    cobj tmp_c;
+    uint64_t o = table[i].first;
+    compress.Compress(&tmp_c,0,rhs_p[so+table[i].second]);
+    buffer[off+o] = tmp_c;
+  }
+}
+
+template<class vobj,class cobj,class compressor>
+inline void Gather_plane_exchange_range(const std::pair<int,int> *table,const vobj *rhs_p,cobj *p0,cobj *p1,
+					compressor &compress,int so,int type,uint64_t lo,uint64_t hi)
+{
+  for(uint64_t j=lo;j<hi;j++){
+    compress.CompressExchange(p0,p1,rhs_p,j,
+			      so+table[2*j  ].second,
+			      so+table[2*j+1].second,
+			      type);
+  }
+}
+
 struct StencilEntry { 
 #ifdef GRID_NVCC
   uint64_t _byte_offset;       // 8 bytes 
@@ -211,6 +239,24 @@ public:
     cobj * mpi_p;
     Integer buffer_size;
   };
+  // Plain data: the range body is a function pointer instantiated per
+  // compressor, and the compressor is copied in place, so queueing a face
+  // never touches the heap once GatherTasks has grown to size
+  enum { GatherCompressorBytes=64 };
+  struct GatherTask {
+    int      point;
+    int      simd;      // 1 for a SIMD lane exchange face
+    uint64_t sites;
+    int      face;      // index into face_table
+    const vobj *rhs_p;
+    cobj    *buf0;      // send buffer, or low half of an exchange face
+    cobj    *buf1;      // high half of an exchange face
+    int      off;
+    int      so;
+    int      type;
+    void   (*kernel)(const GatherTask &,const std::pair<int,int> *,uint64_t,uint64_t);
+    alignas(16) unsigned char compress[GatherCompressorBytes];
+  };
   
 
 protected:
@@ -241,6 +287,8 @@ public:
   std::vector<Merge> MergersSHM;
   std::vector<Decompress> Decompressions;
   std::vector<Decompress> DecompressionsSHM;
+  std::vector<GatherTask> GatherTasks;
+  int gather_point;
 
   ///////////////////////////////////////////////////////////
   // Unified Comms buffers for all directions
@@ -276,6 +324,18 @@ public:
   std::vector<double> comm_time_thr;
   std::vector<double> comm_enter_thr;
   std::vector<double> comm_leave_thr;
+  std::vector<double> gather_time_dir;
+  std::vector<double> gather_bytes_dir;
+  // Progress thread exchange: time in flight, and time the caller waited for it
+  double commprogresstime;
+  double commwaittime;
+  double progress_begin;
+  std::vector<double> progress_bytes;
+  std::vector<double> progress_done;
+  std::shared_ptr<std::atomic<int> > progress_pending;
+  std::vector<Packet> persistent_packets;
+  std::vector<std::vector<CommsRequest_t> > persistent_reqs;
+  std::vector<double> persistent_bytes;
 
   ////////////////////////////////////////
   // Stencil query
@@ -373,12 +433,76 @@ public:
     commtime+= last-first;
   }
   ////////////////////////////////////////////////////////////////////////
+  // Persistent requests. The packet list is regenerated by every gather but
+  // its geometry is fixed by the stencil, so the requests are bound on the
+  // first exchange and rebound only if a packet ever differs.
+  ////////////////////////////////////////////////////////////////////////
+  void PersistentBind(void)
+  {
+    int same = (persistent_packets.size()==Packets.size());
+    for(int i=0;same && i<Packets.size();i++){
+      same = (persistent_packets[i].send_buf ==Packets[i].send_buf)
+	&&   (persistent_packets[i].recv_buf ==Packets[i].recv_buf)
+	&&   (persistent_packets[i].to_rank  ==Packets[i].to_rank)
+	&&   (persistent_packets[i].from_rank==Packets[i].from_rank)
+	&&   (persistent_packets[i].bytes    ==Packets[i].bytes);
+    }
+    if ( same ) return;
+
+    for(int i=0;i<persistent_reqs.size();i++){
+      _grid->StencilSendToRecvFromPersistentFree(persistent_reqs[i]);
+    }
+    persistent_packets = Packets;
+    persistent_reqs.resize(Packets.size());
+    persistent_bytes.resize(Packets.size());
+    for(int i=0;i<Packets.size();i++){
+      persistent_reqs[i].resize(0);
+      persistent_bytes[i]=_grid->StencilSendToRecvFromPersistentInit(persistent_reqs[i],
+								     Packets[i].send_buf,
+								     Packets[i].to_rank,
+								     Packets[i].recv_buf,
+								     Packets[i].from_rank,
+								     Packets[i].bytes,i);
+    }
+  }
+  ////////////////////////////////////////////////////////////////////////
   // Non blocking send and receive. Necessarily parallel.
   ////////////////////////////////////////////////////////////////////////
   void CommunicateBegin(std::vector<std::vector<CommsRequest_t> > &reqs)
   {
     reqs.resize(Packets.size());
     commtime-=usecond();
+    if ( CommsProgress::Active() ) {
+      // Hand the packets to the progress threads and return to compute
+      progress_begin = usecond();
+      progress_bytes.resize(Packets.size());
+      progress_done.resize(Packets.size());
+      progress_pending->store(Packets.size(),std::memory_order_release);
+      for(int i=0;i<Packets.size();i++){
+	CommsProgress::Request r;
+	r.comm = _grid;
+	r.xmit = Packets[i].send_buf;
+	r.dest = Packets[i].to_rank;
+	r.recv = Packets[i].recv_buf;
+	r.from = Packets[i].from_rank;
+	r.bytes= Packets[i].bytes;
+	r.dir  = i;
+	r.pending       = progress_pending.get();
+	r.offnode_bytes = &progress_bytes[i];
+	r.done_time     = &progress_done[i];
+	CommsProgress::Post(i%CommsProgress::nThreads,r);
+      }
+      return;
+    }
+    if ( CartesianCommunicator::PersistentComms ) {
+      PersistentBind();
+      for(int i=0;i<Packets.size();i++){
+	_grid->StencilSendToRecvFromPersistentStart(persistent_reqs[i],i);
+	comms_bytes+=persistent_bytes[i];
+	shm_bytes  +=2*Packets[i].bytes-persistent_bytes[i];
+      }
+      return;
+    }
     for(int i=0;i<Packets.size();i++){
       uint64_t bytes=_grid->StencilSendToRecvFromBegin(reqs[i],
 						     Packets[i].send_buf,
@@ -393,6 +517,28 @@ public:
 
   void CommunicateComplete(std::vector<std::vector<CommsRequest_t> > &reqs)
   {
+    if ( CommsProgress::Active() ) {
+      double t0=usecond();
+      while ( progress_pending->load(std::memory_order_acquire) ) ;
+      double t1=usecond();
+      double done = progress_begin;
+      for(int i=0;i<Packets.size();i++){
+	comms_bytes+=progress_bytes[i];
+	shm_bytes  +=2*Packets[i].bytes-progress_bytes[i];
+	done = std::max(done,progress_done[i]);
+      }
+      commwaittime     += t1-t0;
+      commprogresstime += done-progress_begin;
+      commtime+=t1;
+      return;
+    }
+    if ( CartesianCommunicator::PersistentComms ) {
+      for(int i=0;i<Packets.size();i++){
+	_grid->StencilSendToRecvFromPersistentComplete(persistent_reqs[i],i);
+      }
+      commtime+=usecond();
+      return;
+    }
     for(int i=0;i<Packets.size();i++){
       _grid->StencilSendToRecvFromComplete(reqs[i],i);
     }
@@ -460,6 +606,7 @@ public:
     int splice_dim      = _grid->_simd_layout[dimension]>1 && (comm_dim);
 
     int is_same_node = 1;
+    gather_point = point;
     // Gather phase
     int sshift [2];
     if ( comm_dim ) {
@@ -517,6 +664,7 @@ public:
       compress.Point(point);
       HaloGatherDir(source,compress,point,face_idx);
     }
+    GatherFaces();
     face_table_computed=1;
     assert(u_comm_offset==_unified_buffer_size);
 
@@ -534,8 +682,88 @@ public:
     Mergers.resize(0); 
     MergersSHM.resize(0); 
     Packets.resize(0);
+    GatherTasks.resize(0);
     calls++;
   }
+  ////////////////////////////////////////////////////////////////////////
+  // Face gathers are queued while the legs are walked and the packets
+  // set up, then GatherFaces runs them all in one threaded sweep: each
+  // thread takes a contiguous slice of the concatenated faces, so small
+  // faces at high node counts no longer each pay a fork/join.
+  // Device builds keep launching a kernel per face.
+  ////////////////////////////////////////////////////////////////////////
+  template<class compressor>
+  static void GatherSimpleKernel(const GatherTask &g,const std::pair<int,int> *table,uint64_t lo,uint64_t hi) {
+    compressor c = *(const compressor *)g.compress;
+    Gather_plane_simple_range(table,g.rhs_p,g.buf0,c,g.off,g.so,lo,hi);
+  }
+  template<class compressor>
+  static void GatherExchangeKernel(const GatherTask &g,const std::pair<int,int> *table,uint64_t lo,uint64_t hi) {
+    compressor c = *(const compressor *)g.compress;
+    Gather_plane_exchange_range(table,g.rhs_p,g.buf0,g.buf1,c,g.so,g.type,lo,hi);
+  }
+  template<class compressor>
+  void AddGather(int simd,uint64_t sites,uint64_t bytes,int face,const vobj *rhs_p,
+		 cobj *buf0,cobj *buf1,int off,int so,int type,const compressor &compress) {
+    static_assert(std::is_trivially_copyable<compressor>::value,"compressor is copied as plain data");
+    static_assert(sizeof(compressor)<=GatherCompressorBytes,"compressor too large for a GatherTask");
+    static_assert(alignof(compressor)<=16,"compressor over aligned for a GatherTask");
+    GatherTask g;
+    g.point = gather_point;
+    g.simd  = simd;
+    g.sites = sites;
+    g.face  = face;
+    g.rhs_p = rhs_p;
+    g.buf0  = buf0;
+    g.buf1  = buf1;
+    g.off   = off;
+    g.so    = so;
+    g.type  = type;
+    g.kernel= simd ? GatherExchangeKernel<compressor> : GatherSimpleKernel<compressor>;
+    memcpy((void *)g.compress,(const void *)&compress,sizeof(compressor));
+    gather_bytes_dir[gather_point] += bytes;
+    GatherTasks.push_back(g);
+  }
+  void GatherFaces(void) {
+    const int ntask = GatherTasks.size();
+    if ( ntask == 0 ) return;
+
+    std::vector<uint64_t> start(ntask+1);
+    start[0]=0;
+    for(int i=0;i<ntask;i++) start[i+1] = start[i] + GatherTasks[i].sites;
+    const uint64_t total = start[ntask];
+
+    const int nthr   = GridThread::GetThreads();
+    const int npoint = this->_npoints;
+    std::vector<double> thr_time(nthr*npoint,0.0);
+    std::vector<double> thr_simd(nthr,0.0);
+    std::vector<double> thr_plain(nthr,0.0);
+
+    thread_for(t,nthr,{
+      uint64_t lo = (total* t   )/nthr;
+      uint64_t hi = (total*(t+1))/nthr;
+      for(int i=0;i<ntask;i++){
+	uint64_t a = std::max(lo,start[i]);
+	uint64_t b = std::min(hi,start[i+1]);
+	if ( a < b ) {
+	  double t0=usecond();
+	  const GatherTask &g = GatherTasks[i];
+	  g.kernel(g,&face_table[g.face][0],a-start[i],b-start[i]);
+	  double dt=usecond()-t0;
+	  thr_time[t*npoint+GatherTasks[i].point] += dt;
+	  if ( GatherTasks[i].simd ) thr_simd[t] += dt;
+	  else                       thr_plain[t]+= dt;
+	}
+      }
+    });
+    // Attribute the sweep as the thread average per leg
+    for(int t=0;t<nthr;t++){
+      for(int p=0;p<npoint;p++) gather_time_dir[p] += thr_time[t*npoint+p]/nthr;
+      gathertime  += thr_plain[t]/nthr;
+      gathermtime += thr_simd[t]/nthr;
+    }
+    GatherTasks.resize(0);
+  }
   void AddPacket(void *xmit,void * rcv, Integer to,Integer from,Integer bytes){
     Packet p;
     p.send_buf = xmit;
@@ -633,6 +861,13 @@ public:
     }
   }
 
+  ~CartesianStencil()
+  {
+    for(int i=0;i<persistent_reqs.size();i++){
+      _grid->StencilSendToRecvFromPersistentFree(persistent_reqs[i]);
+    }
+  }
+
   CartesianStencil(GridBase *grid,
 		   int npoints,
 		   int checkerboard,
@@ -640,12 +875,15 @@ public:
 		   const std::vector<int> &distances,
 		   Parameters p) 
     : shm_bytes_thr(npoints), 
+      gather_time_dir(npoints),
+      gather_bytes_dir(npoints),
       comm_bytes_thr(npoints), 
       comm_enter_thr(npoints),
       comm_leave_thr(npoints), 
       comm_time_thr(npoints)
   {
     face_table_computed=0;
+    progress_pending = std::make_shared<std::atomic<int> >(0);
     _grid    = grid;
     this->parameters=p;
     /////////////////////////////////////
@@ -1039,10 +1277,19 @@ public:
 	  shm_receive_only = 0;
 	}
 
-	gathertime-=usecond();
 	assert(send_buf!=NULL);
-	Gather_plane_simple_table(face_table[face_idx],rhs,send_buf,compress,u_comm_offset,so);  face_idx++;
+#ifdef GRID_NVCC
+	gathertime-=usecond();
+	Gather_plane_simple_table(face_table[face_idx],rhs,send_buf,compress,u_comm_offset,so);
 	gathertime+=usecond();
+#else
+	{
+	  auto rhs_v = rhs.View();
+	  AddGather(0,face_table[face_idx].size(),bytes,face_idx,&rhs_v[0],
+		    send_buf,(cobj *)NULL,u_comm_offset,so,0,compress);
+	}
+#endif
+	face_idx++;
 	
 	if ( compress.DecompressionStep() ) {
 	  
@@ -1140,11 +1387,20 @@ public:
 	  face_table.resize(face_idx+1);
 	  Gather_plane_table_compute ((GridBase *)_grid,dimension,sx,cbmask,u_comm_offset,face_table[face_idx]);
 	}
+#ifdef GRID_NVCC
 	gathermtime-=usecond();
-
-	Gather_plane_exchange_table(face_table[face_idx],rhs,spointers,dimension,sx,cbmask,compress,permute_type);  face_idx++;
-
+	Gather_plane_exchange_table(face_table[face_idx],rhs,spointers,dimension,sx,cbmask,compress,permute_type);
 	gathermtime+=usecond();
+#else
+	{
+	  assert( (face_table[face_idx].size()&0x1)==0);
+	  auto rhs_v = rhs.View();
+	  int so   = sx*rhs.Grid()->_ostride[dimension];
+	  AddGather(1,face_table[face_idx].size()/2,reduced_buffer_size*datum_bytes,face_idx,&rhs_v[0],
+		    spointers[0],spointers[1],0,so,permute_type,compress);
+	}
+#endif
+	face_idx++;
 	//spointers[0] -- low
 	//spointers[1] -- high
 
@@ -1211,6 +1467,8 @@ public:
   void ZeroCounters(void) {
     gathertime = 0.;
     commtime = 0.;
+    commprogresstime = 0.;
+    commwaittime = 0.;
     mpi3synctime=0.;
     mpi3synctime_g=0.;
     shmmergetime=0.;
@@ -1220,6 +1478,8 @@ public:
       comm_enter_thr[i]=0;
       comm_leave_thr[i]=0;
       shm_bytes_thr[i]=0;
+      gather_time_dir[i]=0;
+      gather_bytes_dir[i]=0;
     }
     halogtime = 0.;
     mergetime = 0.;
@@ -1257,6 +1517,14 @@ public:
       PRINTIT(halogtime);
       PRINTIT(gathertime);
       PRINTIT(gathermtime);
+      for(int p=0;p<this->_npoints;p++){
+	if ( gather_time_dir[p] > 0.0 ) {
+	  std::cout << GridLogMessage << " Stencil gathertime leg "<<p
+		    <<" dir "<<this->_directions[p]<<" disp "<<this->_distances[p]
+		    <<" "<<gather_time_dir[p]/calls<<" us "
+		    <<gather_bytes_dir[p]/gather_time_dir[p]/1000.<<" GB/s"<<std::endl;
+	}
+      }
       PRINTIT(mergetime);
       PRINTIT(decompresstime);
       if(comms_bytes>1.0){
@@ -1265,6 +1533,12 @@ public:
 	std::cout << GridLogMessage << " Stencil " << comms_bytes/commtime/1000. << " GB/s per rank"<<std::endl;
 	std::cout << GridLogMessage << " Stencil " << comms_bytes/commtime/1000.*NP/NN << " GB/s per node"<<std::endl;
       }
+      if(commprogresstime>0.0){
+	PRINTIT(commprogresstime);
+	PRINTIT(commwaittime);
+	std::cout << GridLogMessage << " Stencil progress thread overlap "
+		  << 100.0*(1.0-commwaittime/commprogresstime) << " %"<<std::endl;
+      }
       if(shm_bytes>1.0){
 	PRINTIT(shm_bytes); // X bytes + R bytes
 	                    // Double this to include spin projection overhead with 2:1 ratio in wilson
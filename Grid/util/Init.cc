@@ -87,6 +87,8 @@ static Coordinate Grid_default_mpi;
 int GridThread::_threads =1;
 int GridThread::_hyperthreads=1;
 int GridThread::_cores=1;
+int GridParallelRNG::CounterBased=0;
+int GaugeStencilBase::Fused=0;
 
 
 const Coordinate &GridDefaultLatt(void)     {return Grid_default_latt;};
@@ -428,6 +430,54 @@ void Grid_init(int *argc,char ***argv)
     MemoryProfiler::stats = &dbgMemStats;
   }
 
+#ifdef POINTER_CACHE
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--alloc-cache") ){
+    arg= GridCmdOptionPayload(*argv,*argv+*argc,"--alloc-cache");
+    GridCmdOptionInt(arg,PointerCache::Ncache);
+    assert(PointerCache::Ncache >= 0);
+  }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--alloc-cache-mb") ){
+    int MB;
+    arg= GridCmdOptionPayload(*argv,*argv+*argc,"--alloc-cache-mb");
+    GridCmdOptionInt(arg,MB);
+    uint64_t MB64 = MB;
+    PointerCache::MaxBytes = MB64*1024LL*1024LL;
+  } else {
+    PointerCache::MaxBytes = PointerCache::DefaultBytes();
+  }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--alloc-cache-nozero") ){
+    PointerCache::ZeroRecycled = 0;
+  }
+#endif
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--numa") ){
+    arg= GridCmdOptionPayload(*argv,*argv+*argc,"--numa");
+    if      ( arg == "touch"      ) NumaPolicy::Policy = NumaPolicy::FirstTouch;
+    else if ( arg == "sites"      ) NumaPolicy::Policy = NumaPolicy::SiteTouch;
+    else if ( arg == "interleave" ) NumaPolicy::Policy = NumaPolicy::Interleave;
+    else { 
+      std::cout << GridLogError << "--numa "<<arg<<" : expected touch, sites or interleave"<<std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--numa-bind") ){
+    arg= GridCmdOptionPayload(*argv,*argv+*argc,"--numa-bind");
+    GridCmdOptionInt(arg,NumaPolicy::Node);
+    assert(NumaPolicy::Node >= 0);
+    NumaPolicy::Policy = NumaPolicy::Bind;
+  }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--alloc-hugepages") ){
+    arg= GridCmdOptionPayload(*argv,*argv+*argc,"--alloc-hugepages");
+    if      ( arg == "madvise" ) HugePagePolicy::Mode = HugePagePolicy::Madvise;
+    else if ( arg == "hugetlb" ) HugePagePolicy::Mode = HugePagePolicy::Hugetlb;
+    else { 
+      std::cout << GridLogError << "--alloc-hugepages "<<arg<<" : expected madvise or hugetlb"<<std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+  if ( NumaPolicy::Policy != NumaPolicy::FirstTouch ) {
+    std::cout << GridLogMessage << "Lattice allocations are "<< NumaPolicy::Name() <<std::endl;
+  }
+
   ////////////////////////////////////
   // Logging
   ////////////////////////////////////
@@ -458,6 +508,16 @@ void Grid_init(int *argc,char ***argv)
     std::cout<<GridLogMessage<<"  --shm  M        : allocate M megabytes of shared memory for comms"<<std::endl;
     std::cout<<GridLogMessage<<"  --shm-hugepages : use explicit huge pages in mmap call "<<std::endl;    
     std::cout<<GridLogMessage<<std::endl;
+    std::cout<<GridLogMessage<<"Memory:"<<std::endl;
+    std::cout<<GridLogMessage<<std::endl;
+    std::cout<<GridLogMessage<<"  --alloc-cache n       : recycle up to n freed blocks per allocation size class"<<std::endl;
+    std::cout<<GridLogMessage<<"  --alloc-cache-mb M    : retain at most M megabytes of freed blocks (0 no limit,"<<std::endl;
+    std::cout<<GridLogMessage<<"                          default an eighth of node memory over the ranks)"<<std::endl;
+    std::cout<<GridLogMessage<<"  --alloc-cache-nozero  : do not zero recycled blocks on reallocation"<<std::endl;
+    std::cout<<GridLogMessage<<"  --numa touch|sites|interleave : NUMA placement of lattice allocations"<<std::endl;
+    std::cout<<GridLogMessage<<"  --numa-bind n         : place lattice allocations on NUMA node n"<<std::endl;
+    std::cout<<GridLogMessage<<"  --alloc-hugepages madvise|hugetlb : back lattice allocations with huge pages"<<std::endl;
+    std::cout<<GridLogMessage<<std::endl;
     std::cout<<GridLogMessage<<"Verbose and debug:"<<std::endl;
     std::cout<<GridLogMessage<<std::endl;
     std::cout<<GridLogMessage<<"  --log list      : comma separated list from Error,Warning,Message,Performance,Iterative,Integrator,Debug,Colours"<<std::endl;
@@ -472,6 +532,10 @@ void Grid_init(int *argc,char ***argv)
     std::cout<<GridLogMessage<<"  --comms-concurrent : Asynchronous MPI calls; several dirs at a time "<<std::endl;    
     std::cout<<GridLogMessage<<"  --comms-sequential : Synchronous MPI calls; one dirs at a time "<<std::endl;    
     std::cout<<GridLogMessage<<"  --comms-overlap    : Overlap comms with compute "<<std::endl;    
+    std::cout<<GridLogMessage<<"  --comms-threads n  : Threads driving stencil comms (default 1)"<<std::endl;    
+    std::cout<<GridLogMessage<<"  --comms-progress   : Dedicated comms progress threads, pinned to spare cores"<<std::endl;    
+    std::cout<<GridLogMessage<<"  --comms-progress-threads n : Number of comms progress threads (default 1)"<<std::endl;    
+    std::cout<<GridLogMessage<<"  --comms-persistent : Persistent MPI requests for stencil halo exchange; not with --comms-progress"<<std::endl;    
     std::cout<<GridLogMessage<<std::endl;
     std::cout<<GridLogMessage<<"  --dslash-generic: Wilson kernel for generic Nc"<<std::endl;    
     std::cout<<GridLogMessage<<"  --dslash-unroll : Wilson kernel for Nc=3"<<std::endl;    
@@ -480,6 +544,14 @@ void Grid_init(int *argc,char ***argv)
     std::cout<<GridLogMessage<<"  --lebesgue      : Cache oblivious Lebesgue curve/Morton order/Z-graph stencil looping"<<std::endl;    
     std::cout<<GridLogMessage<<"  --cacheblocking n.m.o.p : Hypercuboidal cache blocking"<<std::endl;    
     std::cout<<GridLogMessage<<std::endl;
+    std::cout<<GridLogMessage<<"  --rng-counter   : Counter based (Philox) parallel RNG; decomposition independent"<<std::endl;    
+    std::cout<<GridLogMessage<<"  --gauge-stencil : Fused staple/plaquette kernels on a halo padded gauge field"<<std::endl;    
+    std::cout<<GridLogMessage<<std::endl;
+    std::cout<<GridLogMessage<<"  --io-aggregators n : n ranks per node gather and write/read lattice files with pwrite/pread"<<std::endl;    
+    std::cout<<GridLogMessage<<"  --io-stripe bytes  : Align and cap aggregated I/O requests to the file system stripe"<<std::endl;    
+    std::cout<<GridLogMessage<<"  --io-mmap          : Read lattice files through mmap straight into the field"<<std::endl;    
+    std::cout<<GridLogMessage<<"  --io-mmap-window b : Map at most b bytes of the file at once, default 256MB"<<std::endl;    
+    std::cout<<GridLogMessage<<std::endl;
     exit(EXIT_SUCCESS);
   }
 
@@ -522,6 +594,53 @@ void Grid_init(int *argc,char ***argv)
     GridCmdOptionInt(arg,CartesianCommunicator::nCommThreads);
     assert(CartesianCommunicator::nCommThreads > 0);
   }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--comms-persistent") ){
+    CartesianCommunicator::PersistentComms=1;
+  }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--comms-progress") ){
+    int nprogress = 1;
+    if( GridCmdOptionExists(*argv,*argv+*argc,"--comms-progress-threads") ){
+      arg= GridCmdOptionPayload(*argv,*argv+*argc,"--comms-progress-threads");
+      GridCmdOptionInt(arg,nprogress);
+      assert(nprogress > 0);
+    }
+    CommsProgress::Start(nprogress);
+  } else if( GridCmdOptionExists(*argv,*argv+*argc,"--comms-progress-threads") ){
+    std::cout << GridLogWarning << "--comms-progress-threads ignored without --comms-progress"<<std::endl;
+  }
+  // Progress threads post their own requests; persistent ones would never be started
+  if( CommsProgress::Active() && CartesianCommunicator::PersistentComms ){
+    std::cout << GridLogWarning << "--comms-persistent ignored: comms progress threads drive the halo exchange"<<std::endl;
+    CartesianCommunicator::PersistentComms=0;
+  }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--io-aggregators") ){
+    arg= GridCmdOptionPayload(*argv,*argv+*argc,"--io-aggregators");
+    GridCmdOptionInt(arg,BinaryIO::ioAggregators);
+    assert(BinaryIO::ioAggregators >= 0);
+  }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--io-stripe") ){
+    int stripe;
+    arg= GridCmdOptionPayload(*argv,*argv+*argc,"--io-stripe");
+    GridCmdOptionInt(arg,stripe);
+    assert(stripe >= 0);
+    BinaryIO::ioStripe = stripe;
+  }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--io-mmap") ){
+    BinaryIO::ioMmap=1;
+  }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--io-mmap-window") ){
+    int window;
+    arg= GridCmdOptionPayload(*argv,*argv+*argc,"--io-mmap-window");
+    GridCmdOptionInt(arg,window);
+    assert(window > 0);
+    BinaryIO::ioMmapWindow = window;
+  }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--rng-counter") ){
+    GridParallelRNG::CounterBased=1;
+  }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--gauge-stencil") ){
+    GaugeStencilBase::Fused=1;
+  }
   if( GridCmdOptionExists(*argv,*argv+*argc,"--cacheblocking") ){
     arg= GridCmdOptionPayload(*argv,*argv+*argc,"--cacheblocking");
     GridCmdOptionIntVector(arg,LebesgueOrder::Block);
@@ -552,6 +671,11 @@ void Grid_init(int *argc,char ***argv)
 
 void Grid_finalize(void)
 {
+#ifdef POINTER_CACHE
+  if ( MemoryProfiler::debug ) PointerCache::Report();
+#endif
+  HugePagePolicy::Report();
+  CommsProgress::Stop();
 #if defined (GRID_COMMS_MPI) || defined (GRID_COMMS_MPI3) || defined (GRID_COMMS_MPIT)
   MPI_Finalize();
   Grid_unquiesce_nodes();
@@ -32,6 +32,11 @@ See the full license in the file "LICENSE" in the top level distribution directo
 #include <Hadrons/Global.hpp>
 #include <Hadrons/TimerArray.hpp>
 #include <Grid/Eigen/unsupported/CXX11/Tensor>
+#include <future>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #ifdef USE_MKL
 #include "mkl.h"
 #include "mkl_cblas.h"
@@ -47,6 +52,14 @@ See the full license in the file "LICENSE" in the top level distribution directo
 
 #define HADRONS_A2AM_PARALLEL_IO
 
+// collective MPI-IO writes are available when HDF5 is built with the parallel
+// driver and can write collectively to filtered (Fletcher32) datasets
+#if defined(HAVE_HDF5) && defined(H5_HAVE_PARALLEL) && defined(GRID_COMMS_MPI3)
+#if H5_VERSION_GE(1,10,2)
+#define HADRONS_A2AM_COLLECTIVE_IO
+#endif
+#endif
+
 BEGIN_HADRONS_NAMESPACE
 
 // general A2A matrix set based on Eigen tensors and Grid-allocated memory
@@ -107,13 +120,84 @@ public:
                    const unsigned int blockSizei, const unsigned int blockSizej);
     void saveBlock(const A2AMatrixSet<T> &m, const unsigned int ext, const unsigned int str,
                    const unsigned int i, const unsigned int j);
+#ifdef HADRONS_A2AM_COLLECTIVE_IO
+    // collective block I/O, all ranks of grid call it and each writes
+    // the time slices [t0, t0 + ntLoc) of the block
+    void saveBlockCollective(const T *data, const unsigned int i, const unsigned int j,
+                             const unsigned int blockSizei, const unsigned int blockSizej,
+                             const unsigned int t0, const unsigned int ntLoc,
+                             GridBase *grid);
+    void saveBlockCollective(const A2AMatrixSet<T> &m, const unsigned int ext, 
+                             const unsigned int str, const unsigned int i, 
+                             const unsigned int j, GridBase *grid);
+#endif
     template <template <class> class Vec, typename VecT>
     void load(Vec<VecT> &v, double *tRead = nullptr, GridBase *grid = nullptr);
+private:
+    template <typename S, template <class> class Vec, typename VecT>
+    void loadMap(Vec<VecT> &v, double *tRead);
 private:
     std::string  filename_{""}, dataname_{""};
     unsigned int nt_{0}, ni_{0}, nj_{0};
 };
 
+/******************************************************************************
+ *            Memory-mapped flat A2A matrix file (time slice major)           *
+ ******************************************************************************/
+// Layout: one page holding A2AMatrixMapHeader, then nt row-major ni x nj
+// slices, each starting on a page boundary. Slices are served straight from
+// the page cache, so repeated passes over a matrix cost no reads or parsing.
+// A2AMatrixIo::load recognises these files, and convert() makes one out of
+// an HDF5 file written by A2AMatrixBlockComputation.
+struct A2AMatrixMapHeader
+{
+    char     magic[8];
+    uint32_t version, typeSize, nt, ni, nj, pad;
+    uint64_t sliceStride, dataOffset;
+};
+
+template <typename T>
+class A2AMatrixMap
+{
+public:
+    typedef Eigen::Map<A2AMatrix<T>>       Slice;
+    typedef Eigen::Map<const A2AMatrix<T>> ConstSlice;
+public:
+    // constructors
+    A2AMatrixMap(void) = default;
+    A2AMatrixMap(const std::string filename);
+    A2AMatrixMap(A2AMatrixMap<T> &&m);
+    A2AMatrixMap(const A2AMatrixMap<T> &m) = delete;
+    // destructor
+    ~A2AMatrixMap(void);
+    // file management
+    static bool  isMapFile(const std::string filename, unsigned int *typeSize = nullptr);
+    void         open(const std::string filename);
+    void         create(const std::string filename, const unsigned int nt,
+                        const unsigned int ni, const unsigned int nj);
+    void         close(void);
+    // access
+    unsigned int getNt(void) const;
+    unsigned int getNi(void) const;
+    unsigned int getNj(void) const;
+    ConstSlice   operator[](const unsigned int t) const;
+    Slice        operator[](const unsigned int t);
+    // ask the kernel to start reading slice t
+    void         prefetch(const unsigned int t) const;
+    // HDF5 to mapped file conversion, TIo is the HDF5 data type
+    template <typename TIo = T>
+    static void  convert(const std::string mapFilename, const std::string h5Filename,
+                         const std::string dataname, const unsigned int nt);
+private:
+    static constexpr const char *magic_ = "A2AMMAP1";
+    static constexpr size_t     page_   = 4096;
+    std::string        filename_{""};
+    A2AMatrixMapHeader header_;
+    char               *map_{nullptr};
+    size_t             mapSize_{0};
+    bool               writable_{false};
+};
+
 /******************************************************************************
  *                  Wrapper for A2A matrix block computation                  *
  ******************************************************************************/
@@ -145,13 +229,28 @@ public:
                  const FilenameFn &ionameFn,
                  const FilenameFn &filenameFn,
                  const MetadataFn &metadataFn);
+    // write block n to disk in the background while block n + 1 is computed;
+    // off by default. The writer thread calls HDF5 while execute() runs, so
+    // nothing else may use HDF5 concurrently unless the library is built
+    // thread-safe. execute() waits for the last block before returning.
+    void setPipelinedIo(const bool pipelined);
+    // with fewer files than ranks, have every rank write a slice of each file
+    // through collective MPI-IO; off by default
+    void setCollectiveIo(const bool collective);
 private:
     // I/O handler
     void saveBlock(const A2AMatrixSet<TIo> &m, IoHelper &h);
+    void makeIoTasks(std::vector<IoHelper> &task, const unsigned int i,
+                     const unsigned int j, const unsigned int N_i, 
+                     const unsigned int N_j, const FilenameFn &ionameFn,
+                     const FilenameFn &filenameFn, const MetadataFn &metadataFn);
+    static double saveTasks(const A2AMatrixSet<TIo> m, std::vector<IoHelper> task,
+                            const unsigned int blockSize);
 private:
     TimerArray            *tArray_;
     GridBase              *grid_;
     unsigned int          orthogDim_, nt_, next_, nstr_, blockSize_, cacheBlockSize_;
+    bool                  pipelined_{false}, collective_{false};
     Vector<T>             mCache_;
     Vector<TIo>           mBuf_;
     std::vector<IoHelper> nodeIo_;
@@ -274,8 +373,32 @@ public:
         res = a*b;
     }
 #endif
+    // mul(res, a, b) with b a read-only view, e.g. a memory-mapped time slice
     template <typename Mat>
-    static inline double mulFlops(const Mat &a, const Mat &b)
+    static inline void mul(Mat &res, const Mat &a, const Eigen::Ref<const Mat> &b)
+    {
+#ifdef USE_MKL
+        if (std::is_same<typename Mat::Scalar, ComplexD>::value and
+            (Mat::Options == Eigen::RowMajor))
+        {
+            static const ComplexD one(1., 0.), zero(0., 0.);
+
+            if ((res.rows() != a.rows()) or (res.cols() != b.cols()))
+            {
+                res.resize(a.rows(), b.cols());
+            }
+            cblas_zgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, a.rows(), b.cols(),
+                        a.cols(), &one, a.data(), a.cols(), b.data(), b.outerStride(), 
+                        &zero, res.data(), res.cols());
+
+            return;
+        }
+#endif
+        res = a*b;
+    }
+
+    template <typename MatLeft, typename MatRight>
+    static inline double mulFlops(const MatLeft &a, const MatRight &b)
     {
         double nr = a.rows(), nc = a.cols();
 
@@ -504,10 +627,93 @@ void A2AMatrixIo<T>::saveBlock(const A2AMatrixSet<T> &m,
     saveBlock(m.data() + offset, i, j, blockSizei, blockSizej);
 }
 
+#ifdef HADRONS_A2AM_COLLECTIVE_IO
+template <typename T>
+void A2AMatrixIo<T>::saveBlockCollective(const T *data, 
+                                         const unsigned int i, 
+                                         const unsigned int j,
+                                         const unsigned int blockSizei,
+                                         const unsigned int blockSizej,
+                                         const unsigned int t0,
+                                         const unsigned int ntLoc,
+                                         GridBase *grid)
+{
+    H5NS::FileAccPropList     fapl;
+    H5NS::DSetMemXferPropList dxpl;
+    std::vector<hsize_t>      count  = {ntLoc, blockSizei, blockSizej},
+                              offset = {t0, static_cast<hsize_t>(i),
+                                        static_cast<hsize_t>(j)},
+                              stride = {1, 1, 1},
+                              block  = {1, 1, 1},
+                              memDim = {std::max(ntLoc, 1u), blockSizei, blockSizej}; 
+    H5NS::DataSpace           memspace(memDim.size(), memDim.data()), dataspace;
+    H5NS::DataSet             dataset;
+
+    H5Pset_fapl_mpio(fapl.getId(), grid->communicator, MPI_INFO_NULL);
+    H5Pset_dxpl_mpio(dxpl.getId(), H5FD_MPIO_COLLECTIVE);
+
+    H5NS::H5File file(filename_, H5F_ACC_RDWR, H5NS::FileCreatPropList::DEFAULT, fapl);
+    H5NS::Group  group = file.openGroup(dataname_);
+
+    dataset   = group.openDataSet(HADRONS_A2AM_NAME);
+    dataspace = dataset.getSpace();
+    // ranks without time slices still take part in the collective write
+    if (ntLoc > 0)
+    {
+        dataspace.selectHyperslab(H5S_SELECT_SET, count.data(), offset.data(),
+                                  stride.data(), block.data());
+    }
+    else
+    {
+        dataspace.selectNone();
+        memspace.selectNone();
+    }
+    dataset.write(data + static_cast<size_t>(t0)*blockSizei*blockSizej, 
+                  Hdf5Type<T>::type(), memspace, dataspace, dxpl);
+}
+
+template <typename T>
+void A2AMatrixIo<T>::saveBlockCollective(const A2AMatrixSet<T> &m,
+                                         const unsigned int ext, const unsigned int str,
+                                         const unsigned int i, const unsigned int j,
+                                         GridBase *grid)
+{
+    unsigned int blockSizei = m.dimension(3);
+    unsigned int blockSizej = m.dimension(4);
+    unsigned int nstr       = m.dimension(1);
+    size_t       offset     = (ext*nstr + str)*nt_*blockSizei*blockSizej;
+    unsigned int nRank      = grid->RankCount(), rank = grid->ThisRank();
+    unsigned int t0         = (nt_*rank)/nRank, t1 = (nt_*(rank + 1))/nRank;
+
+    saveBlockCollective(m.data() + offset, i, j, blockSizei, blockSizej, 
+                        t0, t1 - t0, grid);
+}
+#endif
+
 template <typename T>
 template <template <class> class Vec, typename VecT>
 void A2AMatrixIo<T>::load(Vec<VecT> &v, double *tRead, GridBase *grid)
 {
+    unsigned int typeSize;
+
+    // every rank maps a flat file itself, no broadcast needed
+    if (A2AMatrixMap<T>::isMapFile(filename_, &typeSize))
+    {
+        if (typeSize == sizeof(ComplexF))
+        {
+            loadMap<ComplexF>(v, tRead);
+        }
+        else if (typeSize == sizeof(ComplexD))
+        {
+            loadMap<ComplexD>(v, tRead);
+        }
+        else
+        {
+            HADRONS_ERROR(Io, "unknown data type in all-to-all matrix file '" + filename_ + "'");
+        }
+
+        return;
+    }
 #ifdef HAVE_HDF5
     std::vector<hsize_t> hdim;
     H5NS::DataSet        dataset;
@@ -597,6 +803,257 @@ void A2AMatrixIo<T>::load(Vec<VecT> &v, double *tRead, GridBase *grid)
 #endif
 }
 
+template <typename T>
+template <typename S, template <class> class Vec, typename VecT>
+void A2AMatrixIo<T>::loadMap(Vec<VecT> &v, double *tRead)
+{
+    const A2AMatrixMap<S> map(filename_);
+
+    if (map.getNt() != nt_)
+    {
+        HADRONS_ERROR(Size, "all-to-all time size mismatch (got "
+            + std::to_string(map.getNt()) + ", expected "
+            + std::to_string(nt_) + ")");
+    }
+    if ((ni_*nj_ != 0) and ((map.getNi() != ni_) or (map.getNj() != nj_)))
+    {
+        HADRONS_ERROR(Size, "all-to-all matrix size mismatch (got "
+            + std::to_string(map.getNi()) + "x" + std::to_string(map.getNj()) 
+            + ", expected " + std::to_string(ni_) + "x" + std::to_string(nj_));
+    }
+    ni_ = map.getNi();
+    nj_ = map.getNj();
+    if (tRead) *tRead = 0.;
+    for (unsigned int t = 0; t < nt_; ++t)
+    {
+        if (t + 1 < nt_) map.prefetch(t + 1);
+        if (tRead) *tRead -= usecond();
+        v[t] = map[t].template cast<VecT>();
+        if (tRead) *tRead += usecond();
+    }
+}
+
+/******************************************************************************
+ *                    A2AMatrixMap template implementation                    *
+ ******************************************************************************/
+// constructors ////////////////////////////////////////////////////////////////
+template <typename T>
+A2AMatrixMap<T>::A2AMatrixMap(const std::string filename)
+{
+    open(filename);
+}
+
+template <typename T>
+A2AMatrixMap<T>::A2AMatrixMap(A2AMatrixMap<T> &&m)
+: filename_(m.filename_), header_(m.header_), map_(m.map_)
+, mapSize_(m.mapSize_), writable_(m.writable_)
+{
+    m.map_     = nullptr;
+    m.mapSize_ = 0;
+}
+
+// destructor //////////////////////////////////////////////////////////////////
+template <typename T>
+A2AMatrixMap<T>::~A2AMatrixMap(void)
+{
+    close();
+}
+
+// file management /////////////////////////////////////////////////////////////
+template <typename T>
+bool A2AMatrixMap<T>::isMapFile(const std::string filename, unsigned int *typeSize)
+{
+    std::ifstream      f(filename, std::ios::binary);
+    A2AMatrixMapHeader h;
+
+    if (!f.read(reinterpret_cast<char *>(&h), sizeof(h)) 
+        or (strncmp(h.magic, magic_, sizeof(h.magic)) != 0))
+    {
+        return false;
+    }
+    if (typeSize)
+    {
+        *typeSize = h.typeSize;
+    }
+
+    return true;
+}
+
+template <typename T>
+void A2AMatrixMap<T>::open(const std::string filename)
+{
+    int         fd;
+    struct stat s;
+
+    close();
+    if (!isMapFile(filename))
+    {
+        HADRONS_ERROR(Io, "'" + filename + "' is not an all-to-all matrix map file");
+    }
+    filename_ = filename;
+    fd        = ::open(filename.c_str(), O_RDONLY);
+    if ((fd < 0) or (fstat(fd, &s) != 0))
+    {
+        HADRONS_ERROR(Io, "cannot open '" + filename + "': " + std::string(std::strerror(errno)));
+    }
+    if (::read(fd, &header_, sizeof(header_)) != sizeof(header_))
+    {
+        HADRONS_ERROR(Io, "cannot read header of '" + filename + "'");
+    }
+    if (header_.typeSize != sizeof(T))
+    {
+        HADRONS_ERROR(Io, "'" + filename + "' holds " + std::to_string(header_.typeSize)
+                      + " byte elements, expected " + std::to_string(sizeof(T)));
+    }
+    mapSize_ = header_.dataOffset + header_.nt*header_.sliceStride;
+    if (static_cast<size_t>(s.st_size) < mapSize_)
+    {
+        HADRONS_ERROR(Io, "'" + filename + "' is truncated");
+    }
+    map_ = static_cast<char *>(mmap(nullptr, mapSize_, PROT_READ, MAP_SHARED, fd, 0));
+    ::close(fd);
+    if (map_ == MAP_FAILED)
+    {
+        map_ = nullptr;
+        HADRONS_ERROR(Io, "cannot map '" + filename + "': " + std::string(std::strerror(errno)));
+    }
+    writable_ = false;
+}
+
+template <typename T>
+void A2AMatrixMap<T>::create(const std::string filename, const unsigned int nt,
+                             const unsigned int ni, const unsigned int nj)
+{
+    int fd;
+
+    close();
+    filename_ = filename;
+    memset(&header_, 0, sizeof(header_));
+    memcpy(header_.magic, magic_, sizeof(header_.magic));
+    header_.version     = 1;
+    header_.typeSize    = sizeof(T);
+    header_.nt          = nt;
+    header_.ni          = ni;
+    header_.nj          = nj;
+    header_.sliceStride = ((ni*nj*sizeof(T) + page_ - 1)/page_)*page_;
+    header_.dataOffset  = page_;
+    mapSize_            = header_.dataOffset + nt*header_.sliceStride;
+    fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if ((fd < 0) or (ftruncate(fd, mapSize_) != 0))
+    {
+        HADRONS_ERROR(Io, "cannot create '" + filename + "': " + std::string(std::strerror(errno)));
+    }
+    map_ = static_cast<char *>(mmap(nullptr, mapSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    ::close(fd);
+    if (map_ == MAP_FAILED)
+    {
+        map_ = nullptr;
+        HADRONS_ERROR(Io, "cannot map '" + filename + "': " + std::string(std::strerror(errno)));
+    }
+    memcpy(map_, &header_, sizeof(header_));
+    writable_ = true;
+}
+
+template <typename T>
+void A2AMatrixMap<T>::close(void)
+{
+    if (map_)
+    {
+        if (writable_)
+        {
+            msync(map_, mapSize_, MS_SYNC);
+        }
+        munmap(map_, mapSize_);
+        map_     = nullptr;
+        mapSize_ = 0;
+    }
+}
+
+// access //////////////////////////////////////////////////////////////////////
+template <typename T>
+unsigned int A2AMatrixMap<T>::getNt(void) const
+{
+    return header_.nt;
+}
+
+template <typename T>
+unsigned int A2AMatrixMap<T>::getNi(void) const
+{
+    return header_.ni;
+}
+
+template <typename T>
+unsigned int A2AMatrixMap<T>::getNj(void) const
+{
+    return header_.nj;
+}
+
+template <typename T>
+typename A2AMatrixMap<T>::ConstSlice A2AMatrixMap<T>::operator[](const unsigned int t) const
+{
+    assert(map_ and (t < header_.nt));
+
+    return ConstSlice(reinterpret_cast<const T *>(map_ + header_.dataOffset + t*header_.sliceStride),
+                      header_.ni, header_.nj);
+}
+
+template <typename T>
+typename A2AMatrixMap<T>::Slice A2AMatrixMap<T>::operator[](const unsigned int t)
+{
+    assert(map_ and writable_ and (t < header_.nt));
+
+    return Slice(reinterpret_cast<T *>(map_ + header_.dataOffset + t*header_.sliceStride),
+                 header_.ni, header_.nj);
+}
+
+template <typename T>
+void A2AMatrixMap<T>::prefetch(const unsigned int t) const
+{
+    if (map_ and (t < header_.nt))
+    {
+        madvise(map_ + header_.dataOffset + t*header_.sliceStride, 
+                header_.sliceStride, MADV_WILLNEED);
+    }
+}
+
+// conversion //////////////////////////////////////////////////////////////////
+template <typename T>
+template <typename TIo>
+void A2AMatrixMap<T>::convert(const std::string mapFilename, const std::string h5Filename,
+                              const std::string dataname, const unsigned int nt)
+{
+#ifdef HAVE_HDF5
+    std::vector<hsize_t> hdim;
+    A2AMatrixMap<T>      map;
+    double               t;
+
+    {
+        Hdf5Reader      reader(h5Filename);
+        H5NS::DataSet   dataset;
+        H5NS::DataSpace dataspace;
+
+        push(reader, dataname);
+        dataset   = reader.getGroup().openDataSet(HADRONS_A2AM_NAME);
+        dataspace = dataset.getSpace();
+        hdim.resize(dataspace.getSimpleExtentNdims());
+        dataspace.getSimpleExtentDims(hdim.data());
+    }
+    if (hdim[0] != nt)
+    {
+        HADRONS_ERROR(Size, "all-to-all time size mismatch (got "
+            + std::to_string(hdim[0]) + ", expected " + std::to_string(nt) + ")");
+    }
+    map.create(mapFilename, nt, hdim[1], hdim[2]);
+
+    A2AMatrixIo<TIo> io(h5Filename, dataname, nt, hdim[1], hdim[2]);
+
+    io.load(map, &t);
+    map.close();
+#else
+    HADRONS_ERROR(Implementation, "all-to-all matrix I/O needs HDF5 library");
+#endif
+}
+
 /******************************************************************************
  *               A2AMatrixBlockComputation template implementation            *
  ******************************************************************************/
@@ -618,6 +1075,29 @@ A2AMatrixBlockComputation<T, Field, MetadataType, TIo>
     mBuf_.resize(nt_*next_*nstr_*blockSize_*blockSize_);
 }
 
+// I/O options /////////////////////////////////////////////////////////////////
+template <typename T, typename Field, typename MetadataType, typename TIo>
+void A2AMatrixBlockComputation<T, Field, MetadataType, TIo>
+::setPipelinedIo(const bool pipelined)
+{
+    pipelined_ = pipelined;
+    mBuf_.resize((pipelined_ ? 2 : 1)*nt_*next_*nstr_*blockSize_*blockSize_);
+}
+
+template <typename T, typename Field, typename MetadataType, typename TIo>
+void A2AMatrixBlockComputation<T, Field, MetadataType, TIo>
+::setCollectiveIo(const bool collective)
+{
+#ifndef HADRONS_A2AM_COLLECTIVE_IO
+    if (collective)
+    {
+        HADRONS_ERROR(Implementation, "collective all-to-all matrix I/O needs "
+                      "MPI and parallel HDF5 >= 1.10.2");
+    }
+#endif
+    collective_ = collective;
+}
+
 #define START_TIMER(name) if (tArray_) tArray_->startTimer(name)
 #define STOP_TIMER(name)  if (tArray_) tArray_->stopTimer(name)
 #define GET_TIMER(name)   ((tArray_ != nullptr) ? tArray_->getDTimer(name) : 0.)
@@ -643,13 +1123,38 @@ void A2AMatrixBlockComputation<T, Field, MetadataType, TIo>
     int NBlock_i = N_i/blockSize_ + (((N_i % blockSize_) != 0) ? 1 : 0);
     int NBlock_j = N_j/blockSize_ + (((N_j % blockSize_) != 0) ? 1 : 0);
 
+    // with pipelined I/O mBuf_ holds two blocks: the kernel fills one while
+    // the background writer empties the other
+    unsigned int        buf     = 0;
+    size_t              bufSize = nt_*next_*nstr_*blockSize_*blockSize_;
+    std::future<double> pendingIo;
+    bool                collective = false;
+
+#ifdef HADRONS_A2AM_COLLECTIVE_IO
+    // fewer files than ranks: have every rank write a slice of each file
+    collective = collective_ and (next_*nstr_ < grid_->RankCount());
+#endif
+    auto waitIo = [this, &pendingIo](void)
+    {
+        if (pendingIo.valid())
+        {
+            double ioTime;
+
+            START_TIMER("IO: wait");
+            ioTime = pendingIo.get();
+            grid_->Barrier();
+            STOP_TIMER("IO: wait");
+            LOG(Message) << "Background HDF5 IO took " << ioTime << " us" << std::endl;
+        }
+    };
+
     for(int i=0;i<N_i;i+=blockSize_)
     for(int j=0;j<N_j;j+=blockSize_)
     {
         // Get the W and V vectors for this block^2 set of terms
         int N_ii = MIN(N_i-i,blockSize_);
         int N_jj = MIN(N_j-j,blockSize_);
-        A2AMatrixSet<TIo> mBlock(mBuf_.data(), next_, nstr_, nt_, N_ii, N_jj);
+        A2AMatrixSet<TIo> mBlock(mBuf_.data() + buf*bufSize, next_, nstr_, nt_, N_ii, N_jj);
 
         LOG(Message) << "All-to-all matrix block " 
                      << j/blockSize_ + NBlock_j*i/blockSize_ + 1 
@@ -696,52 +1201,80 @@ void A2AMatrixBlockComputation<T, Field, MetadataType, TIo>
 
         // IO
         double       blockSize, ioTime;
-        unsigned int myRank = grid_->ThisRank(), nRank  = grid_->RankCount();
     
+        if (pipelined_ and !collective)
+        {
+            // the writer thread does no MPI, barriers stay on this thread
+            waitIo();
+            LOG(Message) << "Writing block to disk in the background" << std::endl;
+            makeFileDir(filenameFn(0, 0), grid_);
+            grid_->Barrier();
+            makeIoTasks(nodeIo_, i, j, N_i, N_j, ionameFn, filenameFn, metadataFn);
+            pendingIo = std::async(std::launch::async, saveTasks, mBlock, nodeIo_, 
+                                   blockSize_);
+            buf       = 1 - buf;
+            continue;
+        }
         LOG(Message) << "Writing block to disk" << std::endl;
         ioTime = -GET_TIMER("IO: write block");
         START_TIMER("IO: total");
         makeFileDir(filenameFn(0, 0), grid_);
-#ifdef HADRONS_A2AM_PARALLEL_IO
-        grid_->Barrier();
-        // make task list for current node
-        nodeIo_.clear();
-        for(int f = myRank; f < next_*nstr_; f += nRank)
+#ifdef HADRONS_A2AM_COLLECTIVE_IO
+        if (collective)
         {
-            IoHelper h;
-
-            h.i  = i;
-            h.j  = j;
-            h.e  = f/nstr_;
-            h.s  = f % nstr_;
-            h.io = A2AMatrixIo<TIo>(filenameFn(h.e, h.s), 
-                                    ionameFn(h.e, h.s), nt_, N_i, N_j);
-            h.md = metadataFn(h.e, h.s);
-            nodeIo_.push_back(h);
+            for(int f = 0; f < next_*nstr_; f++)
+            {
+                IoHelper h;
+
+                h.i  = i;
+                h.j  = j;
+                h.e  = f/nstr_;
+                h.s  = f % nstr_;
+                h.io = A2AMatrixIo<TIo>(filenameFn(h.e, h.s), 
+                                        ionameFn(h.e, h.s), nt_, N_i, N_j);
+                if ((i == 0) and (j == 0) and grid_->IsBoss())
+                {
+                    START_TIMER("IO: file creation");
+                    h.io.initFile(metadataFn(h.e, h.s), blockSize_);
+                    STOP_TIMER("IO: file creation");
+                }
+                grid_->Barrier();
+                START_TIMER("IO: write block");
+                h.io.saveBlockCollective(mBlock, h.e, h.s, h.i, h.j, grid_);
+                STOP_TIMER("IO: write block");
+            }
         }
-        // parallel IO
-        for (auto &h: nodeIo_)
+        else
+#endif
         {
-            saveBlock(mBlock, h);
-        }
-        grid_->Barrier();
+#ifdef HADRONS_A2AM_PARALLEL_IO
+            grid_->Barrier();
+            // make task list for current node
+            makeIoTasks(nodeIo_, i, j, N_i, N_j, ionameFn, filenameFn, metadataFn);
+            // parallel IO
+            for (auto &h: nodeIo_)
+            {
+                saveBlock(mBlock, h);
+            }
+            grid_->Barrier();
 #else
-        // serial IO, for testing purposes only
-        for(int e = 0; e < next_; e++)
-        for(int s = 0; s < nstr_; s++)
-        {
-            IoHelper h;
-
-            h.i  = i;
-            h.j  = j;
-            h.e  = e;
-            h.s  = s;
-            h.io = A2AMatrixIo<TIo>(filenameFn(h.e, h.s), 
-                                    ionameFn(h.e, h.s), nt_, N_i, N_j);
-            h.md = metadataFn(h.e, h.s);
-            saveBlock(mfBlock, h);
-        }
+            // serial IO, for testing purposes only
+            for(int e = 0; e < next_; e++)
+            for(int s = 0; s < nstr_; s++)
+            {
+                IoHelper h;
+
+                h.i  = i;
+                h.j  = j;
+                h.e  = e;
+                h.s  = s;
+                h.io = A2AMatrixIo<TIo>(filenameFn(h.e, h.s), 
+                                        ionameFn(h.e, h.s), nt_, N_i, N_j);
+                h.md = metadataFn(h.e, h.s);
+                saveBlock(mfBlock, h);
+            }
 #endif
+        }
         STOP_TIMER("IO: total");
         blockSize  = static_cast<double>(next_*nstr_*nt_*N_ii*N_jj*sizeof(TIo));
         ioTime    += GET_TIMER("IO: write block");
@@ -750,6 +1283,7 @@ void A2AMatrixBlockComputation<T, Field, MetadataType, TIo>
                      << blockSize/ioTime*1.0e6/1024/1024
                      << " MB/s)" << std::endl;
     }
+    waitIo();
 }
 
 // I/O handler /////////////////////////////////////////////////////////////////
@@ -768,6 +1302,54 @@ void A2AMatrixBlockComputation<T, Field, MetadataType, TIo>
     STOP_TIMER("IO: write block");
 }
 
+// files of the current block written by this rank, round-robin over ranks
+template <typename T, typename Field, typename MetadataType, typename TIo>
+void A2AMatrixBlockComputation<T, Field, MetadataType, TIo>
+::makeIoTasks(std::vector<IoHelper> &task, const unsigned int i, 
+              const unsigned int j, const unsigned int N_i, 
+              const unsigned int N_j, const FilenameFn &ionameFn,
+              const FilenameFn &filenameFn, const MetadataFn &metadataFn)
+{
+    unsigned int myRank = grid_->ThisRank(), nRank = grid_->RankCount();
+
+    task.clear();
+    for(int f = myRank; f < next_*nstr_; f += nRank)
+    {
+        IoHelper h;
+
+        h.i  = i;
+        h.j  = j;
+        h.e  = f/nstr_;
+        h.s  = f % nstr_;
+        h.io = A2AMatrixIo<TIo>(filenameFn(h.e, h.s), 
+                                ionameFn(h.e, h.s), nt_, N_i, N_j);
+        h.md = metadataFn(h.e, h.s);
+        task.push_back(h);
+    }
+}
+
+// background writer: no MPI, no timer array (not thread-safe), returns the
+// time spent in HDF5 in microseconds
+template <typename T, typename Field, typename MetadataType, typename TIo>
+double A2AMatrixBlockComputation<T, Field, MetadataType, TIo>
+::saveTasks(const A2AMatrixSet<TIo> m, std::vector<IoHelper> task,
+            const unsigned int blockSize)
+{
+    double t = -usecond();
+
+    for (auto &h: task)
+    {
+        if ((h.i == 0) and (h.j == 0))
+        {
+            h.io.initFile(h.md, blockSize);
+        }
+        h.io.saveBlock(m, h.e, h.s, h.i, h.j);
+    }
+    t += usecond();
+
+    return t;
+}
+
 #undef START_TIMER
 #undef STOP_TIMER
 #undef GET_TIMER
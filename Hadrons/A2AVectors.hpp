@@ -85,7 +85,9 @@ public:
 public:
     template <typename Field>
     static void write(const std::string fileStem, std::vector<Field> &vec, 
-                      const bool multiFile, const int trajectory = -1);
+                      const bool multiFile, const int trajectory = -1,
+                      const int compression = CompressedIO::None,
+                      const double tolerance = 0.);
     template <typename Field>
     static void read(std::vector<Field> &vec, const std::string fileStem,
                      const bool multiFile, const int trajectory = -1);
@@ -258,13 +260,16 @@ void A2AVectorsSchurDiagTwo<FImpl>::makeHighModeW5D(FermionField &wout_4d,
  ******************************************************************************/
 template <typename Field>
 void A2AVectorsIo::write(const std::string fileStem, std::vector<Field> &vec, 
-                         const bool multiFile, const int trajectory)
+                         const bool multiFile, const int trajectory,
+                         const int compression, const double tolerance)
 {
     Record       record;
     GridBase     *grid = vec[0].Grid();
     ScidacWriter binWriter(grid->IsBoss());
     std::string  filename = vecFilename(fileStem, trajectory, multiFile);
 
+    binWriter.setCompression(compression, tolerance);
+
     if (multiFile)
     {
         std::string fullFilename;
@@ -31,6 +31,10 @@ See the full license in the file "LICENSE" in the top level distribution directo
 #include <Hadrons/Global.hpp>
 #include <Hadrons/A2AMatrix.hpp>
 #include <deque>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <sys/stat.h>
 #include <ftw.h>
 #include <unistd.h>
@@ -85,15 +89,29 @@ public:
         const DiskVectorBase<T> &cmaster_;
         const unsigned int      i_;
     };
+    // access statistics, times in microseconds, peakStaged the largest
+    // number of elements held outside the cache by background I/O
+    struct Statistics
+    {
+        double access{0.}, hit{0.}, prefetchHit{0.}, miss{0.};
+        double stallTime{0.}, ioTime{0.}, peakStaged{0.};
+    };
 public:
     DiskVectorBase(const std::string dirname, const unsigned int size = 0,
                    const unsigned int cacheSize = 1, const bool clean = true,
                    GridBase *grid = nullptr);
-    DiskVectorBase(DiskVectorBase<T> &&v) = default;
+    DiskVectorBase(DiskVectorBase<T> &&v);
     virtual ~DiskVectorBase(void);
     const T & operator[](const unsigned int i) const;
     RwAccessHelper operator[](const unsigned int i);
+    // queue elements to be read by the background I/O thread ahead of use
+    void prefetch(const unsigned int i) const;
+    void prefetch(const std::vector<unsigned int> &seq) const;
+    // wait for all write-behind evictions to reach the disk
+    void flush(void) const;
     double hitRatio(void) const;
+    Statistics getStat(void) const;
+    void printStat(const std::string name = "") const;
     void resetStat(void);
     void setSize(unsigned int size_);
     unsigned int getSize() const;
@@ -101,7 +119,40 @@ public:
     void setGrid(GridBase *grid_);
     GridBase *getGrid() const;
     GridBase *dvGrid;
+protected:
+    // true if load and save may run on a thread of their own, i.e. they
+    // neither communicate nor use a non thread safe library; a class
+    // returning true must call ioStop() in its destructor, since queued
+    // loads and saves need its load and save
+    virtual bool asyncIo(void) const { return false; }
+    // drain the background I/O queue and join the I/O thread
+    void ioStop(void) const;
 private:
+    // background I/O: one thread serving a FIFO of loads and saves, so a
+    // save queued before a load of the same element always lands first;
+    // loaded elements staged outside the cache, loads in flight and modified
+    // elements waiting to be written share a budget of cacheSize elements,
+    // so at most 2*cacheSize elements are in memory. A save short of room
+    // drops staged loads first, they are simply read again on use
+    struct IoTask
+    {
+        bool               isSave;
+        unsigned int       i;
+        std::unique_ptr<T> obj;
+    };
+    struct IoState
+    {
+        std::mutex                                      mutex;
+        std::condition_variable                         cv;
+        std::deque<IoTask>                              queue;
+        std::map<unsigned int, std::unique_ptr<T>>      ready;
+        std::set<unsigned int>                          loading, stale;
+        std::map<unsigned int, unsigned int>            saving;
+        unsigned int                                    nSaving{0};
+        std::exception_ptr                              error;
+        std::thread                                     thread;
+        bool                                            stop{false};
+    };
     virtual void load(T &obj, const std::string filename) const = 0;
     virtual void save(const std::string filename, const T &obj) const = 0;
     virtual std::string filename(const unsigned int i) const;
@@ -109,10 +160,18 @@ private:
     void fetch(const unsigned int i) const;
     void cacheInsert(const unsigned int i, const T &obj) const;
     void clean(void);
+    void ioStart(void) const;
+    void ioLoop(void) const;
+    void ioRethrow(void) const;
+    bool ioFull(const IoState &io) const;
+    void ioStaged(const IoState &io) const;
 private:
     std::string                                           dirname_;
     unsigned int                                          size_, cacheSize_;
     double                                                access_{0.}, hit_{0.};
+    double                                                prefetchHit_{0.}, miss_{0.};
+    double                                                stallTime_{0.}, ioTime_{0.};
+    double                                                peakStaged_{0.};
     bool                                                  clean_;
     GridBase                                              *grid_;
     // using pointers to allow modifications when class is const
@@ -122,6 +181,7 @@ private:
     std::unique_ptr<std::map<unsigned int, unsigned int>> indexPtr_;
     std::unique_ptr<std::stack<unsigned int>>             freePtr_;
     std::unique_ptr<std::deque<unsigned int>>             loadsPtr_;                
+    std::unique_ptr<IoState>                              ioPtr_;
 };
 
 /******************************************************************************
@@ -161,6 +221,14 @@ public:
     using DiskVectorBase<EigenDiskVectorMat<T>>::DiskVectorBase;
     typedef EigenDiskVectorMat<T> Matrix;
 public:
+    EigenDiskVector(EigenDiskVector<T> &&v) = default;
+    // pending write-behind and prefetch use load and save, finish them
+    // while this object still exists
+    virtual ~EigenDiskVector(void)
+    {
+        (*this).flush();
+        (*this).ioStop();
+    }
     T operator()(const unsigned int i, const Eigen::Index j,
                  const Eigen::Index k) const
     {
@@ -174,6 +242,12 @@ public:
         dims[2] = (*this)[0].cols();
         return dims;
     }
+protected:
+    // plain stream I/O, safe off the main thread unless it broadcasts
+    virtual bool asyncIo(void) const
+    {
+        return ((*this).getGrid() == nullptr);
+    }
 private:
     virtual void load(EigenDiskVectorMat<T> &obj, const std::string filename) const
     {
@@ -270,6 +344,7 @@ DiskVectorBase<T>::DiskVectorBase(const std::string dirname,
 , indexPtr_(new std::map<unsigned int, unsigned int>())
 , freePtr_(new std::stack<unsigned int>)
 , loadsPtr_(new std::deque<unsigned int>())
+, ioPtr_(new IoState)
 {
     struct stat s;
 
@@ -290,9 +365,41 @@ DiskVectorBase<T>::DiskVectorBase(const std::string dirname,
     setGrid(grid_);
 }
 
+// the I/O thread is bound to the moved-from object, drain and stop it
+// before taking its state
+template <typename T>
+DiskVectorBase<T>::DiskVectorBase(DiskVectorBase<T> &&v)
+: ioPtr_(new IoState)
+{
+    v.ioStop();
+    dvSize        = v.dvSize;
+    dvGrid        = v.dvGrid;
+    dirname_      = std::move(v.dirname_);
+    size_         = v.size_;
+    cacheSize_    = v.cacheSize_;
+    access_       = v.access_;
+    hit_          = v.hit_;
+    prefetchHit_  = v.prefetchHit_;
+    miss_         = v.miss_;
+    stallTime_    = v.stallTime_;
+    ioTime_       = v.ioTime_;
+    peakStaged_   = v.peakStaged_;
+    clean_        = v.clean_;
+    grid_         = v.grid_;
+    cachePtr_     = std::move(v.cachePtr_);
+    modifiedPtr_  = std::move(v.modifiedPtr_);
+    indexPtr_     = std::move(v.indexPtr_);
+    freePtr_      = std::move(v.freePtr_);
+    loadsPtr_     = std::move(v.loadsPtr_);
+    ioPtr_->ready = std::move(v.ioPtr_->ready);
+    v.clean_      = false;
+}
+
 template <typename T>
 DiskVectorBase<T>::~DiskVectorBase(void)
 {
+    // load and save are gone by now, the derived class stops the I/O thread
+    assert(!ioPtr_->thread.joinable());
     if (clean_)
     {
         clean();
@@ -381,17 +488,99 @@ typename DiskVectorBase<T>::RwAccessHelper DiskVectorBase<T>::operator[](const u
     return RwAccessHelper(*this, i);
 }
 
+template <typename T>
+void DiskVectorBase<T>::prefetch(const unsigned int i) const
+{
+    if (!asyncIo() or (i >= size_) or (indexPtr_->find(i) != indexPtr_->end()))
+    {
+        return;
+    }
+
+    auto                         &io = *ioPtr_;
+    std::unique_lock<std::mutex> lock(io.mutex);
+    struct stat                  s;
+
+    if (io.ready.count(i) or io.loading.count(i) or ioFull(io))
+    {
+        return;
+    }
+    if (!io.saving.count(i) and (stat(filename(i).c_str(), &s) != 0))
+    {
+        return;
+    }
+    DV_DEBUG_MSG(this, "prefetching " << i);
+    io.loading.insert(i);
+    io.queue.push_back(IoTask{false, i, nullptr});
+    ioStaged(io);
+    lock.unlock();
+    ioStart();
+    io.cv.notify_all();
+}
+
+template <typename T>
+void DiskVectorBase<T>::prefetch(const std::vector<unsigned int> &seq) const
+{
+    for (auto i: seq)
+    {
+        prefetch(i);
+    }
+}
+
+template <typename T>
+void DiskVectorBase<T>::flush(void) const
+{
+    auto                         &io = *ioPtr_;
+    std::unique_lock<std::mutex> lock(io.mutex);
+
+    io.cv.wait(lock, [&io](){ return (io.nSaving == 0) or io.error; });
+    lock.unlock();
+    ioRethrow();
+}
+
 template <typename T>
 double DiskVectorBase<T>::hitRatio(void) const
 {
     return hit_/access_;
 }
 
+template <typename T>
+typename DiskVectorBase<T>::Statistics DiskVectorBase<T>::getStat(void) const
+{
+    Statistics stat;
+
+    stat.access      = access_;
+    stat.hit         = hit_;
+    stat.prefetchHit = prefetchHit_;
+    stat.miss        = miss_;
+    stat.stallTime   = stallTime_;
+    stat.ioTime      = ioTime_;
+    stat.peakStaged  = peakStaged_;
+
+    return stat;
+}
+
+template <typename T>
+void DiskVectorBase<T>::printStat(const std::string name) const
+{
+    LOG(Message) << "disk vector " << ((name.empty()) ? dirname_ : name) 
+                 << ": " << access_ << " accesses, " << hit_ << " hits, "
+                 << prefetchHit_ << " prefetch hits, " << miss_ << " misses, "
+                 << stallTime_/1.0e6 << " s stalled on background I/O, "
+                 << ioTime_/1.0e6 << " s synchronous I/O, "
+                 << peakStaged_ << "/" << cacheSize_ << " elements peak staged" 
+                 << std::endl;
+}
+
 template <typename T>
 void DiskVectorBase<T>::resetStat(void)
 {
-    access_ = 0.;
-    hit_    = 0.;
+    access_      = 0.;
+    hit_         = 0.;
+    prefetchHit_ = 0.;
+    miss_        = 0.;
+    stallTime_   = 0.;
+    ioTime_      = 0.;
+    peakStaged_  = 0.;
 }
 
 template <typename T>
@@ -414,10 +603,44 @@ void DiskVectorBase<T>::evict(void) const
         unsigned int i = loads.front();
         
         DV_DEBUG_MSG(this, "evicting " << i);
-        if (modified[index.at(i)])
+        if (modified[index.at(i)] and asyncIo())
         {
+            auto                         &io = *ioPtr_;
+            std::unique_lock<std::mutex> lock(io.mutex);
+            double                       t = -usecond();
+
+            DV_DEBUG_MSG(this, "element " << i << " modified, queued for saving");
+            while (ioFull(io) and !io.error)
+            {
+                if (!io.ready.empty())
+                {
+                    DV_DEBUG_MSG(this, "dropping staged " << io.ready.begin()->first);
+                    io.ready.erase(io.ready.begin());
+                }
+                else
+                {
+                    io.cv.wait(lock);
+                }
+            }
+            t += usecond();
+            const_cast<double &>(stallTime_) += t;
+            io.saving[i]++;
+            io.nSaving++;
+            io.queue.push_back(IoTask{true, i, std::unique_ptr<T>(new T(std::move(cache[index.at(i)])))});
+            ioStaged(io);
+            lock.unlock();
+            ioStart();
+            io.cv.notify_all();
+            ioRethrow();
+        }
+        else if (modified[index.at(i)])
+        {
+            double t = -usecond();
+
             DV_DEBUG_MSG(this, "element " << i << " modified, saving to disk");
             save(filename(i), cache[index.at(i)]);
+            t += usecond();
+            const_cast<double &>(ioTime_) += t;
         }
         freeInd.push(index.at(i));
         index.erase(i);
@@ -437,17 +660,49 @@ void DiskVectorBase<T>::fetch(const unsigned int i) const
 
     struct stat s;
 
-    DV_DEBUG_MSG(this, "loading " << i << " from disk");
-
     evict();
-    
+
+    if (asyncIo())
+    {
+        auto                         &io = *ioPtr_;
+        std::unique_lock<std::mutex> lock(io.mutex);
+        double                       t = -usecond();
+
+        // wait for an in-flight prefetch, or for write-behind of this element
+        io.cv.wait(lock, [i, &io](){ return (!io.loading.count(i) and !io.saving.count(i)) or io.error; });
+        t += usecond();
+        const_cast<double &>(stallTime_) += t;
+        lock.unlock();
+        ioRethrow();
+        lock.lock();
+        if (io.ready.count(i))
+        {
+            DV_DEBUG_MSG(this, "taking " << i << " from prefetch");
+            index[i] = freeInd.top();
+            freeInd.pop();
+            cache[index.at(i)] = std::move(*io.ready.at(i));
+            io.ready.erase(i);
+            loads.push_back(i);
+            modified[index.at(i)] = false;
+            const_cast<double &>(prefetchHit_)++;
+
+            return;
+        }
+    }
+    DV_DEBUG_MSG(this, "loading " << i << " from disk");
+    const_cast<double &>(miss_)++;
     if(stat(filename(i).c_str(), &s) != 0)
     {
         HADRONS_ERROR(Io, "disk vector element " + std::to_string(i) + " uninitialised");
     }
     index[i] = freeInd.top();
     freeInd.pop();
+
+    double t = -usecond();
+
     load(cache[index.at(i)], filename(i));
+    t += usecond();
+    const_cast<double &>(ioTime_) += t;
     loads.push_back(i);
     modified[index.at(i)] = false;
 }
@@ -461,7 +716,30 @@ void DiskVectorBase<T>::cacheInsert(const unsigned int i, const T &obj) const
     auto &freeInd  = *freePtr_;
     auto &loads    = *loadsPtr_;
 
+    if (index.find(i) != index.end())
+    {
+        // already cached, overwrite in place
+        loads.erase(std::find(loads.begin(), loads.end(), i));
+        loads.push_back(i);
+        cache[index.at(i)] = obj;
+        modified[index.at(i)] = false;
+        if (grid_)  grid_->Barrier();
+
+        return;
+    }
     evict();
+    if (asyncIo())
+    {
+        // a staged or in-flight copy of i is now out of date
+        auto                        &io = *ioPtr_;
+        std::lock_guard<std::mutex> lock(io.mutex);
+
+        io.ready.erase(i);
+        if (io.loading.count(i))
+        {
+            io.stale.insert(i);
+        }
+    }
     index[i] = freeInd.top();
     freeInd.pop();
     cache[index.at(i)] = obj;
@@ -480,6 +758,124 @@ void DiskVectorBase<T>::cacheInsert(const unsigned int i, const T &obj) const
 #endif
 }
 
+template <typename T>
+void DiskVectorBase<T>::ioStart(void) const
+{
+    auto                        &io = *ioPtr_;
+    std::lock_guard<std::mutex> lock(io.mutex);
+
+    if (!io.thread.joinable())
+    {
+        io.stop   = false;
+        io.thread = std::thread([this](){ ioLoop(); });
+    }
+}
+
+template <typename T>
+void DiskVectorBase<T>::ioStop(void) const
+{
+    auto &io = *ioPtr_;
+
+    if (io.thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(io.mutex);
+
+            io.stop = true;
+        }
+        io.cv.notify_all();
+        io.thread.join();
+    }
+}
+
+template <typename T>
+void DiskVectorBase<T>::ioLoop(void) const
+{
+    auto &io = *ioPtr_;
+
+    while (true)
+    {
+        std::unique_lock<std::mutex> lock(io.mutex);
+        IoTask                       task;
+
+        io.cv.wait(lock, [&io](){ return io.stop or !io.queue.empty(); });
+        if (io.queue.empty())
+        {
+            break;
+        }
+        task = std::move(io.queue.front());
+        io.queue.pop_front();
+        lock.unlock();
+        try
+        {
+            if (task.isSave)
+            {
+                save(filename(task.i), *task.obj);
+            }
+            else
+            {
+                task.obj.reset(new T);
+                load(*task.obj, filename(task.i));
+            }
+        }
+        catch (...)
+        {
+            lock.lock();
+            io.error = std::current_exception();
+            lock.unlock();
+        }
+        lock.lock();
+        if (task.isSave)
+        {
+            if (--io.saving.at(task.i) == 0)
+            {
+                io.saving.erase(task.i);
+            }
+            io.nSaving--;
+        }
+        else
+        {
+            io.loading.erase(task.i);
+            if (!io.stale.erase(task.i) and !io.error)
+            {
+                io.ready[task.i] = std::move(task.obj);
+            }
+        }
+        lock.unlock();
+        io.cv.notify_all();
+    }
+}
+
+// both called with the I/O mutex held
+template <typename T>
+bool DiskVectorBase<T>::ioFull(const IoState &io) const
+{
+    return (io.ready.size() + io.loading.size() + io.nSaving >= cacheSize_);
+}
+
+template <typename T>
+void DiskVectorBase<T>::ioStaged(const IoState &io) const
+{
+    double n = io.ready.size() + io.loading.size() + io.nSaving;
+
+    const_cast<double &>(peakStaged_) = std::max(peakStaged_, n);
+}
+
+template <typename T>
+void DiskVectorBase<T>::ioRethrow(void) const
+{
+    auto                         &io = *ioPtr_;
+    std::unique_lock<std::mutex> lock(io.mutex);
+    std::exception_ptr           error = io.error;
+
+    io.error = nullptr;
+    lock.unlock();
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
 #ifdef DV_DEBUG
 #undef DV_DEBUG_MSG
 #endif
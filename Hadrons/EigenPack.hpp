@@ -174,17 +174,22 @@ namespace EigenPackIo
         }   
     }
     
+    // compression is a CompressedIO mode, applied after any precision change
     template <typename T, typename TIo = T>
     static void writePack(const std::string filename, std::vector<T> &evec, 
                           std::vector<RealD> &eval, PackRecord &record, 
                           const unsigned int size, bool multiFile, 
-                          GridBase *gridIo = nullptr)
+                          GridBase *gridIo = nullptr,
+                          const int compression = CompressedIO::None,
+                          const double tolerance = 0.)
     {
         GridBase             *grid = evec[0].Grid();
         std::unique_ptr<TIo> ioBuf{nullptr}; 
         std::unique_ptr<T>   testBuf{nullptr};
         ScidacWriter         binWriter(grid->IsBoss());
 
+        binWriter.setCompression(compression, tolerance);
+
         if (typeHash<T>() != typeHash<TIo>())
         {
             if (gridIo == nullptr)
@@ -283,7 +288,16 @@ public:
     {
         EigenPackIo::writePack<F, FIo>(evecFilename(fileStem, traj, multiFile), 
                                        this->evec, this->eval, this->record, 
-                                       this->evec.size(), multiFile, gridIo_);
+                                       this->evec.size(), multiFile, gridIo_,
+                                       compression_, tolerance_);
+    }
+
+    // store vectors as compressed records (CompressedIO::Lossless or
+    // BoundedError, with per site relative tolerance); reads detect it
+    void setCompression(const int compression, const double tolerance = 0.)
+    {
+        compression_ = compression;
+        tolerance_   = tolerance;
     }
 protected:
     std::string evecFilename(const std::string stem, const int traj, const bool multiFile)
@@ -301,6 +315,8 @@ protected:
     }
 protected:
     GridBase *gridIo_;
+    int      compression_{CompressedIO::None};
+    double   tolerance_{0.};
 };
 
 template <typename FineF, typename CoarseF, 
@@ -380,7 +396,8 @@ public:
     {
         EigenPackIo::writePack<CoarseF, CoarseFIo>(this->evecFilename(fileStem + "_coarse", traj, multiFile), 
                                                    evecCoarse, evalCoarse, this->record, 
-                                                   evecCoarse.size(), multiFile, gridCoarseIo_);
+                                                   evecCoarse.size(), multiFile, gridCoarseIo_,
+                                                   this->compression_, this->tolerance_);
     }
     
     virtual void write(const std::string fileStem, const bool multiFile, const int traj = -1)
@@ -184,6 +184,19 @@ void Hadrons::makeFileDir(const std::string filename, GridBase *g)
     }
 }
 
+int Hadrons::compressionMode(const std::string name)
+{
+    int mode = CompressedIO::ModeFromName(name);
+
+    if (mode < 0)
+    {
+        HADRONS_ERROR(Argument, "unknown compression '" + name 
+                      + "' (none, lossless or bounded-error)");
+    }
+
+    return mode;
+}
+
 void Hadrons::printTimeProfile(const std::map<std::string, GridTime> &timing, 
                                GridTime total)
 {
@@ -231,6 +231,9 @@ std::string basename(const std::string &s);
 std::string dirname(const std::string &s);
 void        makeFileDir(const std::string filename, GridBase *g = nullptr);
 
+// CompressedIO mode from a module parameter (none, lossless, bounded-error)
+int compressionMode(const std::string name);
+
 // default Schur convention
 #ifndef HADRONS_DEFAULT_SCHUR 
 #define HADRONS_DEFAULT_SCHUR DiagTwo
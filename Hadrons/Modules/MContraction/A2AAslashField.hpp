@@ -46,6 +46,8 @@ public:
     GRID_SERIALIZABLE_CLASS_MEMBERS(A2AAslashFieldPar,
                                     int, cacheBlock,
                                     int, block,
+                                    bool, pipelinedIo,
+                                    bool, collectiveIo,
                                     std::string, left,
                                     std::string, right,
                                     std::string, output,
@@ -237,6 +239,8 @@ void TA2AAslashField<FImpl, PhotonImpl>::execute(void)
     Kernel kernel(B0, B1, envGetGrid(FermionField));
 
     envGetTmp(Computation, computation);
+    computation.setPipelinedIo(par().pipelinedIo);
+    computation.setCollectiveIo(par().collectiveIo);
     computation.execute(left, right, kernel, ionameFn, filenameFn, metadataFn);
 #endif
 }
@@ -48,6 +48,8 @@ public:
     GRID_SERIALIZABLE_CLASS_MEMBERS(A2AMesonFieldPar,
                                     int, cacheBlock,
                                     int, block,
+                                    bool, pipelinedIo,
+                                    bool, collectiveIo,
                                     std::string, left,
                                     std::string, right,
                                     std::string, output,
@@ -305,6 +307,8 @@ void TA2AMesonField<FImpl>::execute(void)
     Kernel      kernel(gamma_, ph, envGetGrid(FermionField));
 
     envGetTmp(Computation, computation);
+    computation.setPipelinedIo(par().pipelinedIo);
+    computation.setCollectiveIo(par().collectiveIo);
     computation.execute(left, right, kernel, ionameFn, filenameFn, metadataFn);
 }
 
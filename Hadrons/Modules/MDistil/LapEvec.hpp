@@ -86,7 +86,9 @@ struct LapEvecPar: Serializable {
                                     ,StoutParameters,     Stout
                                     ,ChebyshevParameters, Cheby
                                     ,LanczosParameters,   Lanczos
-                                    ,std::string,         FileName)
+                                    ,std::string,         FileName
+                                    ,std::string,         compression
+                                    ,double,              tolerance)
 };
 
 /******************************************************************************
@@ -324,6 +326,7 @@ void TLapEvec<GImpl>::execute(void)
         eig4d.record.operatorXml = sOperatorXml;
         sEigenPackName.append(".");
         sEigenPackName.append(std::to_string(vm().getTrajectory()));
+        eig4d.setCompression(compressionMode(par().compression), par().tolerance);
         eig4d.write(sEigenPackName,false);
     }
 }
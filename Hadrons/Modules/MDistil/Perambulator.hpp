@@ -48,7 +48,9 @@ public:
                                     std::string, noise,
                                     std::string, PerambFileName,
                                     std::string, UnsmearedSinkFileName,
-                                    std::string, DistilParams);
+                                    std::string, DistilParams,
+                                    std::string, compression,
+                                    double,      tolerance);
 };
 
 template <typename FImpl>
@@ -253,7 +255,8 @@ void TPerambulator<FImpl>::execute(void)
     if (!UnsmearedSinkFileName.empty())
     {
         LOG(Message) << "Writing unsmeared sink to " << UnsmearedSinkFileName << std::endl;
-        A2AVectorsIo::write(UnsmearedSinkFileName, unsmeared_sink, false, vm().getTrajectory());
+        A2AVectorsIo::write(UnsmearedSinkFileName, unsmeared_sink, false, vm().getTrajectory(),
+                            compressionMode(par().compression), par().tolerance);
     }
 }
 
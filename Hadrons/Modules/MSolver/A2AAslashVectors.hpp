@@ -64,7 +64,9 @@ public:
                                   std::string, emField,
                                   std::string, solver,
                                   std::string, output,
-                                  bool,        multiFile);
+                                  bool,        multiFile,
+                                  std::string, compression,
+                                  double,      tolerance);
 };
 
 template <typename FImpl>
@@ -183,7 +185,8 @@ void TA2AAslashVectors<FImpl>::execute(void)
     if (!par().output.empty())
     {
         startTimer("I/O");
-        A2AVectorsIo::write(par().output, Aslashv, par().multiFile, vm().getTrajectory());
+        A2AVectorsIo::write(par().output, Aslashv, par().multiFile, vm().getTrajectory(),
+                            compressionMode(par().compression), par().tolerance);
         stopTimer("I/O");
     }
 }
@@ -53,7 +53,9 @@ public:
                                   std::string, eigenPack,
                                   std::string, solver,
                                   std::string, output,
-                                  bool,        multiFile);
+                                  bool,        multiFile,
+                                  std::string, compression,
+                                  double,      tolerance);
 };
 
 template <typename FImpl, typename Pack>
@@ -243,10 +245,12 @@ void TA2AVectors<FImpl, Pack>::execute(void)
     if (!par().output.empty())
     {
         startTimer("V I/O");
-        A2AVectorsIo::write(par().output + "_v", v, par().multiFile, vm().getTrajectory());
+        A2AVectorsIo::write(par().output + "_v", v, par().multiFile, vm().getTrajectory(),
+                            compressionMode(par().compression), par().tolerance);
         stopTimer("V I/O");
         startTimer("W I/O");
-        A2AVectorsIo::write(par().output + "_w", w, par().multiFile, vm().getTrajectory());
+        A2AVectorsIo::write(par().output + "_w", w, par().multiFile, vm().getTrajectory(),
+                            compressionMode(par().compression), par().tolerance);
         stopTimer("W I/O");
     }
 }
@@ -52,7 +52,9 @@ public:
                                     RealD,         coarseRelaxTol,
                                     std::string,   blockSize,
                                     std::string,   output,
-                                    bool,          multiFile);
+                                    bool,          multiFile,
+                                    std::string,   compression,
+                                    double,        tolerance);
 };
 
 template <typename FImpl, int nBasis, typename FImplIo = FImpl>
@@ -164,6 +166,7 @@ void TLocalCoherenceLanczos<FImpl, nBasis, FImplIo>::execute(void)
 
     epack.record.operatorXml = vm().getModule(par().action)->parString();
     epack.record.solverXml   = parString();
+    epack.setCompression(compressionMode(par().compression), par().tolerance);
     envGetTmp(LCL, solver);
     LOG(Message) << "Performing fine grid IRL -- Nstop= " 
                  << finePar.Nstop << ", Nk= " << finePar.Nk << ", Nm= " 
@@ -47,7 +47,9 @@ public:
                                     unsigned int, size,
                                     unsigned int, Ls,
                                     std::string,  output,
-                                    bool,         multiFile);
+                                    bool,         multiFile,
+                                    std::string,  compression,
+                                    double,       tolerance);
 };
 
 template <typename Field>
@@ -125,7 +127,8 @@ void TRandomVectors<Field>::execute(void)
     // I/O if necessary
     if (!par().output.empty())
     {
-        A2AVectorsIo::write(par().output, vec, par().multiFile, vm().getTrajectory());
+        A2AVectorsIo::write(par().output, vec, par().multiFile, vm().getTrajectory(),
+                            compressionMode(par().compression), par().tolerance);
     }
 }
 
@@ -0,0 +1,79 @@
+/*************************************************************************************
+
+Grid physics library, www.github.com/paboyle/Grid 
+
+Source file: Hadrons/Utilities/A2AMatrixToMap.cc
+
+Copyright (C) 2015-2019
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+See the full license in the file "LICENSE" in the top level distribution directory
+*************************************************************************************/
+/*  END LEGAL */
+#include <Hadrons/Global.hpp>
+#include <Hadrons/A2AMatrix.hpp>
+
+using namespace Grid;
+using namespace Hadrons;
+
+int main(int argc, char *argv[])
+{
+    // parse command line
+    std::string  outFilename, inFilename, dataset;
+    unsigned int nt;
+    bool         dp;
+
+    if (argc < 5)
+    {
+        std::cerr << "usage: " << argv[0] << " <out map file> <in HDF5 file> <dataset> <Nt> [double {0|1}] [Grid options]";
+        std::cerr << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+    outFilename = argv[1];
+    inFilename  = argv[2];
+    dataset     = argv[3];
+    nt          = std::stoi(std::string(argv[4]));
+    dp          = (argc > 5) and (std::string(argv[5]) == "1");
+
+    // initialization
+    Grid_init(&argc, &argv);
+    initLogger();
+
+    // execution
+    try
+    {
+        LOG(Message) << "Converting '" << inFilename << "' (dataset '" << dataset
+                     << "') to '" << outFilename << "'" << std::endl;
+        if (dp)
+        {
+            A2AMatrixMap<ComplexD>::convert<HADRONS_A2AM_IO_TYPE>(outFilename, inFilename, dataset, nt);
+        }
+        else
+        {
+            A2AMatrixMap<ComplexF>::convert<HADRONS_A2AM_IO_TYPE>(outFilename, inFilename, dataset, nt);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        Exceptions::abort(e);
+    }
+
+    // epilogue
+    LOG(Message) << "Grid is finalizing now" << std::endl;
+    Grid_finalize();
+
+    return EXIT_SUCCESS;
+}
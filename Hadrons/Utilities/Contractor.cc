@@ -235,6 +235,119 @@ inline std::ostream & operator<< (std::ostream& s, const Bytes &&b)
     return s;
 }
 
+// A2A matrix operand: a disk vector filled from an HDF5 file for each
+// trajectory, or a flat memory-mapped file read in place from the page cache
+class A2AMatrixSource
+{
+public:
+    typedef Eigen::Ref<const A2AMatrix<ComplexD>> Slice;
+public:
+    A2AMatrixSource(const std::string dirName, const unsigned int nt, 
+                    const unsigned int cacheSize)
+    : vec_(dirName, nt, cacheSize)
+    {}
+
+    void load(const std::string filename, const std::string dataset, 
+              const unsigned int nt)
+    {
+        unsigned int typeSize = 0;
+
+        mapF_.close();
+        mapD_.close();
+        mapped_ = 0;
+        if (A2AMatrixMap<ComplexF>::isMapFile(filename, &typeSize))
+        {
+            if (typeSize == sizeof(ComplexF))
+            {
+                mapF_.open(filename);
+                checkNt(mapF_.getNt(), nt);
+            }
+            else
+            {
+                mapD_.open(filename);
+                checkNt(mapD_.getNt(), nt);
+            }
+            mapped_ = typeSize;
+            std::cout << "Mapped " << nt << " time slices" << std::endl;
+        }
+        else
+        {
+            A2AMatrixIo<HADRONS_A2AM_IO_TYPE> a2aIo(filename, dataset, nt);
+            double                            t;
+
+            a2aIo.load(vec_, &t);
+            std::cout << "Read " << a2aIo.getSize() << " bytes in " << t/1.0e6 
+                    << " sec, " << a2aIo.getSize()/t*1.0e6/1024/1024 << " MB/s" << std::endl;
+        }
+    }
+
+    // read-only view of time slice t, valid until the next access; mapped
+    // double precision slices and cached disk vector entries are not copied,
+    // mapped single precision slices are converted into a buffer
+    Slice operator[](const unsigned int t)
+    {
+        if (mapped_ == sizeof(ComplexF))
+        {
+            buf_ = mapF_[t].template cast<ComplexD>();
+
+            return Slice(buf_);
+        }
+        else if (mapped_ == sizeof(ComplexD))
+        {
+            return Slice(mapD_[t]);
+        }
+        else
+        {
+            return Slice(static_cast<const EigenDiskVector<ComplexD> &>(vec_)[t]);
+        }
+    }
+
+    void prefetch(const unsigned int t)
+    {
+        if (mapped_ == sizeof(ComplexF))
+        {
+            mapF_.prefetch(t);
+        }
+        else if (mapped_ == sizeof(ComplexD))
+        {
+            mapD_.prefetch(t);
+        }
+        else
+        {
+            vec_.prefetch(t);
+        }
+    }
+
+    void printStat(const std::string name)
+    {
+        if (!mapped_)
+        {
+            vec_.printStat(name);
+        }
+    }
+
+    void resetStat(void)
+    {
+        vec_.resetStat();
+    }
+private:
+    static void checkNt(const unsigned int nt, const unsigned int expected)
+    {
+        if (nt != expected)
+        {
+            HADRONS_ERROR(Size, "all-to-all time size mismatch (got "
+                + std::to_string(nt) + ", expected " 
+                + std::to_string(expected) + ")");
+        }
+    }
+private:
+    EigenDiskVector<ComplexD> vec_;
+    A2AMatrixMap<ComplexF>    mapF_;
+    A2AMatrixMap<ComplexD>    mapD_;
+    unsigned int              mapped_{0};
+    A2AMatrix<ComplexD>       buf_;
+};
+
 int main(int argc, char* argv[])
 {
     // parse command line
@@ -261,14 +374,14 @@ int main(int argc, char* argv[])
     //    nCont = par.product.size();
 
     // create diskvectors
-    std::map<std::string, EigenDiskVector<ComplexD>> a2aMat;
+    std::map<std::string, A2AMatrixSource> a2aMat;
     //    unsigned int                                     cacheSize;
 
     for (auto &p: par.a2aMatrix)
     {
         std::string dirName = par.global.diskVectorDir + "/" + p.name;
 
-        a2aMat.emplace(p.name, EigenDiskVector<ComplexD>(dirName, par.global.nt, p.cacheSize));
+        a2aMat.emplace(p.name, A2AMatrixSource(dirName, par.global.nt, p.cacheSize));
     }
 
     // trajectory loop
@@ -281,17 +394,10 @@ int main(int argc, char* argv[])
         for (auto &p: par.a2aMatrix)
         {
             std::string filename = p.file;
-            double      t;
-	    //	    double  size;
 
             tokenReplace(filename, "traj", traj);
             std::cout << "======== Loading '" << filename << "'" << std::endl;
-
-            A2AMatrixIo<HADRONS_A2AM_IO_TYPE> a2aIo(filename, p.dataset, par.global.nt);
-
-            a2aIo.load(a2aMat.at(p.name), &t);
-            std::cout << "Read " << a2aIo.getSize() << " bytes in " << t/1.0e6 
-                    << " sec, " << a2aIo.getSize()/t*1.0e6/1024/1024 << " MB/s" << std::endl;
+            a2aMat.at(p.name).load(filename, p.dataset, par.global.nt);
         }
 
         // contract
@@ -344,11 +450,32 @@ int main(int argc, char* argv[])
                     << timeSeq.size()*translations.size()*par.global.nt << " tr(A*B)"
                     << std::endl;
 
+            // prefetch the A*B operands of the step after (i, dt)
+            auto prefetchStep = [&](const unsigned int i, std::set<unsigned int>::iterator dt)
+            {
+                unsigned int ni = i;
+
+                if (++dt == translations.end())
+                {
+                    ni++;
+                    dt = translations.begin();
+                }
+                if ((ni >= timeSeq.size()) or (dt == translations.end()))
+                {
+                    return;
+                }
+                for (unsigned int j = 0; j < term.size() - 1; ++j)
+                {
+                    a2aMat.at(term[j]).prefetch(TIME_MOD(timeSeq[ni][j] + *dt));
+                }
+            };
+
             std::cout << "* Caching transposed last term" << std::endl;
             for (unsigned int t = 0; t < par.global.nt; ++t)
             {
+                a2aMat.at(term.back()).prefetch(TIME_MOD(t + 1));
                 tAr.startTimer("Disk vector overhead");
-                const A2AMatrix<ComplexD> &ref = a2aMat.at(term.back())[t];
+                A2AMatrixSource::Slice ref = a2aMat.at(term.back())[t];
                 tAr.stopTimer("Disk vector overhead");
 
                 tAr.startTimer("Transpose caching");
@@ -374,8 +501,11 @@ int main(int argc, char* argv[])
                 {
                     result.correlator[tLast] = 0.;
                 }
-                for (auto &dt: translations)
+                for (auto dtIt = translations.begin(); dtIt != translations.end(); ++dtIt)
                 {
+                    const unsigned int dt = *dtIt;
+
+                    prefetchStep(i, dtIt);
                     std::cout << "* Step " << i*translations.size() + dti + 1
                             << "/" << timeSeq.size()*translations.size()
                             << " -- positions= " << t << ", dt= " << dt << std::endl;
@@ -394,7 +524,7 @@ int main(int argc, char* argv[])
                     for (unsigned int j = 1; j < term.size() - 1; ++j)
                     {
                         tAr.startTimer("Disk vector overhead");
-                        const A2AMatrix<ComplexD> &ref = a2aMat.at(term[j])[TIME_MOD(t[j] + dt)];
+                        A2AMatrixSource::Slice ref = a2aMat.at(term[j])[TIME_MOD(t[j] + dt)];
                         tAr.stopTimer("Disk vector overhead");
                         
                         tAr.startTimer("A*B total");
@@ -451,6 +581,11 @@ int main(int argc, char* argv[])
             tAr.stopTimer("Total");
             printTimeProfile(tAr.getTimings(), tAr.getTimer("Total"));
         }
+        for (auto &m: a2aMat)
+        {
+            m.second.printStat(m.first);
+            m.second.resetStat();
+        }
     }
     
     return EXIT_SUCCESS;
@@ -41,6 +41,47 @@ int main (int argc, char ** argv)
     readBenchmark<LatticeFermion>(latt, filestem(l), limeRead<LatticeFermion>);
   }
 
+  //////////////////////////////////////////////////////////////
+  // Aggregated POSIX I/O against MPI-IO; --io-stripe applies
+  //////////////////////////////////////////////////////////////
+  MSG << "Benchmark binary I/O, aggregators per node (0 = MPI-IO)" << std::endl;
+  MSG << SEP << std::endl;
+  int saved_aggregators = BinaryIO::ioAggregators;
+  std::vector<int> aggregators({0, 1, 2, 4});
+  for (int l = 8; l <= BENCH_IO_LMAX; l += 8)
+  {
+    auto             mpi  = GridDefaultMpi();
+    std::vector<int> latt = {l*mpi[0], l*mpi[1], l*mpi[2], l*mpi[3]};
+    auto             simd = GridDefaultSimd(latt.size(), vComplex::Nsimd());
+    GridCartesian    grid(latt, simd, mpi);
+    GridParallelRNG  rng(&grid);
+    LatticeFermion   vec(&grid), chk(&grid);
+    double           gb = (double)grid.gSites()*sizeof(LatticeFermion::vector_object::scalar_object)/1.0e9;
+
+    rng.SeedFixedIntegers(std::vector<int>({1, 2, 3, 4}));
+    random(rng, vec);
+    for (auto a: aggregators)
+    {
+      BinaryIO::ioAggregators = a;
+
+      grid.Barrier();
+      double t0 = usecond();
+      binaryWrite(filestem(l), vec);
+      grid.Barrier();
+      double t1 = usecond();
+      binaryRead(chk, filestem(l));
+      grid.Barrier();
+      double t2 = usecond();
+
+      chk = chk - vec;
+      MSG << "L=" << l << "^4 local, aggregators " << a
+          << " : write " << gb/((t1-t0)/1.0e6) << " GB/s"
+          << " read " << gb/((t2-t1)/1.0e6) << " GB/s"
+          << " error " << norm2(chk) << std::endl;
+    }
+  }
+  BinaryIO::ioAggregators = saved_aggregators;
+
   Grid_finalize();
 
   return EXIT_SUCCESS;
@@ -36,6 +36,30 @@ void limeRead(Field &vec, const std::string filestem)
   binReader.close();
 }
 
+template <typename Field>
+void binaryWrite(const std::string filestem, Field &vec)
+{
+  typedef typename Field::vector_object::scalar_object sobj;
+  BinarySimpleUnmunger<sobj, sobj> munge;
+  uint64_t offset = 0;
+  uint32_t nersc_csum, scidac_csuma, scidac_csumb;
+
+  BinaryIO::writeLatticeObject<typename Field::vector_object, sobj>(vec, filestem + ".raw", munge, offset, "IEEE64BIG",
+                                                                   nersc_csum, scidac_csuma, scidac_csumb);
+}
+
+template <typename Field>
+void binaryRead(Field &vec, const std::string filestem)
+{
+  typedef typename Field::vector_object::scalar_object sobj;
+  BinarySimpleMunger<sobj, sobj> munge;
+  uint64_t offset = 0;
+  uint32_t nersc_csum, scidac_csuma, scidac_csumb;
+
+  BinaryIO::readLatticeObject<typename Field::vector_object, sobj>(vec, filestem + ".raw", munge, offset, "IEEE64BIG",
+                                                                  nersc_csum, scidac_csuma, scidac_csumb);
+}
+
 inline void makeGrid(std::shared_ptr<GridBase> &gPt, 
                      const std::shared_ptr<GridCartesian> &gBasePt,
                      const unsigned int Ls = 1, const bool rb = false)
@@ -349,6 +349,83 @@ int main (int argc, char ** argv)
   }    
 
 
+  std::cout<<GridLogMessage << "===================================================================================================="<<std::endl;
+  std::cout<<GridLogMessage << "= Benchmarking persistent vs reposted STENCIL halo exchange latency in "<<nmu<<" dimensions"<<std::endl;
+  std::cout<<GridLogMessage << "===================================================================================================="<<std::endl;
+  std::cout <<GridLogMessage << " L  "<<"\t"<<" Ls  "<<"\t"
+            <<std::setw(11)<<"bytes"<<"\t"<<"repost us/call (err)"<<"\t"<<"persistent us/call (err)"<<"\t"<<"saving us/call"<<std::endl;
+
+  const int Ls=1;
+  for(int lat=2;lat<=maxlat;lat*=2){
+
+    Coordinate latt_size  ({lat*mpi_layout[0],
+			    lat*mpi_layout[1],
+			    lat*mpi_layout[2],
+			    lat*mpi_layout[3]});
+
+    GridCartesian     Grid(latt_size,simd_layout,mpi_layout);
+
+    std::vector<HalfSpinColourVectorD *> xbuf(8);
+    std::vector<HalfSpinColourVectorD *> rbuf(8);
+    Grid.ShmBufferFreeAll();
+    uint64_t bytes = lat*lat*lat*Ls*sizeof(HalfSpinColourVectorD);
+    for(int d=0;d<8;d++){
+      xbuf[d] = (HalfSpinColourVectorD *)Grid.ShmBufferMalloc(bytes);
+      rbuf[d] = (HalfSpinColourVectorD *)Grid.ShmBufferMalloc(bytes);
+    }
+
+    // Same geometry both ways; persistent requests are bound once outside the loop
+    std::vector<int> xmit_to(8), recv_from(8), dirs;
+    for(int mu=0;mu<4;mu++){
+      if (mpi_layout[mu]>1 ) {
+	Grid.ShiftedRanks(mu,1,              xmit_to[mu],  recv_from[mu]);
+	Grid.ShiftedRanks(mu,mpi_layout[mu]-1,xmit_to[mu+4],recv_from[mu+4]);
+	dirs.push_back(mu);
+	dirs.push_back(mu+4);
+      }
+    }
+    std::vector<std::vector<CommsRequest_t> > persistent(8);
+    for(auto d : dirs){
+      Grid.StencilSendToRecvFromPersistentInit(persistent[d],
+					       (void *)&xbuf[d][0],xmit_to[d],
+					       (void *)&rbuf[d][0],recv_from[d],
+					       bytes,d);
+    }
+
+    time_statistics repost_stat;
+    time_statistics persist_stat;
+    for(int mode=0;mode<2;mode++){
+      for(int i=0;i<Nloop;i++){
+	Grid.Barrier();
+	double start=usecond();
+	if ( mode==0 ) {
+	  std::vector<CommsRequest_t> requests;
+	  for(auto d : dirs){
+	    Grid.StencilSendToRecvFromBegin(requests,
+					    (void *)&xbuf[d][0],xmit_to[d],
+					    (void *)&rbuf[d][0],recv_from[d],
+					    bytes,d);
+	  }
+	  Grid.StencilSendToRecvFromComplete(requests,0);
+	} else {
+	  for(auto d : dirs) Grid.StencilSendToRecvFromPersistentStart(persistent[d],d);
+	  for(auto d : dirs) Grid.StencilSendToRecvFromPersistentComplete(persistent[d],d);
+	}
+	double stop=usecond();
+	t_time[i] = stop-start; // microseconds
+      }
+      if ( mode==0 ) repost_stat.statistics(t_time);
+      else           persist_stat.statistics(t_time);
+    }
+    for(auto d : dirs) Grid.StencilSendToRecvFromPersistentFree(persistent[d]);
+
+    std::cout<<GridLogMessage << std::setw(4) << lat<<"\t"<<Ls<<"\t"
+	     <<std::setw(11) << bytes<< std::fixed << std::setprecision(2) << "\t"
+	     <<repost_stat.mean <<" ("<<repost_stat.err <<")\t\t"
+	     <<persist_stat.mean<<" ("<<persist_stat.err<<")\t\t"
+	     <<repost_stat.mean-persist_stat.mean<<std::endl;
+  }
+
   std::cout<<GridLogMessage << "===================================================================================================="<<std::endl;
   std::cout<<GridLogMessage << "= Benchmarking sequential STENCIL halo exchange in "<<nmu<<" dimensions"<<std::endl;
   std::cout<<GridLogMessage << "===================================================================================================="<<std::endl;
@@ -0,0 +1,117 @@
+/*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid 
+
+    Source file: ./benchmarks/Benchmark_heatbath.cc
+
+    Copyright (C) 2015
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+#define LMAX (24)
+#define LMIN (8)
+#define LADD (8)
+
+  int Nloop=5;
+  RealD beta=6.0;
+
+  Coordinate simd_layout = GridDefaultSimd(Nd,vComplex::Nsimd());
+  Coordinate mpi_layout  = GridDefaultMpi();
+
+  int64_t threads = GridThread::GetThreads();
+  std::cout<<GridLogMessage << "Grid is setup to use "<<threads<<" threads"<<std::endl;
+
+  std::cout<<GridLogMessage << "===================================================================================================="<<std::endl;
+  std::cout<<GridLogMessage << "= Benchmarking quenched heatbath sweeps: masked SubGroupHeatBath vs SUnHeatbath"<<std::endl;
+  std::cout<<GridLogMessage << "===================================================================================================="<<std::endl;
+  std::cout<<GridLogMessage << "  L  "<<"\t\t"<<"masked ms/sweep"<<"\t"<<"fused ms/sweep"<<"\t"<<"fused+4OR ms/sweep"<<"\t"<<"fused link updates/s"<<std::endl;
+  std::cout<<GridLogMessage << "----------------------------------------------------------"<<std::endl;
+
+  for(int lat=LMIN;lat<=LMAX;lat+=LADD){
+
+    Coordinate latt_size  ({lat*mpi_layout[0],lat*mpi_layout[1],lat*mpi_layout[2],lat*mpi_layout[3]});
+    int64_t vol = latt_size[0]*latt_size[1]*latt_size[2]*latt_size[3];
+
+    GridCartesian     Grid(latt_size,simd_layout,mpi_layout);
+    GridRedBlackCartesian RBGrid(&Grid);
+
+    GridParallelRNG  pRNG(&Grid); pRNG.SeedFixedIntegers(std::vector<int>({45,12,81,9}));
+    GridSerialRNG    sRNG;        sRNG.SeedFixedIntegers(std::vector<int>({45,12,81,9}));
+
+    LatticeGaugeField Umu(&Grid);
+    LatticeColourMatrix link(&Grid), staple(&Grid);
+    SU3::HotConfiguration(pRNG,Umu);
+
+    //////////////////////////////////////////////
+    // Masked full lattice heatbath, one subgroup at a time
+    //////////////////////////////////////////////
+    int subsets[2] = { Even, Odd };
+    LatticeInteger one(&RBGrid);  one = 1;
+    LatticeInteger mask(&Grid);
+
+    double start=usecond();
+    for(int i=0;i<Nloop;i++){
+      for(int cb=0;cb<2;cb++){
+	one.Checkerboard()=subsets[cb];
+	mask= Zero();
+	setCheckerboard(mask,one);
+	for(int mu=0;mu<Nd;mu++){
+	  ColourWilsonLoops::Staple(staple,Umu,mu);
+	  link = PeekIndex<LorentzIndex>(Umu,mu);
+	  for(int subgroup=0;subgroup<SU3::su2subgroups();subgroup++){
+	    SU3::SubGroupHeatBath(sRNG,pRNG,beta,link,staple,subgroup,20,mask);
+	  }
+	  PokeIndex<LorentzIndex>(Umu,link,mu);
+	}
+      }
+      ProjectOnGroup(Umu);
+    }
+    double stop=usecond();
+    double masked = (stop-start)/Nloop/1000.;
+
+    //////////////////////////////////////////////
+    // Fused site local update
+    //////////////////////////////////////////////
+    SUnHeatbath<PeriodicGimplR> HB(&Grid);
+    SU3::HotConfiguration(pRNG,Umu);
+
+    start=usecond();
+    for(int i=0;i<Nloop;i++) HB.Sweep(sRNG,beta,Umu);
+    stop=usecond();
+    double fused = (stop-start)/Nloop/1000.;
+
+    start=usecond();
+    for(int i=0;i<Nloop;i++) HB.Sweep(sRNG,beta,Umu,4);
+    stop=usecond();
+    double fused_or = (stop-start)/Nloop/1000.;
+
+    double rate = vol*Nd/(fused*1.0e-3);
+    std::cout<<GridLogMessage<<std::setprecision(3) << lat<<"\t\t"<<masked<<"\t\t"<<fused<<"\t\t"<<fused_or<<"\t\t\t"<<rate<<std::endl;
+  }
+
+  Grid_finalize();
+}
@@ -0,0 +1,107 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid 
+
+    Source file: ./tests/IO/Test_binary_io_aggregated.cc
+
+    Copyright (C) 2015
+
+Author: Azusa Yamaguchi <ayamaguc@staffmail.ed.ac.uk>
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+Author: paboyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+template<class Field> void writeFile(Field &f,std::string file,int lexico,uint32_t csum[3])
+{
+  typedef typename Field::vector_object vobj;
+  typedef typename vobj::scalar_object sobj;
+  GridBase *grid = f.Grid();
+  std::vector<sobj> iodata(grid->lSites());
+  unvectorizeToLexOrdArray(iodata,f);
+  uint64_t offset=0;
+  int control = BinaryIO::BINARYIO_WRITE | (lexico ? BinaryIO::BINARYIO_LEXICOGRAPHIC : BinaryIO::BINARYIO_UNORDERED);
+  BinaryIO::IOobject((RealD)0,grid,iodata,file,offset,"IEEE64BIG",control,csum[0],csum[1],csum[2]);
+}
+template<class Field> void readFile(Field &f,std::string file,int lexico,uint32_t csum[3])
+{
+  typedef typename Field::vector_object vobj;
+  typedef typename vobj::scalar_object sobj;
+  GridBase *grid = f.Grid();
+  std::vector<sobj> iodata(grid->lSites());
+  uint64_t offset=0;
+  int control = BinaryIO::BINARYIO_READ | (lexico ? BinaryIO::BINARYIO_LEXICOGRAPHIC : BinaryIO::BINARYIO_UNORDERED);
+  BinaryIO::IOobject((RealD)0,grid,iodata,file,offset,"IEEE64BIG",control,csum[0],csum[1],csum[2]);
+  vectorizeFromLexOrdArray(iodata,f);
+}
+
+/////////////////////////////////////////////////////////////////////
+// Aggregated pwrite/pread I/O interoperates with the per rank and
+// MPI-IO paths; run under --mpi to exercise the gathers
+/////////////////////////////////////////////////////////////////////
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  Coordinate simd_layout = GridDefaultSimd(4,vComplex::Nsimd());
+  Coordinate mpi_layout  = GridDefaultMpi();
+  Coordinate latt_size   = GridDefaultLatt();
+  GridCartesian     Grid(latt_size,simd_layout,mpi_layout);
+
+  GridParallelRNG   pRNG(&Grid);  pRNG.SeedFixedIntegers(std::vector<int>({45,12,81,9}));
+
+  LatticeFermion src(&Grid); random(pRNG,src);
+  LatticeFermion chk(&Grid);
+
+  std::vector<uint64_t> stripes({0,4096,100000});
+  for(int lexico=0;lexico<2;lexico++){
+  for(int s=0;s<stripes.size();s++){
+    uint32_t wcsum[3], rcsum[3];
+
+    // aggregated write, plain read
+    BinaryIO::ioStripe      = stripes[s];
+    BinaryIO::ioAggregators = 2;
+    writeFile(src,"agg_io.bin",lexico,wcsum);
+    BinaryIO::ioAggregators = 0;
+    readFile(chk,"agg_io.bin",lexico,rcsum);
+    chk = chk - src;
+    std::cout << GridLogMessage << (lexico ? "lexicographic" : "unordered") << " stripe " << stripes[s]
+	      << " aggregated write / plain read error " << norm2(chk) << std::endl;
+    assert(norm2(chk)==0.0);
+    for(int c=0;c<3;c++) assert(wcsum[c]==rcsum[c]);
+
+    // plain write, aggregated read
+    writeFile(src,"agg_io.bin",lexico,wcsum);
+    BinaryIO::ioAggregators = 1;
+    readFile(chk,"agg_io.bin",lexico,rcsum);
+    chk = chk - src;
+    std::cout << GridLogMessage << (lexico ? "lexicographic" : "unordered") << " stripe " << stripes[s]
+	      << " plain write / aggregated read error " << norm2(chk) << std::endl;
+    assert(norm2(chk)==0.0);
+    for(int c=0;c<3;c++) assert(wcsum[c]==rcsum[c]);
+  }}
+  BinaryIO::ioAggregators = 0;
+  BinaryIO::ioStripe      = 0;
+
+  Grid_finalize();
+}
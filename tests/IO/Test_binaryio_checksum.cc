@@ -0,0 +1,101 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid 
+
+    Source file: ./tests/IO/Test_binaryio_checksum.cc
+
+    Copyright (C) 2015
+
+Author: Azusa Yamaguchi <ayamaguc@staffmail.ed.ac.uk>
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+Author: paboyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+/////////////////////////////////////////////////////////////////////
+// Fused endian conversion + checksums against the separate passes
+/////////////////////////////////////////////////////////////////////
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  Coordinate simd_layout = GridDefaultSimd(4,vComplex::Nsimd());
+  Coordinate mpi_layout  = GridDefaultMpi();
+  Coordinate latt_size   = GridDefaultLatt();
+  GridCartesian     Grid(latt_size,simd_layout,mpi_layout);
+
+  GridParallelRNG   pRNG(&Grid);  pRNG.SeedFixedIntegers(std::vector<int>({45,12,81,9}));
+
+  typedef LatticeGaugeField::vector_object::scalar_object sobj;
+
+  LatticeGaugeField U(&Grid);
+  random(pRNG,U);
+  std::vector<sobj> data(Grid.lSites());
+  unvectorizeToLexOrdArray(data,U);
+
+  std::vector<std::string> formats({"IEEE32BIG","IEEE32","IEEE64BIG","IEEE64"});
+  for(int f=0;f<formats.size();f++){
+    int ieee32big = (formats[f] == std::string("IEEE32BIG"));
+    int ieee32    = (formats[f] == std::string("IEEE32"));
+    int ieee64big = (formats[f] == std::string("IEEE64BIG"));
+    int ieee64    = (formats[f] == std::string("IEEE64"));
+    int wordsize  = (ieee32||ieee32big) ? 4 : 8;
+    int swap      = (ieee32big||ieee64big) ? !BinaryIO::HostBigEndian() : BinaryIO::HostBigEndian();
+
+    for(int read=0;read<2;read++){
+      std::vector<sobj> a(data), b(data);
+      uint32_t na=0,sa=0,ta=0;
+      uint32_t nb=0,sb=0,tb=0;
+
+      if ( read ) {
+	BinaryIO::ScidacChecksum(&Grid,a,sa,ta);
+	if (ieee32big) BinaryIO::be32toh_v((void *)&a[0], sizeof(sobj)*a.size());
+	if (ieee32)    BinaryIO::le32toh_v((void *)&a[0], sizeof(sobj)*a.size());
+	if (ieee64big) BinaryIO::be64toh_v((void *)&a[0], sizeof(sobj)*a.size());
+	if (ieee64)    BinaryIO::le64toh_v((void *)&a[0], sizeof(sobj)*a.size());
+	BinaryIO::NerscChecksum(&Grid,a,na);
+      } else {
+	BinaryIO::NerscChecksum(&Grid,a,na);
+	if (ieee32big) BinaryIO::htobe32_v((void *)&a[0], sizeof(sobj)*a.size());
+	if (ieee32)    BinaryIO::htole32_v((void *)&a[0], sizeof(sobj)*a.size());
+	if (ieee64big) BinaryIO::htobe64_v((void *)&a[0], sizeof(sobj)*a.size());
+	if (ieee64)    BinaryIO::htole64_v((void *)&a[0], sizeof(sobj)*a.size());
+	BinaryIO::ScidacChecksum(&Grid,a,sa,ta);
+      }
+
+      BinaryIO::EndianChecksum(&Grid,b,wordsize,swap,read,nb,sb,tb);
+
+      int same = (memcmp(&a[0],&b[0],sizeof(sobj)*a.size())==0);
+      std::cout << GridLogMessage << formats[f] << (read ? " read " : " write ")
+		<< std::hex << na << "/" << sa << "/" << ta << " fused "
+		<< nb << "/" << sb << "/" << tb << std::dec
+		<< (same ? " data match" : " data DIFFER") << std::endl;
+      assert(same);
+      assert(na==nb);
+      assert(sa==sb);
+      assert(ta==tb);
+    }
+  }
+
+  Grid_finalize();
+}
@@ -0,0 +1,100 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid 
+
+    Source file: ./tests/IO/Test_hmc_checkpoint_async.cc
+
+    Copyright (C) 2015
+
+Author: Azusa Yamaguchi <ayamaguc@staffmail.ed.ac.uk>
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+Author: paboyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  Coordinate simd_layout = GridDefaultSimd(4,vComplex::Nsimd());
+  Coordinate mpi_layout  = GridDefaultMpi();
+  Coordinate latt_size   = GridDefaultLatt();
+
+  GridCartesian     Grid(latt_size,simd_layout,mpi_layout);
+
+  GridParallelRNG   pRNG(&Grid);  pRNG.SeedFixedIntegers(std::vector<int>({45,12,81,9}));
+  GridSerialRNG     sRNG;         sRNG.SeedFixedIntegers(std::vector<int>({45,12,81,9}));
+
+  typedef PeriodicGimplR Gimpl;
+  typedef Gimpl::GaugeField GaugeField;
+
+  GaugeField U(&Grid);
+  GaugeField Uref(&Grid);
+  GaugeField Urd(&Grid);
+  SU3::HotConfiguration(pRNG,U);
+
+  //////////////////////////////////////////////////////////////
+  // Background writes of successive "trajectories", the field and
+  // RNGs moving on while each write is in flight
+  //////////////////////////////////////////////////////////////
+  CheckpointerParameters CPparams("ckpoint_async_lat","ckpoint_async_rng",1,"IEEE64BIG",1);
+  BinaryHmcCheckpointer<Gimpl> Async(CPparams);
+  NerscHmcCheckpointer<Gimpl>  AsyncNersc(CPparams);
+
+  std::vector<GaugeField> saved(3,&Grid);
+  std::vector<LatticeComplex> next(3,&Grid);
+  for(int traj=1;traj<=3;traj++){
+    saved[traj-1] = U;
+    Async.TrajectoryComplete(traj,U,sRNG,pRNG);
+    random(pRNG,next[traj-1]);   // what a restored RNG must draw next
+    SU3::HotConfiguration(pRNG,U);
+  }
+  Async.Finalize();
+
+  for(int traj=1;traj<=3;traj++){
+    GridParallelRNG   pRNGrd(&Grid);
+    GridSerialRNG     sRNGrd;
+    Async.CheckpointRestore(traj,Urd,sRNGrd,pRNGrd);
+    Urd = Urd - saved[traj-1];
+    LatticeComplex c(&Grid);
+    random(pRNGrd,c);
+    c = c - next[traj-1];
+    std::cout << GridLogMessage << "trajectory "<<traj<<" gauge difference "<<norm2(Urd)
+	      << " rng difference "<<norm2(c)<<std::endl;
+    assert(norm2(Urd)==0.0);
+    assert(norm2(c)==0.0);
+  }
+
+  //////////////////////////////////////////////////////////////
+  // NERSC format through the same path; restore implies the wait
+  //////////////////////////////////////////////////////////////
+  Uref = U;
+  AsyncNersc.TrajectoryComplete(10,U,sRNG,pRNG);
+  SU3::HotConfiguration(pRNG,U);
+  AsyncNersc.CheckpointRestore(10,Urd,sRNG,pRNG);
+  Urd = Urd - Uref;
+  std::cout << GridLogMessage << "NERSC gauge difference "<<norm2(Urd)<<std::endl;
+  assert(norm2(Urd)/norm2(Uref) < 1.0e-12);  // stored in single precision
+
+  Grid_finalize();
+}
@@ -0,0 +1,80 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid 
+
+    Source file: ./tests/IO/Test_nersc_mmap_read.cc
+
+    Copyright (C) 2015
+
+Author: Azusa Yamaguchi <ayamaguc@staffmail.ed.ac.uk>
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+Author: paboyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+/////////////////////////////////////////////////////////////////////
+// The mmap reader must agree bit for bit, checksums included, with
+// the staged reader for every NERSC flavour: 3x3 / two row, 32 / 64 bit,
+// both mapping the slab at once and one slice per window
+/////////////////////////////////////////////////////////////////////
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  Coordinate simd_layout = GridDefaultSimd(4,vComplex::Nsimd());
+  Coordinate mpi_layout  = GridDefaultMpi();
+  Coordinate latt_size   = GridDefaultLatt();
+  GridCartesian     Grid(latt_size,simd_layout,mpi_layout);
+
+  GridParallelRNG   pRNG(&Grid);  pRNG.SeedFixedIntegers(std::vector<int>({45,12,81,9}));
+
+  LatticeGaugeField Umu(&Grid);
+  LatticeGaugeField Uref(&Grid);
+  LatticeGaugeField Ummap(&Grid);
+  SU<Nc>::HotConfiguration(pRNG,Umu);
+
+  std::string file("mmap_read.nersc");
+  uint64_t window = BinaryIO::ioMmapWindow;
+  for(int two_row=0;two_row<2;two_row++){
+  for(int bits32=0;bits32<2;bits32++){
+  for(int slice=0;slice<2;slice++){
+    FieldMetaData header;
+    NerscIO::writeConfiguration(Umu,file,two_row,bits32);
+
+    BinaryIO::ioMmap = 0;
+    NerscIO::readConfiguration(Uref,header,file);
+    BinaryIO::ioMmap = 1;
+    BinaryIO::ioMmapWindow = slice ? 1 : window;
+    NerscIO::readConfiguration(Ummap,header,file);
+    BinaryIO::ioMmap = 0;
+    BinaryIO::ioMmapWindow = window;
+
+    // NerscIO asserts the checksum and plaquette against the header on read
+    Uref = Uref - Ummap;
+    std::cout << GridLogMessage << "two_row " << two_row << " bits32 " << bits32 << " slice " << slice
+	      << " mmap / staged read difference " << norm2(Uref) << std::endl;
+    assert(norm2(Uref)==0.0);
+  }}}
+
+  Grid_finalize();
+}
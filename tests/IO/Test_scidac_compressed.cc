@@ -0,0 +1,174 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid 
+
+    Source file: ./tests/IO/Test_scidac_compressed.cc
+
+    Copyright (C) 2015
+
+Author: Azusa Yamaguchi <ayamaguc@staffmail.ed.ac.uk>
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+Author: paboyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+// largest |error| over the words of a site relative to its largest |word|, on this rank
+template<class Field> RealD maxSiteError(Field &a,Field &b)
+{
+  typedef typename Field::vector_object::scalar_object sobj;
+  typedef typename getPrecision<sobj>::real_scalar_type word;
+  const int nwords = sizeof(sobj)/sizeof(word);
+  GridBase *grid = a.Grid();
+  std::vector<sobj> sa(grid->lSites()), sb(grid->lSites());
+  unvectorizeToLexOrdArray(sa,a);
+  unvectorizeToLexOrdArray(sb,b);
+  RealD err=0.0;
+  for(uint64_t s=0;s<sa.size();s++){
+    word *wa = (word *)&sa[s];
+    word *wb = (word *)&sb[s];
+    RealD m=0.0, e=0.0;
+    for(int i=0;i<nwords;i++){
+      m = std::max(m,(RealD)std::fabs(wa[i]));
+      e = std::max(e,(RealD)std::fabs(wa[i]-wb[i]));
+    }
+    if ( m>0.0 ) err = std::max(err,e/m);
+  }
+  return err;
+}
+
+/////////////////////////////////////////////////////////////////////
+// Compressed SciDAC records: lossless round trip is exact, bounded
+// error stays within its per site tolerance, compressed records
+// interleave with plain ones in a single file, and a record reads back
+// on a different processor grid
+/////////////////////////////////////////////////////////////////////
+int main (int argc, char ** argv)
+{
+#ifdef HAVE_LIME
+  Grid_init(&argc,&argv);
+
+  Coordinate simd_layout = GridDefaultSimd(4,vComplex::Nsimd());
+  Coordinate mpi_layout  = GridDefaultMpi();
+  Coordinate latt_size   = GridDefaultLatt();
+  GridCartesian     Grid(latt_size,simd_layout,mpi_layout);
+  GridCartesian     GridF(latt_size,GridDefaultSimd(4,vComplexF::Nsimd()),mpi_layout);
+
+  GridParallelRNG   pRNG(&Grid);  pRNG.SeedFixedIntegers(std::vector<int>({45,12,81,9}));
+
+  LatticeFermion    psi(&Grid); random(pRNG,psi);
+  LatticeFermion    chk(&Grid);
+  LatticeGaugeField Umu(&Grid); SU<Nc>::ColdConfiguration(pRNG,Umu);
+  LatticeGaugeField Uchk(&Grid);
+  LatticeFermionF   psiF(&GridF); precisionChange(psiF,psi);
+  LatticeFermionF   chkF(&GridF);
+
+  // small chunks so that chunk boundaries do not fall on rank boundaries
+  CompressedIO::ChunkSites = 100;
+
+  emptyUserRecord record;
+  std::string file("./scidac_compressed.bin");
+  std::vector<RealD> tolerance({1.0e-3,1.0e-6});
+  {
+    ScidacWriter WR(Grid.IsBoss());
+    WR.open(file);
+    WR.setCompression(CompressedIO::Lossless);
+    WR.writeScidacFieldRecord(psi,record);
+    WR.writeScidacFieldRecord(Umu,record);
+    WR.writeScidacFieldRecord(psiF,record);
+    WR.setCompression(CompressedIO::None);
+    WR.writeScidacFieldRecord(psi,record);
+    for(int t=0;t<tolerance.size();t++){
+      WR.setCompression(CompressedIO::BoundedError,tolerance[t]);
+      WR.writeScidacFieldRecord(psi,record);
+    }
+    WR.close();
+  }
+  {
+    ScidacReader RD;
+    RD.open(file);
+
+    RD.readScidacFieldRecord(chk,record);
+    chk = chk - psi;
+    std::cout << GridLogMessage << "lossless fermion error " << norm2(chk) << std::endl;
+    assert(norm2(chk)==0.0);
+
+    RD.readScidacFieldRecord(Uchk,record);
+    Uchk = Uchk - Umu;
+    std::cout << GridLogMessage << "lossless gauge error " << norm2(Uchk) << std::endl;
+    assert(norm2(Uchk)==0.0);
+
+    RD.readScidacFieldRecord(chkF,record);
+    chkF = chkF - psiF;
+    std::cout << GridLogMessage << "lossless single precision fermion error " << norm2(chkF) << std::endl;
+    assert(norm2(chkF)==0.0);
+
+    RD.skipScidacFieldRecord();
+
+    for(int t=0;t<tolerance.size();t++){
+      RD.readScidacFieldRecord(chk,record);
+      RealD err = maxSiteError(psi,chk);
+      std::cout << GridLogMessage << "bounded error tolerance " << tolerance[t]
+		<< " worst site error " << err << std::endl;
+      assert(err <= tolerance[t]);
+      assert(err > 0.0);
+    }
+    RD.close();
+  }
+
+  // Move a factor of two of the processor grid to another dimension
+  Coordinate mpi_other = mpi_layout;
+  int moved = 0;
+  for(int d=0;d<Nd && !moved;d++){
+    if ( mpi_layout[d]%2 ) continue;
+    for(int e=0;e<Nd;e++){
+      if ( (e==d) || (latt_size[e]%(2*mpi_layout[e]*simd_layout[e])) ) continue;
+      mpi_other[d] /= 2;
+      mpi_other[e] *= 2;
+      moved = 1;
+      break;
+    }
+  }
+  if ( moved ) {
+    GridCartesian  Grid2(latt_size,simd_layout,mpi_other);
+    LatticeFermion ref2(&Grid2);
+    LatticeFermion chk2(&Grid2);
+    ScidacReader RD;
+    RD.open(file);
+    RD.readScidacFieldRecord(chk2,record);
+    RD.skipScidacFieldRecord();
+    RD.skipScidacFieldRecord();
+    RD.readScidacFieldRecord(ref2,record);
+    RD.close();
+    chk2 = chk2 - ref2;
+    std::cout << GridLogMessage << "lossless fermion read on " << mpi_other
+	      << " error " << norm2(chk2) << std::endl;
+    assert(norm2(ref2)==norm2(psi));
+    assert(norm2(chk2)==0.0);
+  } else {
+    std::cout << GridLogMessage << "no other processor grid for " << mpi_layout << ", skipped" << std::endl;
+  }
+  CompressedIO::ChunkSites = 4096;
+
+  Grid_finalize();
+#endif
+}
@@ -0,0 +1,188 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid 
+
+    Source file: ./tests/core/Test_gauge_stencil.cc
+
+    Copyright (C) 2015
+
+Author: Azusa Yamaguchi <ayamaguc@staffmail.ed.ac.uk>
+Author: paboyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+// Fused staple / plaquette kernels against the WilsonLoops reference
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  Coordinate simd_layout = GridDefaultSimd(Nd,vComplex::Nsimd());
+  Coordinate mpi_layout  = GridDefaultMpi();
+  Coordinate latt_size   = GridDefaultLatt();
+
+  GridCartesian Grid(latt_size,simd_layout,mpi_layout);
+
+  GridParallelRNG pRNG(&Grid);
+  pRNG.SeedFixedIntegers(std::vector<int>({45,12,81,9}));
+
+  LatticeGaugeField Umu(&Grid);
+  SU3::HotConfiguration(pRNG,Umu);
+
+  typedef PeriodicGimplR Gimpl;
+  GaugeStencil<Gimpl> stencil(&Grid,2);
+
+  std::vector<LatticeColourMatrix> U (Nd,&Grid);
+  std::vector<LatticeColourMatrix> U2(Nd,&Grid);
+  std::vector<LatticeColourMatrix> staple(Nd,&Grid);
+  std::vector<LatticeColourMatrix> rect  (Nd,&Grid);
+  LatticeColourMatrix ref(&Grid);
+  LatticeColourMatrix one(&Grid);
+  LatticeColourMatrix diff(&Grid);
+  for(int mu=0;mu<Nd;mu++){
+    U[mu] = PeekIndex<LorentzIndex>(Umu,mu);
+    WilsonLoops<Gimpl>::RectStapleDouble(U2[mu],U[mu],mu);
+  }
+
+  RealD tol = 1.0e-10;
+  if ( sizeof(RealD) != sizeof(vComplex::scalar_type)/2 ) tol = 1.0e-4;
+
+  ////////////////////////////////////////////
+  // Plaquette
+  ////////////////////////////////////////////
+  RealD p_ref = WilsonLoops<Gimpl>::avgPlaquette(Umu);
+  RealD p_st  = stencil.avgPlaquette(Umu);
+  std::cout << GridLogMessage << "avgPlaquette WilsonLoops " << p_ref << " stencil " << p_st << std::endl;
+  assert(fabs(p_ref-p_st) < tol);
+
+  RealD r_ref = WilsonLoops<Gimpl>::avgRectangle(Umu);
+  RealD r_st  = stencil.avgRectangle(Umu);
+  std::cout << GridLogMessage << "avgRectangle WilsonLoops " << r_ref << " stencil " << r_st << std::endl;
+  assert(fabs(r_ref-r_st) < tol);
+
+  ////////////////////////////////////////////
+  // Staples, all mu and single mu, and 2x1 staples
+  ////////////////////////////////////////////
+  stencil.RectStaple(staple,rect,Umu);
+  for(int mu=0;mu<Nd;mu++){
+    WilsonLoops<Gimpl>::Staple(ref,Umu,mu);
+    RealD n = norm2(ref);
+    diff = ref-staple[mu];
+    RealD d = norm2(diff);
+    stencil.Staple(one,Umu,mu);
+    diff = ref-one;
+    RealD d1 = norm2(diff);
+    std::cout << GridLogMessage << "Staple mu=" << mu << " |ref|^2 " << n << " |diff|^2 " << d << " " << d1 << std::endl;
+    assert(d/n < tol && d1/n < tol);
+
+    WilsonLoops<Gimpl>::RectStapleUnoptimised(ref,Umu,mu);
+    n = norm2(ref);
+    diff = ref-rect[mu];
+    d = norm2(diff);
+    std::cout << GridLogMessage << "RectStaple mu=" << mu << " |ref|^2 " << n << " |diff|^2 " << d << std::endl;
+    assert(d/n < tol);
+  }
+
+  ////////////////////////////////////////////
+  // Gauge forces through the actions
+  ////////////////////////////////////////////
+  LatticeGaugeField dS_ref(&Grid);
+  LatticeGaugeField dS_st(&Grid);
+  LatticeGaugeField dS_diff(&Grid);
+  {
+    WilsonGaugeActionR      wilson(5.6);
+    IwasakiGaugeActionR     iwasaki(2.13);
+
+    GaugeStencilBase::Fused = 0;
+    wilson.deriv(Umu,dS_ref);
+    GaugeStencilBase::Fused = 1;
+    wilson.deriv(Umu,dS_st);
+    dS_diff = dS_ref-dS_st;
+    RealD d = norm2(dS_diff)/norm2(dS_ref);
+    std::cout << GridLogMessage << "WilsonGaugeAction force rel diff " << d << std::endl;
+    assert(d < tol);
+
+    GaugeStencilBase::Fused = 0;
+    iwasaki.deriv(Umu,dS_ref);
+    RealD S_ref = iwasaki.S(Umu);
+    GaugeStencilBase::Fused = 1;
+    iwasaki.deriv(Umu,dS_st);
+    RealD S_st = iwasaki.S(Umu);
+    dS_diff = dS_ref-dS_st;
+    d = norm2(dS_diff)/norm2(dS_ref);
+    std::cout << GridLogMessage << "IwasakiGaugeAction force rel diff " << d << " action " << S_ref << " " << S_st << std::endl;
+    assert(d < tol);
+    assert(fabs(S_ref-S_st) < tol*fabs(S_ref));
+  }
+
+  ////////////////////////////////////////////
+  // APE derivative, again after the links are updated in place; unstamped,
+  // at a stale stamp, and reusing the links stamped after the staples
+  ////////////////////////////////////////////
+  {
+    std::vector<double> rho(Nd*Nd);
+    for(int mn=0;mn<Nd*Nd;mn++) rho[mn] = (mn%(Nd+1)) ? 0.1+0.01*mn : 0.0;
+    Smear_APE<Gimpl> ape(rho);
+    LatticeGaugeField iLambda(&Grid);
+    LatticeGaugeField Uorig(&Grid);
+    gaussian(pRNG,iLambda);
+    Uorig = Umu;
+    for(int pass=0;pass<2;pass++){
+      dS_ref = Zero();
+      ape.derivative(dS_ref,iLambda,Umu);
+      for(int stamp=0;stamp<3;stamp++){
+	uint64_t version = 0;
+	if ( stamp==1 ) version = pass+1;
+	if ( stamp==2 ) {
+	  version = pass+1;
+	  stencil.Staple(dS_st,Umu,rho);
+	  stencil.Stamp(version);
+	}
+	dS_st = Zero();
+	stencil.ApeDerivative(dS_st,iLambda,Umu,rho,version);
+	dS_diff = dS_ref-dS_st;
+	RealD d = norm2(dS_diff)/norm2(dS_ref);
+	std::cout << GridLogMessage << "ApeDerivative pass " << pass << " stamp " << stamp << " rel diff " << d << std::endl;
+	assert(d < tol);
+      }
+      SU3::HotConfiguration(pRNG,Umu);
+    }
+    Umu = Uorig;
+  }
+
+  ////////////////////////////////////////////
+  // Timing
+  ////////////////////////////////////////////
+  int ncall = 10;
+  double t0 = usecond();
+  for(int i=0;i<ncall;i++){
+    for(int mu=0;mu<Nd;mu++) WilsonLoops<Gimpl>::Staple(staple[mu],Umu,mu);
+  }
+  double t1 = usecond();
+  for(int i=0;i<ncall;i++){
+    stencil.Staple(staple,Umu);
+  }
+  double t2 = usecond();
+  std::cout << GridLogMessage << "Staples, all mu: WilsonLoops " << (t1-t0)/ncall << " us, stencil " << (t2-t1)/ncall << " us" << std::endl;
+
+  std::cout << GridLogMessage << "Test_gauge_stencil passed" << std::endl;
+  Grid_finalize();
+}
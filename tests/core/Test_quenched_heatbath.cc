@@ -0,0 +1,96 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid 
+
+    Source file: ./tests/Test_quenched_heatbath.cc
+
+    Copyright (C) 2015
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  GridCartesian * grid = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(),
+							GridDefaultSimd(Nd,vComplex::Nsimd()),
+							GridDefaultMpi());
+
+  RealD beta = 6.0;
+  int sweeps = 40;
+  int noverrelax = 4;
+  if( GridCmdOptionExists(argv,argv+argc,"--beta") ){
+    std::string arg = GridCmdOptionPayload(argv,argv+argc,"--beta");
+    beta = std::stod(arg);
+  }
+  if( GridCmdOptionExists(argv,argv+argc,"--sweeps") ){
+    std::string arg = GridCmdOptionPayload(argv,argv+argc,"--sweeps");
+    sweeps = std::stoi(arg);
+  }
+  if( GridCmdOptionExists(argv,argv+argc,"--overrelax") ){
+    std::string arg = GridCmdOptionPayload(argv,argv+argc,"--overrelax");
+    noverrelax = std::stoi(arg);
+  }
+
+  std::vector<int> pseeds({1,2,3,4,5});
+  std::vector<int> sseeds({6,7,8,9,10});
+  GridParallelRNG  pRNG(grid); pRNG.SeedFixedIntegers(pseeds);
+  GridSerialRNG    sRNG;       sRNG.SeedFixedIntegers(sseeds);
+
+  LatticeGaugeField Umu(grid);
+  SU3::HotConfiguration(pRNG,Umu);
+
+  SUnHeatbath<PeriodicGimplR> HB(grid);
+
+  ////////////////////////////////////////////
+  // Overrelaxation is microcanonical
+  ////////////////////////////////////////////
+  RealD p0 = ColourWilsonLoops::avgPlaquette(Umu);
+  HB.OverRelax(sRNG,beta,Umu,2);
+  RealD p1 = ColourWilsonLoops::avgPlaquette(Umu);
+  std::cout << GridLogMessage << "Overrelaxation plaquette " << p0 << " -> " << p1 << std::endl;
+  assert(fabs(p1-p0) < 1.0e-10);
+
+  ////////////////////////////////////////////
+  // Heatbath + overrelaxation updates
+  ////////////////////////////////////////////
+  RealD plaq = 0.0;
+  for(int sweep=0;sweep<sweeps;sweep++){
+    double t0 = usecond();
+    RealD acc = HB.Sweep(sRNG,beta,Umu,noverrelax);
+    double t1 = usecond();
+    plaq = ColourWilsonLoops::avgPlaquette(Umu);
+    std::cout << GridLogMessage << "sweep " << sweep << " PLAQUETTE " << plaq
+	      << " acceptance " << acc << " " << (t1-t0)/1000 << " ms" << std::endl;
+  }
+
+  LatticeColourMatrix link(grid), check(grid);
+  for(int mu=0;mu<Nd;mu++){
+    link  = PeekIndex<LorentzIndex>(Umu,mu);
+    check = link*adj(link) - 1.0;
+    assert(norm2(check) < 1.0e-8);
+  }
+  // Equilibrium plaquette at beta=6 is 0.5937 in the infinite volume
+  if ( (beta==6.0) && (sweeps>=40) ) assert(fabs(plaq-0.594) < 0.01);
+
+  Grid_finalize();
+}
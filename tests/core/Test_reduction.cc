@@ -0,0 +1,94 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid 
+
+    Source file: ./tests/core/Test_reduction.cc
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+ ;
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  Coordinate latt_size   = GridDefaultLatt();
+  Coordinate simd_layout = GridDefaultSimd(4,vComplex::Nsimd());
+  Coordinate mpi_layout  = GridDefaultMpi();
+     
+  GridCartesian     Grid(latt_size,simd_layout,mpi_layout);
+
+  std::vector<int> seeds({1,2,3,4});
+  GridParallelRNG          fpRNG(&Grid);  fpRNG.SeedFixedIntegers(seeds);
+
+  LatticeFermion p(&Grid); gaussian(fpRNG,p);
+  LatticeFermion r(&Grid); gaussian(fpRNG,r);
+  LatticeFermion q(&Grid); gaussian(fpRNG,q);
+
+  ////////////////////////////////////////////////////////////////
+  // Batched and single reductions must agree bit for bit
+  ////////////////////////////////////////////////////////////////
+  const LatticeFermion *left [3] = { &p, &r, &r };
+  const LatticeFermion *right[3] = { &q, &r, &q };
+  ComplexD batch[3];
+  innerProductBatch<3>(batch,left,right);
+
+  ComplexD pq = innerProduct(p,q);
+  RealD    rr = norm2(r);
+  ComplexD rq = innerProduct(r,q);
+  std::cout<<GridLogMessage << "<p,q> " << pq << " batched " << batch[0] <<std::endl;
+  std::cout<<GridLogMessage << "|r|^2 " << rr << " batched " << batch[1] <<std::endl;
+  std::cout<<GridLogMessage << "<r,q> " << rq << " batched " << batch[2] <<std::endl;
+  assert(pq == batch[0]);
+  assert(rr == real(batch[1]));
+  assert(rq == batch[2]);
+
+  ////////////////////////////////////////////////////////////////
+  // Independent of thread count
+  ////////////////////////////////////////////////////////////////
+  int nthreads = GridThread::GetThreads();
+  for(int t=1;t<=nthreads;t++){
+    GridThread::SetThreads(t);
+    ComplexD ip   = innerProduct(p,q);
+    RealD    nrm  = norm2(p);
+    auto     ssum = sum(p);
+    LatticeFermion z(&Grid);
+    RealD    zn   = axpy_norm(z,2.0,p,q);
+    std::cout<<GridLogMessage << t <<" threads : <p,q> " << ip << " |p|^2 " << nrm << " |2p+q|^2 "<<zn<<std::endl;
+    assert(ip == pq);
+    if ( t==1 ) continue;
+    GridThread::SetThreads(1);
+    assert(nrm == norm2(p));
+    assert(zn  == axpy_norm(z,2.0,p,q));
+    auto s1 = sum(p);
+    auto d  = s1-ssum;
+    assert(norm2(d) == 0.0);
+  }
+  GridThread::SetThreads(nthreads);
+  std::cout<<GridLogMessage << "Reductions are bit reproducible over 1.."<<nthreads<<" threads"<<std::endl;
+
+  Grid_finalize();
+}
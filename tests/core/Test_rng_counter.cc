@@ -0,0 +1,209 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid 
+
+    Source file: ./tests/Test_rng_counter.cc
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+template<class Field>
+RealD SiteDiff(Field &a,Field &b)
+{
+  typedef typename Field::vector_object::scalar_object sobj;
+  GridBase *grid = a.Grid();
+  RealD diff=0;
+  Coordinate gcoor;
+  for(int g=0;g<grid->gSites();g++){
+    grid->GlobalIndexToGlobalCoor(g,gcoor);
+    sobj sa,sb;
+    peekSite(sa,a,gcoor);
+    peekSite(sb,b,gcoor);
+    diff += norm2(sa-sb);
+  }
+  return diff;
+}
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  //////////////////////////////////////////////
+  // Known answers for Philox4x32-10 (Random123 kat_vectors)
+  //////////////////////////////////////////////
+  {
+    uint32_t ctr[3][4] = { {0,0,0,0},
+			   {0xffffffff,0xffffffff,0xffffffff,0xffffffff},
+			   {0x243f6a88,0x85a308d3,0x13198a2e,0x03707344} };
+    uint32_t key[3][2] = { {0,0},
+			   {0xffffffff,0xffffffff},
+			   {0xa4093822,0x299f31d0} };
+    uint32_t ref[3][4] = { {0x6627e8d5,0xe169c58d,0xbc57ac4c,0x9b00dbd8},
+			   {0x408f276d,0x41c83b0e,0xa20bc7c6,0x6d5451fd},
+			   {0xd16cfe09,0x94fdcceb,0x5001e420,0x24126ea1} };
+    for(int t=0;t<3;t++){
+      uint32_t out[4];
+      GridPhilox::Generate(out,ctr[t],key[t]);
+      for(int i=0;i<4;i++) assert(out[i]==ref[t][i]);
+    }
+    std::cout<<GridLogMessage<<"Philox4x32-10 known answers ok"<<std::endl;
+  }
+
+  GridParallelRNG::CounterBased=1;
+
+  Coordinate latt_size   = GridDefaultLatt();
+  Coordinate simd_layout = GridDefaultSimd(4,vComplex::Nsimd());
+  Coordinate mpi_layout  = GridDefaultMpi();
+  Coordinate flat_layout({vComplex::Nsimd(),1,1,1});
+
+  GridCartesian     Grid(latt_size,simd_layout,mpi_layout);
+  GridCartesian     Flat(latt_size,flat_layout,mpi_layout);  // all SIMD lanes in x
+  Flat.show_decomposition();
+
+  std::vector<int> seeds({1,2,3,4});
+
+  GridParallelRNG  pRNG(&Grid);  pRNG.SeedFixedIntegers(seeds);
+  GridParallelRNG  fRNG(&Flat);  fRNG.SeedFixedIntegers(seeds);
+  assert(pRNG.IsCounterBased());
+
+  //////////////////////////////////////////////
+  // Same field whatever the SIMD layout
+  //////////////////////////////////////////////
+  LatticeFermion src(&Grid), ref(&Grid), tmp(&Grid), fsrc(&Flat);
+  LatticeColourMatrix U(&Grid), fU(&Flat);
+  LatticeReal  b(&Grid), fb(&Flat);
+
+  gaussian(pRNG,src);  gaussian(fRNG,fsrc);
+  random(pRNG,U);      random(fRNG,fU);
+  bernoulli(pRNG,b);   bernoulli(fRNG,fb);
+
+  RealD dsrc = SiteDiff(src,fsrc);
+  RealD dU   = SiteDiff(U,fU);
+  std::cout<<GridLogMessage<<"layout difference gaussian "<<dsrc<<" uniform "<<dU<<std::endl;
+  assert(dsrc==0.0);
+  assert(dU==0.0);
+  RealD bsum = TensorRemove(sum(b));
+  std::cout<<GridLogMessage<<"bernoulli mean "<<bsum/Grid.gSites()<<" "<<TensorRemove(sum(fb))/Grid.gSites()<<std::endl;
+  assert(bsum==TensorRemove(sum(fb)));
+
+  //////////////////////////////////////////////
+  // Lanes generated together match one stream per site
+  //////////////////////////////////////////////
+  {
+    std::vector<GridRNGbase::RngStateType> saved;
+    pRNG.GetState(saved,0);
+    uint32_t key[2] = { (uint32_t)saved[1], (uint32_t)saved[2] };
+    uint32_t draw   = saved[3];
+    gaussian(pRNG,tmp);
+    RealD diff=0;
+    for(int g=0;g<Grid.gSites();g++){
+      Coordinate gcoor;
+      Grid.GlobalIndexToGlobalCoor(g,gcoor);
+      SpinColourVector s;
+      peekSite(s,tmp,gcoor);
+      ComplexD *w = (ComplexD *)&s;
+      GridPhiloxStream gen(key,g,draw);
+      std::normal_distribution<RealD> d(0.0,1.0);
+      for(int i=0;i<Ns*Nc;i++){
+	ComplexD z;
+	fillScalar(z,d,gen);
+	diff += norm(z-w[i]);
+      }
+    }
+    std::cout<<GridLogMessage<<"single stream difference "<<diff<<std::endl;
+    assert(diff==0.0);
+  }
+
+  //////////////////////////////////////////////
+  // Successive fills differ; statistics sane
+  //////////////////////////////////////////////
+  gaussian(pRNG,ref);
+  RealD n2 = norm2(ref);
+  RealD expect = Grid.gSites()*Ns*Nc*2*1.0;
+  std::cout<<GridLogMessage<<"norm2 gaussian "<<n2<<" expect "<<expect<<std::endl;
+  tmp = ref-src;
+  assert(norm2(tmp)>0.0);
+  assert(fabs(n2/expect-1.0)<0.05);
+
+  //////////////////////////////////////////////
+  // Checkpoint state round trip
+  //////////////////////////////////////////////
+  {
+    std::vector<GridRNGbase::RngStateType> saved;
+    pRNG.GetState(saved,0);
+    gaussian(pRNG,src);
+    GridParallelRNG rRNG(&Grid);
+    rRNG.SetState(saved,0);
+    gaussian(rRNG,tmp);
+    tmp = tmp-src;
+    std::cout<<GridLogMessage<<"restored state difference "<<norm2(tmp)<<std::endl;
+    assert(norm2(tmp)==0.0);
+  }
+
+  //////////////////////////////////////////////
+  // RNG file round trip, counter based and per site engines;
+  // the format tag must match the restoring RNG
+  //////////////////////////////////////////////
+  for(int counter=1;counter>=0;counter--){
+    GridParallelRNG::CounterBased=counter;
+    GridParallelRNG wRNG(&Grid); wRNG.SeedFixedIntegers(seeds);
+    GridParallelRNG rRNG(&Grid);
+    GridSerialRNG   sRNG;        sRNG.SeedFixedIntegers(seeds);
+    std::string file("rng_counter.bin");
+    uint32_t nersc_w,scidac_wa,scidac_wb;
+    uint32_t nersc_r,scidac_ra,scidac_rb;
+    BinaryIO::writeRNG(sRNG,wRNG,file,0,nersc_w,scidac_wa,scidac_wb);
+    BinaryIO::readRNG (sRNG,rRNG,file,0,nersc_r,scidac_ra,scidac_rb);
+    assert(rRNG.IsCounterBased()==counter);
+    assert(nersc_w==nersc_r && scidac_wa==scidac_ra && scidac_wb==scidac_rb);
+    gaussian(wRNG,src);
+    gaussian(rRNG,tmp);
+    tmp = tmp-src;
+    std::cout<<GridLogMessage<<"counter "<<counter<<" RNG file round trip difference "<<norm2(tmp)<<std::endl;
+    assert(norm2(tmp)==0.0);
+  }
+  GridParallelRNG::CounterBased=1;
+
+  //////////////////////////////////////////////
+  // 5d fill from a 4d RNG
+  //////////////////////////////////////////////
+  {
+    const int Ls=4;
+    GridCartesian *FGrid = SpaceTimeGrid::makeFiveDimGrid(Ls,&Grid);
+    GridCartesian *FFlat = SpaceTimeGrid::makeFiveDimGrid(Ls,&Flat);
+    LatticeFermion s5(FGrid), f5(FFlat);
+    pRNG.SeedFixedIntegers(seeds);
+    fRNG.SeedFixedIntegers(seeds);
+    gaussian(pRNG,s5);
+    gaussian(fRNG,f5);
+    RealD d5 = SiteDiff(s5,f5);
+    std::cout<<GridLogMessage<<"5d layout difference "<<d5<<std::endl;
+    assert(d5==0.0);
+  }
+
+  pRNG.Report();
+  Grid_finalize();
+}
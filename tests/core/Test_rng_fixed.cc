@@ -73,6 +73,56 @@ int main (int argc, char ** argv)
   random(fpRNG,lcv);
   std::cout<<GridLogMessage<<"Random Lattice Colour Vector (fixed seed)\n"<< lcv<<std::endl;
 
+#ifdef RNG_FAST_DISCARD
+  //////////////////////////////////////////////////////////////////////
+  // Seeding visits local sites only; check each site's stream is still
+  // the master engine skipped by its global index, and that the
+  // fields agree between SIMD decompositions. Rerun under --mpi to
+  // vary the rank decomposition.
+  //////////////////////////////////////////////////////////////////////
+  {
+    std::seed_seq src(seeds.begin(),seeds.end());
+    GridRNGbase::RngEngine master(src);
+
+    GridParallelRNG cRNG(&Grid); cRNG.SeedFixedIntegers(seeds);
+    int bad=0;
+    for(int gidx=0;gidx<Grid.gSites();gidx+=7){
+      GridRNGbase::RngEngine eng(master);
+      GridRNGbase::Skip(eng,gidx);
+      std::uniform_int_distribution<uint32_t> uid;
+      uint32_t expect = uid(eng);
+      if ( cRNG.GlobalU01(gidx) != expect ) bad++;
+    }
+    std::cout<<GridLogMessage<<"Streams differing from global skip seeding: "<<bad<<std::endl;
+    assert(bad==0);
+
+    std::vector<Coordinate> layouts;
+    layouts.push_back(Coordinate({vComplex::Nsimd(),1,1,1}));
+    layouts.push_back(Coordinate({1,vComplex::Nsimd(),1,1}));
+    if ( vComplex::Nsimd()%2==0 ) layouts.push_back(Coordinate({vComplex::Nsimd()/2,1,2,1}));
+
+    for(int l=0;l<layouts.size();l++){
+      GridCartesian   LGrid(latt_size,layouts[l],mpi_layout);
+      GridParallelRNG lRNG(&LGrid); lRNG.SeedFixedIntegers(seeds);
+      GridParallelRNG gRNG(&Grid);  gRNG.SeedFixedIntegers(seeds);
+      LatticeFermion a(&Grid), b(&LGrid);
+      gaussian(gRNG,a);
+      gaussian(lRNG,b);
+      RealD diff=0;
+      Coordinate gcoor;
+      for(int g=0;g<Grid.gSites();g++){
+	Grid.GlobalIndexToGlobalCoor(g,gcoor);
+	SpinColourVector sa,sb;
+	peekSite(sa,a,gcoor);
+	peekSite(sb,b,gcoor);
+	diff+=norm2(sa-sb);
+      }
+      std::cout<<GridLogMessage<<"Simd layout "<<layouts[l]<<" difference "<<diff<<std::endl;
+      assert(diff==0.0);
+    }
+  }
+#endif
+
 
   Grid_finalize();
 }
@@ -0,0 +1,157 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid 
+
+    Source file: ./tests/Test_stout_force.cc
+
+    Copyright (C) 2015
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+typedef SmearedConfiguration<PeriodicGimplR> SmearedConf;
+
+// Smeared Wilson action and its force on the thin links, as the integrator sees them
+RealD SmearedAction(WilsonGaugeActionR &Action,SmearedConf &Conf,LatticeGaugeField &U,LatticeGaugeField *UdSdU)
+{
+  Conf.set_Field(U);
+  RealD S = Action.S(Conf.get_U(true));
+  if ( UdSdU ) {
+    Action.deriv(Conf.get_SmearedU(),*UdSdU);
+    Conf.smeared_force(*UdSdU);
+  }
+  return S;
+}
+
+void TestStout(GridCartesian &Grid,GridParallelRNG &pRNG,LatticeGaugeField &U,Smear_Stout<PeriodicGimplR> &Stout)
+{
+  WilsonGaugeActionR Action(1.0);
+  SmearedConf Conf(&Grid,3,Stout);
+
+  ////////////////////////////////////
+  // Site local exp(iQ) against the Taylor series
+  ////////////////////////////////////
+  LatticeGaugeField Usmr(&Grid), C(&Grid);
+  Smear_Stout<PeriodicGimplR>::CoeffField coeff(&Grid);
+  Stout.smear(Usmr,C,coeff,U);
+  LatticeColourMatrix Umu(&Grid), Cmu(&Grid), iQ(&Grid), diff(&Grid);
+  for(int mu=0;mu<Nd;mu++){
+    Umu  = PeekIndex<LorentzIndex>(U,mu);
+    Cmu  = PeekIndex<LorentzIndex>(C,mu);
+    iQ   = Ta(Cmu*adj(Umu));
+    if ( norm2(iQ) > 0.0 ) diff = expMat(iQ,1.0,30)*Umu;
+    else                   diff = Umu;   // unsmeared direction
+    Umu  = PeekIndex<LorentzIndex>(Usmr,mu);
+    diff = diff - Umu;
+    std::cout << GridLogMessage << "mu "<<mu<<" |exp(iQ)U - Usmr|^2 " << norm2(diff) << std::endl;
+    assert(norm2(diff) < 1.0e-20);
+  }
+
+  ////////////////////////////////////
+  // Force through three levels, WilsonLoops and stencil staples
+  ////////////////////////////////////
+  LatticeGaugeField UdSdU(&Grid), UdSdU_st(&Grid);
+  int fused = GaugeStencilBase::Fused;
+  GaugeStencilBase::Fused = 0;
+  RealD S = SmearedAction(Action,Conf,U,&UdSdU);
+  GaugeStencilBase::Fused = 1;
+  RealD S_st = SmearedAction(Action,Conf,U,&UdSdU_st);
+  GaugeStencilBase::Fused = fused;
+
+  LatticeGaugeField gdiff(&Grid);
+  gdiff = UdSdU - UdSdU_st;
+  RealD nf = norm2(UdSdU);
+  RealD nd = norm2(gdiff);
+  std::cout << GridLogMessage << " S " << S << " stencil " << S_st << std::endl;
+  std::cout << GridLogMessage << " |force|^2 " << nf << " stencil difference " << nd << std::endl;
+  assert(fabs(S-S_st) < 1.0e-10*fabs(S));
+  assert(nd < 1.0e-20*nf);
+
+  ////////////////////////////////////
+  // Modify the gauge field a little
+  ////////////////////////////////////
+  RealD dt = 0.0001;
+
+  LatticeColourMatrix mommu(&Grid);
+  LatticeGaugeField mom(&Grid);
+  LatticeGaugeField Uprime(&Grid), Uminus(&Grid);
+  for(int mu=0;mu<Nd;mu++){
+    SU3::GaussianFundamentalLieAlgebraMatrix(pRNG, mommu); // Traceless antihermitian momentum; gaussian in lie alg
+    PokeIndex<LorentzIndex>(mom,mommu,mu);
+    Umu = PeekIndex<LorentzIndex>(U,mu);
+    Cmu = expMat(mommu,dt,12)*Umu;
+    PokeIndex<LorentzIndex>(Uprime,Cmu,mu);
+    Cmu = expMat(mommu,-dt,12)*Umu;
+    PokeIndex<LorentzIndex>(Uminus,Cmu,mu);
+  }
+  // central difference; the O(dt^2) term is a few percent of dS at this dt
+  RealD Sprime = SmearedAction(Action,Conf,Uprime,nullptr);
+  RealD Sminus = SmearedAction(Action,Conf,Uminus,nullptr);
+
+  //////////////////////////////////////////////
+  // Use derivative to estimate dS
+  //////////////////////////////////////////////
+  LatticeComplex dS(&Grid); dS = Zero();
+  for(int mu=0;mu<Nd;mu++){
+    auto UdSdUmu = PeekIndex<LorentzIndex>(UdSdU,mu);
+    mommu = PeekIndex<LorentzIndex>(mom,mu);
+    // U = exp(p dt) U, so dSdt = trace( dUdt dSdU) = trace( p UdSdUmu )
+    dS = dS - trace(mommu*UdSdUmu)*dt*2.0;
+  }
+  RealD dSpred = real(TensorRemove(sum(dS)));
+
+  std::cout << std::setprecision(15);
+  std::cout << GridLogMessage << " S      " << S << std::endl;
+  std::cout << GridLogMessage << " Sprime " << Sprime << std::endl;
+  std::cout << GridLogMessage << " Sminus " << Sminus << std::endl;
+  std::cout << GridLogMessage << "dS      " << 0.5*(Sprime-Sminus) << std::endl;
+  std::cout << GridLogMessage << "pred dS " << dSpred << std::endl;
+  assert( fabs(0.5*(Sprime-Sminus)-dSpred) < 1.0e-4*fabs(dSpred) );
+}
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  Coordinate latt_size   = GridDefaultLatt();
+  Coordinate simd_layout = GridDefaultSimd(Nd,vComplex::Nsimd());
+  Coordinate mpi_layout  = GridDefaultMpi();
+
+  GridCartesian               Grid(latt_size,simd_layout,mpi_layout);
+
+  GridParallelRNG          pRNG(&Grid);
+  pRNG.SeedFixedIntegers(std::vector<int>({45,12,81,9}));
+
+  LatticeGaugeField U(&Grid);
+  SU3::HotConfiguration(pRNG,U);
+
+  std::cout << GridLogMessage << "Isotropic stout smearing" << std::endl;
+  Smear_Stout<PeriodicGimplR> Stout(0.1);
+  TestStout(Grid,pRNG,U,Stout);
+
+  std::cout << GridLogMessage << "Stout smearing orthogonal to t" << std::endl;
+  Smear_Stout<PeriodicGimplR> Stout3d(0.1,Tdir);
+  TestStout(Grid,pRNG,U,Stout3d);
+
+  std::cout<< GridLogMessage << "Done" <<std::endl;
+  Grid_finalize();
+}
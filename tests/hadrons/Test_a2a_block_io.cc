@@ -0,0 +1,187 @@
+/*************************************************************************************
+
+Grid physics library, www.github.com/paboyle/Grid
+
+Source file: Tests/Hadrons/Test_a2a_block_io.cc
+
+Copyright (C) 2015-2019
+
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+See the full license in the file "LICENSE" in the top level distribution directory
+*************************************************************************************/
+/*  END LEGAL */
+#include <Hadrons/A2AMatrix.hpp>
+
+using namespace Grid;
+using namespace Grid::Hadrons;
+
+class TestMetadata: Serializable {
+public:
+  GRID_SERIALIZABLE_CLASS_MEMBERS(TestMetadata,
+                                  unsigned int, ext);
+};
+
+// A2AMatrixIo::load expects a container templated on the matrix element type
+template <typename T>
+class A2AMatrixVec: public std::vector<A2AMatrix<T>>
+{
+public:
+    using std::vector<A2AMatrix<T>>::vector;
+};
+
+// sum_{x in slice t} conj(l(x)) r(x) for every t
+std::vector<ComplexD> sliceProduct(const LatticeComplexD &l, const LatticeComplexD &r,
+                                   const unsigned int orthogDim)
+{
+    LatticeComplexD       lr = conjugate(l)*r;
+    std::vector<TComplexD> slice;
+    std::vector<ComplexD>  res;
+
+    sliceSum(lr, slice, orthogDim);
+    for (auto &z: slice)
+    {
+        res.push_back(TensorRemove(z));
+    }
+
+    return res;
+}
+
+// m(e, 0, t, i, j) = (e + 1) sum_{x in slice t} conj(left_i(x)) right_j(x)
+class TestKernel: public A2AKernel<ComplexD, LatticeComplexD>
+{
+public:
+    virtual void operator()(A2AMatrixSet<ComplexD> &m, const LatticeComplexD *left,
+                            const LatticeComplexD *right,
+                            const unsigned int orthogDim, double &time)
+    {
+        time = -usecond();
+        for (unsigned int i = 0; i < m.dimension(3); ++i)
+        for (unsigned int j = 0; j < m.dimension(4); ++j)
+        {
+            std::vector<ComplexD> slice = sliceProduct(left[i], right[j], orthogDim);
+
+            for (unsigned int e = 0; e < m.dimension(0); ++e)
+            for (unsigned int t = 0; t < m.dimension(2); ++t)
+            {
+                m(e, 0, t, i, j) = static_cast<double>(e + 1)*slice[t];
+            }
+        }
+        time += usecond();
+    }
+
+    virtual double flops(const unsigned int blockSizei, const unsigned int blockSizej)
+    {
+        return 0.;
+    }
+
+    virtual double bytes(const unsigned int blockSizei, const unsigned int blockSizej)
+    {
+        return 0.;
+    }
+};
+
+typedef A2AMatrixBlockComputation<ComplexD, LatticeComplexD, TestMetadata, ComplexF> Computation;
+
+int main(int argc, char *argv[])
+{
+    Grid_init(&argc, &argv);
+
+#ifdef HAVE_HDF5
+    const unsigned int next = 3, ni = 7, nj = 5, block = 4, cacheBlock = 2;
+    GridCartesian      *grid = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(),
+                                                              GridDefaultSimd(Nd, vComplexD::Nsimd()),
+                                                              GridDefaultMpi());
+    const unsigned int orthogDim = Nd - 1, nt = grid->GlobalDimensions()[orthogDim];
+    GridParallelRNG    rng(grid);
+    std::vector<LatticeComplexD> left(ni, grid), right(nj, grid);
+    TestKernel         kernel;
+
+    rng.SeedFixedIntegers({1, 2, 3, 4});
+    for (auto &f: left)  gaussian(rng, f);
+    for (auto &f: right) gaussian(rng, f);
+
+    auto ionameFn = [](const unsigned int e, const unsigned int s)
+    {
+        return "ext_" + std::to_string(e);
+    };
+    auto metadataFn = [](const unsigned int e, const unsigned int s)
+    {
+        TestMetadata md;
+
+        md.ext = e;
+
+        return md;
+    };
+
+    // write through the chosen I/O path, then read back with A2AMatrixIo
+    auto write = [&](const std::string dir, const bool pipelined, const bool collective)
+    {
+        Computation computation(grid, orthogDim, next, 1, block, cacheBlock);
+        auto        filenameFn = [dir, &ionameFn](const unsigned int e, const unsigned int s)
+        {
+            return dir + "/" + ionameFn(e, s) + ".h5";
+        };
+
+        std::cout << GridLogMessage << "Writing '" << dir << "'" << std::endl;
+        computation.setPipelinedIo(pipelined);
+        computation.setCollectiveIo(collective);
+        computation.execute(left, right, kernel, ionameFn, filenameFn, metadataFn);
+    };
+    auto check = [&](const std::string dir)
+    {
+        for (unsigned int e = 0; e < next; ++e)
+        {
+            A2AMatrixIo<ComplexF>  io(dir + "/" + ionameFn(e, 0) + ".h5", ionameFn(e, 0), nt);
+            A2AMatrixVec<ComplexF> m(nt);
+            double                 tRead;
+
+            io.load(m, &tRead, grid);
+            assert((io.getNi() == ni) and (io.getNj() == nj));
+            for (unsigned int i = 0; i < ni; ++i)
+            for (unsigned int j = 0; j < nj; ++j)
+            {
+                std::vector<ComplexD> slice = sliceProduct(left[i], right[j], orthogDim);
+
+                for (unsigned int t = 0; t < nt; ++t)
+                {
+                    ComplexF ref(static_cast<double>(e + 1)*slice[t]);
+
+                    assert(m[t](i, j) == ref);
+                }
+            }
+        }
+        std::cout << GridLogMessage << "'" << dir << "' matches the kernel" << std::endl;
+    };
+
+    write("a2a_block_io_serial", false, false);
+    check("a2a_block_io_serial");
+    write("a2a_block_io_pipelined", true, false);
+    check("a2a_block_io_pipelined");
+#ifdef HADRONS_A2AM_COLLECTIVE_IO
+    write("a2a_block_io_collective", false, true);
+    check("a2a_block_io_collective");
+    write("a2a_block_io_both", true, true);
+    check("a2a_block_io_both");
+#else
+    std::cout << GridLogMessage << "no collective HDF5 I/O in this build, skipped" << std::endl;
+#endif
+#endif
+
+    Grid_finalize();
+
+    return EXIT_SUCCESS;
+}
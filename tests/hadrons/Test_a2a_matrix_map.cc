@@ -0,0 +1,125 @@
+/*************************************************************************************
+
+Grid physics library, www.github.com/paboyle/Grid 
+
+Source file: Tests/Hadrons/Test_a2a_matrix_map.cc
+
+Copyright (C) 2015-2019
+
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+See the full license in the file "LICENSE" in the top level distribution directory
+*************************************************************************************/
+/*  END LEGAL */
+#include <Hadrons/A2AMatrix.hpp>
+
+using namespace Grid;
+using namespace Grid::Hadrons;
+
+class TestMetadata: Serializable {
+public:
+  GRID_SERIALIZABLE_CLASS_MEMBERS(TestMetadata,
+                                  std::string, name);
+};
+
+// A2AMatrixIo::load expects a container templated on the matrix element type
+template <typename T>
+class A2AMatrixVec: public std::vector<A2AMatrix<T>>
+{
+public:
+    using std::vector<A2AMatrix<T>>::vector;
+};
+
+int main(int argc, char *argv[])
+{
+    Grid_init(&argc, &argv);
+
+    const unsigned int nt = 8, ni = 13, nj = 7;
+    GridSerialRNG      rng;
+    TestMetadata       md;
+    std::vector<ComplexF>  data(nt*ni*nj);
+    A2AMatrixVec<ComplexF> ref(nt), h5(nt), mapped(nt);
+    A2AMatrixVec<ComplexD> mappedD(nt);
+    double                 t;
+
+    rng.SeedFixedIntegers({1, 2, 3, 4});
+    for (auto &x: data)
+    {
+        ComplexD z;
+
+        random(rng, z);
+        x = z;
+    }
+    for (unsigned int s = 0; s < nt; ++s)
+    {
+        ref[s] = Eigen::Map<A2AMatrix<ComplexF>>(data.data() + s*ni*nj, ni, nj);
+    }
+
+#ifdef HAVE_HDF5
+    // HDF5 file as written by A2AMatrixBlockComputation
+    md.name = "test";
+    A2AMatrixIo<ComplexF> io("a2a_map_test.h5", "meson", nt, ni, nj);
+
+    io.initFile(md, 4);
+    io.saveBlock(data.data(), 0, 0, ni, nj);
+    io.load(h5, &t);
+
+    // conversion to single and double precision mapped files
+    A2AMatrixMap<ComplexF>::convert<ComplexF>("a2a_map_test_f.bin", "a2a_map_test.h5", "meson", nt);
+    A2AMatrixMap<ComplexD>::convert<ComplexF>("a2a_map_test_d.bin", "a2a_map_test.h5", "meson", nt);
+    assert(A2AMatrixMap<ComplexF>::isMapFile("a2a_map_test_f.bin"));
+    assert(!A2AMatrixMap<ComplexF>::isMapFile("a2a_map_test.h5"));
+
+    // A2AMatrixIo reads mapped files transparently
+    A2AMatrixIo<ComplexF> mio("a2a_map_test_f.bin", "meson", nt);
+    A2AMatrixIo<ComplexF> dio("a2a_map_test_d.bin", "meson", nt);
+
+    mio.load(mapped, &t);
+    dio.load(mappedD, &t);
+    assert((mio.getNi() == ni) and (mio.getNj() == nj));
+
+    const A2AMatrixMap<ComplexF> map("a2a_map_test_f.bin");
+
+    for (unsigned int s = 0; s < nt; ++s)
+    {
+        map.prefetch(s);
+        assert(h5[s] == ref[s]);
+        assert(mapped[s] == ref[s]);
+        assert(mappedD[s].cast<ComplexF>() == ref[s]);
+        assert(A2AMatrix<ComplexF>(map[s]) == ref[s]);
+    }
+    std::cout << GridLogMessage << "mapped A2A matrices match HDF5 data" << std::endl;
+
+    // products read straight from a mapped slice, as in the Contractor
+    const A2AMatrixMap<ComplexD> mapD("a2a_map_test_d.bin");
+    A2AMatrix<ComplexD>          a = mappedD[0]*mappedD[0].adjoint(), viewProd, copyProd;
+
+    for (unsigned int s = 0; s < nt; ++s)
+    {
+        Eigen::Ref<const A2AMatrix<ComplexD>> view = mapD[s];
+
+        assert(view.data() == mapD[s].data());
+        A2AContraction::mul(viewProd, a, view);
+        A2AContraction::mul(copyProd, a, mappedD[s]);
+        assert(viewProd == copyProd);
+    }
+    std::cout << GridLogMessage << "products of mapped views match" << std::endl;
+#endif
+
+    Grid_finalize();
+
+    return EXIT_SUCCESS;
+}
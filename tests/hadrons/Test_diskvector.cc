@@ -107,6 +107,68 @@ int main(int argc, char *argv[])
                  << ((m == n) ? "yes" : "no" ) << std::endl;
     LOG(Message) << "hit ratio " << w.hitRatio() << std::endl;
 
+    // write-behind eviction and prefetched sequential reads
+    EigenDiskVector<ComplexD>                      u("eigendiskvector_async_test", 16, 4);
+    std::vector<EigenDiskVectorMat<ComplexD>>      ref(16);
+    bool                                           correct = true;
+
+    for (unsigned int i = 0; i < 16; ++i)
+    {
+        ref[i] = EigenDiskVectorMat<ComplexD>::Random(200, 200);
+        u[i]   = ref[i];
+    }
+    u.flush();
+    u.resetStat();
+    for (unsigned int pass = 0; pass < 2; ++pass)
+    for (unsigned int i = 0; i < 16; ++i)
+    {
+        u.prefetch({(i + 1) % 16, (i + 2) % 16, (i + 3) % 16});
+        n       = u[i];
+        correct = correct and (n == ref[i]);
+        u[i]    = ref[i] + ref[(i + 1) % 16];
+        ref[i]  = ref[i] + ref[(i + 1) % 16];
+    }
+    for (unsigned int i = 0; i < 16; ++i)
+    {
+        n       = u[i];
+        correct = correct and (n == ref[i]);
+    }
+    LOG(Message) << "prefetch/write-behind correct? " 
+                 << (correct ? "yes" : "no" ) << std::endl;
+    u.printStat();
+    assert(correct);
+    assert(u.getStat().prefetchHit > 0.);
+    // staged loads and pending saves never exceed the cache size
+    assert(u.getStat().peakStaged <= 4.);
+
+    // move with a prefetch and write-behind saves still queued
+    u[0] = ref[0] = ref[0] + ref[1];
+    u[5] = ref[5] = ref[5] + ref[6];
+    u.prefetch({9, 10});
+    {
+        EigenDiskVector<ComplexD> moved(std::move(u));
+
+        for (unsigned int i = 0; i < 16; ++i)
+        {
+            n       = moved[i];
+            correct = correct and (n == ref[i]);
+        }
+    }
+    LOG(Message) << "moved vector correct? " 
+                 << (correct ? "yes" : "no" ) << std::endl;
+    assert(correct);
+
+    // leave scope with write-behind saves and a prefetch still queued
+    {
+        EigenDiskVector<ComplexD> v("eigendiskvector_scope_test", 8, 2);
+
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+            v[i] = EigenDiskVectorMat<ComplexD>::Random(500, 500);
+        }
+        v.prefetch(0);
+    }
+
     Grid_finalize();
     
     return EXIT_SUCCESS;
@@ -97,6 +97,8 @@ void test_LapEvec(Application &application)
   p.Lanczos.MaxIt = 1000;
   p.Lanczos.resid = 1e-2;
   p.Lanczos.IRLLog = 0;
+  p.compression = "none";
+  p.tolerance = 0.;
   application.createModule<MDistil::LapEvec>(szModuleName,p);
 }
 
@@ -198,6 +200,8 @@ void test_Perambulators( Application &application, const char * pszSuffix = null
   PerambPar.solver = test_Solver( application, pszSuffix );
   PerambPar.DistilParams = "DPar_l";
   PerambPar.noise = "noise";
+  PerambPar.compression = "none";
+  PerambPar.tolerance = 0.;
   test_Noises(application, sModuleName); // I want these written after solver stuff
   application.createModule<MDistil::Perambulator>( sModuleName, PerambPar );
 }
@@ -240,6 +244,8 @@ void test_MesonSink(Application &application)
   A2AMesonFieldPar.mom={"0 0 0"};
   A2AMesonFieldPar.cacheBlock=2;
   A2AMesonFieldPar.block=4;
+  A2AMesonFieldPar.pipelinedIo=false;
+  A2AMesonFieldPar.collectiveIo=false;
   application.createModule<MContraction::A2AMesonField>("DistilMesonSink",A2AMesonFieldPar);
 }
 /////////////////////////////////////////////////////////////
@@ -265,6 +271,8 @@ void test_MesonField(Application &application, const char * pszFileSuffix,
   A2AMesonFieldPar.mom={"0 0 0"};
   A2AMesonFieldPar.cacheBlock=2;
   A2AMesonFieldPar.block=4;
+  A2AMesonFieldPar.pipelinedIo=false;
+  A2AMesonFieldPar.collectiveIo=false;
   std::string sObjectName{"DistilMesonField"};
   sObjectName.append( pszFileSuffix );
   application.createModule<MContraction::A2AMesonField>(sObjectName, A2AMesonFieldPar);
@@ -0,0 +1,123 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid 
+
+    Source file: ./tests/Test_wilson_cg_sstep.cc
+
+    Copyright (C) 2015
+
+Author: Azusa Yamaguchi <ayamaguc@staffmail.ed.ac.uk>
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  Coordinate latt_size   = GridDefaultLatt();
+  Coordinate simd_layout = GridDefaultSimd(Nd,vComplex::Nsimd());
+  Coordinate mpi_layout  = GridDefaultMpi();
+  GridCartesian               Grid(latt_size,simd_layout,mpi_layout);
+  GridRedBlackCartesian     RBGrid(&Grid);
+
+  std::vector<int> seeds({1,2,3,4});
+  GridParallelRNG          pRNG(&Grid);  pRNG.SeedFixedIntegers(seeds);
+
+  LatticeGaugeField Umu(&Grid); SU3::HotConfiguration(pRNG,Umu);
+
+  LatticeFermion    src(&Grid); random(pRNG,src);
+
+  RealD mass=0.5;
+  WilsonFermionR Dw(Umu,Grid,RBGrid,mass);
+
+  LatticeFermion result(&Grid); result=Zero();
+  ConjugateGradient<LatticeFermion> CG(1.0e-8,10000);
+  SchurRedBlackDiagMooeeSolve<LatticeFermion> SchurSolver(CG);
+  SchurSolver(Dw,src,result);
+
+  for(int s=1;s<=8;s*=2){
+    LatticeFermion result_s(&Grid); result_s=Zero();
+    ConjugateGradientSStep<LatticeFermion> SCG(1.0e-8,10000,s);
+    SchurRedBlackDiagMooeeSolve<LatticeFermion> SchurSStep(SCG);
+    SchurSStep(Dw,src,result_s);
+
+    LatticeFermion diff(&Grid);
+    diff = result - result_s;
+    RealD reldiff = std::sqrt(norm2(diff)/norm2(result));
+    std::cout << GridLogMessage << "s = " << s
+	      << " CG iterations " << CG.IterationsToComplete
+	      << " s-step CG iterations " << SCG.IterationsToComplete
+	      << " in " << SCG.ReductionsPerformed << " reductions" << std::endl;
+    std::cout << GridLogMessage << "Relative difference of solutions " << reldiff << std::endl;
+    assert(reldiff < 1.0e-6);
+  }
+
+  ////////////////////////////////////////////
+  // One instance reused on a lighter operator
+  // estimates the spectral bound afresh
+  ////////////////////////////////////////////
+  {
+    ConjugateGradientSStep<LatticeFermion> SCG(1.0e-8,10000,4);
+    SchurRedBlackDiagMooeeSolve<LatticeFermion> SchurSStep(SCG);
+    LatticeFermion result_s(&Grid); result_s=Zero();
+    SchurSStep(Dw,src,result_s);
+
+    WilsonFermionR Dl(Umu,Grid,RBGrid,0.1);
+    LatticeFermion result_l(&Grid); result_l=Zero();
+    LatticeFermion result_ls(&Grid); result_ls=Zero();
+    SchurSolver(Dl,src,result_l);
+    SchurSStep(Dl,src,result_ls);
+
+    LatticeFermion diff(&Grid);
+    diff = result_l - result_ls;
+    RealD reldiff = std::sqrt(norm2(diff)/norm2(result_l));
+    std::cout << GridLogMessage << "mass 0.1 after mass " << mass << ": relative difference " << reldiff << std::endl;
+    assert(SCG.Hi == 0.0);
+    assert(reldiff < 1.0e-6);
+  }
+
+  ////////////////////////////////////////////
+  // Single precision
+  ////////////////////////////////////////////
+  {
+    GridCartesian         *GridF   = SpaceTimeGrid::makeFourDimGrid(latt_size,GridDefaultSimd(Nd,vComplexF::Nsimd()),mpi_layout);
+    GridRedBlackCartesian *RBGridF = SpaceTimeGrid::makeFourDimRedBlackGrid(GridF);
+    LatticeGaugeFieldF UmuF(GridF); precisionChange(UmuF,Umu);
+    LatticeFermionF    srcF(GridF); precisionChange(srcF,src);
+    WilsonFermionF DwF(UmuF,*GridF,*RBGridF,mass);
+
+    LatticeFermionF result_f(GridF); result_f=Zero();
+    ConjugateGradientSStep<LatticeFermionF> SCGF(1.0e-5,10000,4);
+    SchurRedBlackDiagMooeeSolve<LatticeFermionF> SchurSStepF(SCGF);
+    SchurSStepF(DwF,srcF,result_f);
+
+    LatticeFermion result_d(&Grid); precisionChange(result_d,result_f);
+    LatticeFermion diff(&Grid);
+    diff = result - result_d;
+    RealD reldiff = std::sqrt(norm2(diff)/norm2(result));
+    std::cout << GridLogMessage << "single precision s-step CG relative difference " << reldiff << std::endl;
+    assert(reldiff < 1.0e-4);
+  }
+
+  Grid_finalize();
+}
@@ -0,0 +1,92 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid 
+
+    Source file: ./tests/Test_wilson_chrono_guess.cc
+
+    Copyright (C) 2015
+
+Author: Azusa Yamaguchi <ayamaguc@staffmail.ed.ac.uk>
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+ ;
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  Coordinate latt_size   = GridDefaultLatt();
+  Coordinate simd_layout = GridDefaultSimd(Nd,vComplex::Nsimd());
+  Coordinate mpi_layout  = GridDefaultMpi();
+  GridCartesian               Grid(latt_size,simd_layout,mpi_layout);
+  GridRedBlackCartesian     RBGrid(&Grid);
+
+  std::vector<int> seeds({1,2,3,4});
+  GridParallelRNG          pRNG(&Grid);  pRNG.SeedFixedIntegers(seeds);
+
+  LatticeFermion src(&Grid); random(pRNG,src);
+  LatticeGaugeField Umu(&Grid); SU3::HotConfiguration(pRNG,Umu);
+  LatticeGaugeField Mom(&Grid);
+
+  RealD mass=0.1;
+  WilsonFermionR Dw(Umu,Grid,RBGrid,mass);
+
+  MdagMLinearOperator<WilsonFermionR,LatticeFermion> HermOp(Dw);
+  ConjugateGradient<LatticeFermion> CG(1.0e-8,10000);
+
+  ////////////////////////////////////////////////////////////
+  // Solves along a short MD path, as the force solves see them
+  ////////////////////////////////////////////////////////////
+  ChronoGuesser<LatticeFermion> Chrono(4);
+  LatticeFermion result(&Grid);
+  LatticeFermion result_chrono(&Grid);
+  LatticeFermion diff(&Grid);
+  int iters=0, iters_chrono=0;
+  PeriodicGimplR::generate_momenta(Mom,pRNG);
+  for(int step=0;step<8;step++){
+    PeriodicGimplR::update_field(Mom,Umu,0.01);
+    Dw.ImportGauge(Umu);
+
+    result=Zero();
+    CG(HermOp,src,result);
+    iters += CG.IterationsToComplete;
+
+    {
+      ChronoGuesser<LatticeFermion>::OperatorScope GuessOp(Chrono,HermOp);
+      Chrono(src,result_chrono);
+    }
+    CG(HermOp,src,result_chrono);
+    Chrono.Update(result_chrono);
+    iters_chrono += CG.IterationsToComplete;
+
+    diff = result - result_chrono;
+    RealD reldiff = std::sqrt(norm2(diff)/norm2(result));
+    std::cout << GridLogMessage << "Step " << step << " relative difference of solutions " << reldiff << std::endl;
+    assert(reldiff < 1.0e-6);
+  }
+  std::cout << GridLogMessage << "CG iterations from zero guess " << iters
+	    << " from chronological guess " << iters_chrono << std::endl;
+  assert(iters_chrono < iters);
+
+  Grid_finalize();
+}
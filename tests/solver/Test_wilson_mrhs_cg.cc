@@ -0,0 +1,104 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid 
+
+    Source file: ./tests/Test_wilson_mrhs_cg.cc
+
+    Copyright (C) 2015
+
+Author: Azusa Yamaguchi <ayamaguc@staffmail.ed.ac.uk>
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+int main (int argc, char ** argv)
+{
+  const int Nrhs=12;
+  typedef WilsonFermionMultiRHSR<Nrhs> MultiRHSAction;
+
+  Grid_init(&argc,&argv);
+
+  GridCartesian         * UGrid   = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplex::Nsimd()),GridDefaultMpi());
+  GridRedBlackCartesian * UrbGrid = SpaceTimeGrid::makeFourDimRedBlackGrid(UGrid);
+  GridCartesian         * FGrid   = SpaceTimeGrid::makeFiveDimGrid(Nrhs,UGrid);
+  GridRedBlackCartesian * FrbGrid = SpaceTimeGrid::makeFiveDimRedBlackGrid(Nrhs,UGrid);
+
+  std::vector<int> seeds({1,2,3,4});
+  GridParallelRNG pRNG(UGrid);  pRNG.SeedFixedIntegers(seeds);
+
+  LatticeGaugeField Umu(UGrid); SU3::HotConfiguration(pRNG,Umu);
+
+  std::vector<LatticeFermion> src(Nrhs,UGrid);
+  std::vector<LatticeFermion> result(Nrhs,UGrid);
+  std::vector<LatticeFermion> result_block(Nrhs,UGrid);
+  for(int s=0;s<Nrhs;s++) random(pRNG,src[s]);
+
+  RealD mass=0.5;
+  WilsonFermionR Dw(Umu,*UGrid,*UrbGrid,mass);
+  MultiRHSAction Dmrhs(Umu,*FGrid,*FrbGrid,*UGrid,*UrbGrid,mass);
+
+  LatticeFermion src5(FGrid);
+  LatticeFermion res5(FGrid);
+  LatticeFermion tmp(UGrid);
+  LatticeFermion diff(UGrid);
+
+  ///////////////////////////////////////////////////////////////
+  // Block operator agrees with Nrhs single applications
+  ///////////////////////////////////////////////////////////////
+  Dmrhs.ImportRHS(src,src5);
+  Dmrhs.M(src5,res5);
+  Dmrhs.ExportRHS(res5,result_block);
+  for(int s=0;s<Nrhs;s++){
+    Dw.M(src[s],tmp);
+    diff = tmp - result_block[s];
+    std::cout << GridLogMessage << "rhs "<<s<<" M block vs single " << norm2(diff) << std::endl;
+    assert(norm2(diff) < 1.0e-10*norm2(tmp));
+  }
+
+  ///////////////////////////////////////////////////////////////
+  // Block CG on the red-black Schur operator against CG per rhs
+  ///////////////////////////////////////////////////////////////
+  ConjugateGradient<LatticeFermion> CG(1.0e-8,10000);
+  SchurRedBlackDiagMooeeSolve<LatticeFermion> SchurSolver(CG);
+  for(int s=0;s<Nrhs;s++){
+    result[s]=Zero();
+    SchurSolver(Dw,src[s],result[s]);
+  }
+
+  BlockConjugateGradient<LatticeFermion> BCGrQ(BlockCGrQ,0,1.0e-8,10000);
+  SchurRedBlackDiagMooeeSolve<LatticeFermion> SchurBlockSolver(BCGrQ);
+  res5=Zero();
+  SchurBlockSolver(Dmrhs,src5,res5);
+  Dmrhs.ExportRHS(res5,result_block);
+
+  for(int s=0;s<Nrhs;s++){
+    diff = result[s] - result_block[s];
+    RealD reldiff = std::sqrt(norm2(diff)/norm2(result[s]));
+    std::cout << GridLogMessage << "rhs "<<s<<" relative difference of solutions " << reldiff << std::endl;
+    assert(reldiff < 1.0e-6);
+  }
+
+  std::cout << GridLogMessage << "######## Dhop calls summary" << std::endl;
+  Dmrhs.Report();
+
+  Grid_finalize();
+}